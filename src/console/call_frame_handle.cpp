@@ -47,24 +47,21 @@ auto CallFrameHandle::progress() const noexcept -> cmd::Progress {
 	assert(m_process);
 	assert(m_frameIndex < m_process->m_callStack.size());
 	auto& frame = m_process->m_callStack[m_frameIndex];
-	assert(frame.programCounter < frame.commandStates.size());
-	return frame.commandStates[frame.programCounter].progress;
+	return m_process->commandState(frame, frame.programCounter).progress;
 }
 
 auto CallFrameHandle::arguments() const noexcept -> cmd::CommandArguments& {
 	assert(m_process);
 	assert(m_frameIndex < m_process->m_callStack.size());
 	auto& frame = m_process->m_callStack[m_frameIndex];
-	assert(frame.programCounter < frame.commandStates.size());
-	return frame.commandStates[frame.programCounter].arguments;
+	return m_process->commandState(frame, frame.programCounter).arguments;
 }
 
 auto CallFrameHandle::data() const noexcept -> std::any& {
 	assert(m_process);
 	assert(m_frameIndex < m_process->m_callStack.size());
 	auto& frame = m_process->m_callStack[m_frameIndex];
-	assert(frame.programCounter < frame.commandStates.size());
-	return frame.commandStates[frame.programCounter].data;
+	return m_process->commandState(frame, frame.programCounter).data;
 }
 
 auto CallFrameHandle::getExportTarget() const noexcept -> std::shared_ptr<Environment> {
@@ -151,6 +148,13 @@ auto CallFrameHandle::call(std::size_t returnArgumentIndex, std::shared_ptr<Envi
 	return m_process->call(std::move(env), std::move(commands), this->index(), returnArgumentIndex, this->getExportTarget());
 }
 
+auto CallFrameHandle::call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const
+	-> std::optional<CallFrameHandle> {
+	assert(m_process);
+	assert(m_frameIndex < m_process->m_callStack.size());
+	return m_process->call(std::move(env), std::move(script), this->index(), returnArgumentIndex, this->getExportTarget());
+}
+
 auto CallFrameHandle::call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, const Environment::Function& function) const
 	-> std::optional<CallFrameHandle> {
 	assert(m_process);
@@ -215,6 +219,12 @@ auto CallFrameHandle::tailCall(std::shared_ptr<Environment> env, Script commands
 	return m_process->call(std::move(env), std::move(commands), this->retFrame(), this->retArg(), this->getExportTarget());
 }
 
+auto CallFrameHandle::tailCall(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const -> std::optional<CallFrameHandle> {
+	assert(m_process);
+	assert(m_frameIndex < m_process->m_callStack.size());
+	return m_process->call(std::move(env), std::move(script), this->retFrame(), this->retArg(), this->getExportTarget());
+}
+
 auto CallFrameHandle::tailCall(std::shared_ptr<Environment> env, const Environment::Function& function) const -> std::optional<CallFrameHandle> {
 	assert(m_process);
 	assert(m_frameIndex < m_process->m_callStack.size());
@@ -277,6 +287,13 @@ auto CallFrameHandle::callDiscard(std::shared_ptr<Environment> env, Script comma
 	return m_process->call(std::move(env), std::move(commands), Process::NO_FRAME, 0, this->getExportTarget());
 }
 
+auto CallFrameHandle::callDiscard(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const
+	-> std::optional<CallFrameHandle> {
+	assert(m_process);
+	assert(m_frameIndex < m_process->m_callStack.size());
+	return m_process->call(std::move(env), std::move(script), Process::NO_FRAME, 0, this->getExportTarget());
+}
+
 auto CallFrameHandle::callDiscard(std::shared_ptr<Environment> env, const Environment::Function& function) const -> std::optional<CallFrameHandle> {
 	assert(m_process);
 	assert(m_frameIndex < m_process->m_callStack.size());
@@ -3,6 +3,7 @@
 
 #include "../utilities/span.hpp" // util::Span
 #include "command.hpp"           // cmd::...
+#include "compiled_script.hpp"   // CompiledScript
 #include "environment.hpp"       // Environment
 #include "script.hpp"            // Script
 
@@ -59,6 +60,8 @@ public:
 	[[nodiscard]] auto call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, Script::Command command) const
 		-> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, Script commands) const -> std::optional<CallFrameHandle>;
+	[[nodiscard]] auto call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const
+		-> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, const Environment::Function& function) const
 		-> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::size_t returnArgumentIndex, std::shared_ptr<Environment> env, const Environment::Function& function,
@@ -74,6 +77,7 @@ public:
 	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, cmd::CommandView argv) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, Script::Command command) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, Script commands) const -> std::optional<CallFrameHandle>;
+	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, const Environment::Function& function) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto tailCall(std::shared_ptr<Environment> env, const Environment::Function& function, util::Span<const cmd::Value> args) const
 		-> std::optional<CallFrameHandle>;
@@ -87,6 +91,7 @@ public:
 	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, cmd::CommandView argv) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, Script::Command command) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, Script commands) const -> std::optional<CallFrameHandle>;
+	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, const Environment::Function& function) const -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto callDiscard(std::shared_ptr<Environment> env, const Environment::Function& function, util::Span<const cmd::Value> args) const
 		-> std::optional<CallFrameHandle>;
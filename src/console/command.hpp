@@ -2,12 +2,14 @@
 #define AF2_CONSOLE_COMMAND_HPP
 
 #include "../utilities/span.hpp"   // util::Span
-#include "../utilities/string.hpp" // util::toString
+#include "../utilities/string.hpp" // util::toString, util::stringTo
 
+#include <cmath>      // std::isfinite, std::trunc
 #include <cstddef>    // std::size_t
-#include <cstdint>    // std::uint8_t
+#include <cstdint>    // std::uint8_t, std::int64_t, std::uint64_t
 #include <fmt/core.h> // fmt::format
 #include <iterator> // std::begin, std::end, std::distance, std::reverse_iterator, std::make_reverse_iterator, std::random_access_iterator_tag
+#include <limits>   // std::numeric_limits
 #include <memory>   // std::addressof
 #include <optional>    // std::optional, std::nullopt
 #include <string>      // std::string
@@ -35,24 +37,145 @@ enum class Status : std::uint8_t {
 
 using Value = std::string;
 
+// A number kept in binary form next to (or instead of) its text, so that arithmetic can be chained without parsing and
+// formatting the intermediate values. The number is always exactly what reading its text back would give, so scripts
+// can't tell whether a value went through a scalar or through text.
+class Scalar final {
+public:
+	enum class Type : std::uint8_t {
+		NONE,
+		INTEGER,
+		FLOAT,
+		BOOLEAN,
+	};
+
+	enum class Conversion : std::uint8_t {
+		OK,      // The number reads as the requested type.
+		INVALID, // The text of the number would not parse as the requested type.
+		UNKNOWN, // The text has to be parsed to find out.
+	};
+
+	Scalar() noexcept = default;
+
+	explicit Scalar(bool value) noexcept
+		: m_type(Type::BOOLEAN)
+		, m_integer((value) ? 1 : 0) {}
+
+	explicit Scalar(std::int64_t value) noexcept
+		: m_type(Type::INTEGER)
+		, m_integer(value) {}
+
+	explicit Scalar(double value) noexcept
+		: m_type(Type::FLOAT)
+		, m_float(value) {}
+
+	[[nodiscard]] explicit operator bool() const noexcept {
+		return m_type != Type::NONE;
+	}
+
+	[[nodiscard]] auto getType() const noexcept -> Type {
+		return m_type;
+	}
+
+	// Read the number as T, giving the same result as parsing its text as T would.
+	template <typename T>
+	[[nodiscard]] auto convert(T& result) const noexcept -> Conversion {
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>);
+		switch (m_type) {
+			case Type::NONE: return Conversion::UNKNOWN;
+			case Type::INTEGER: [[fallthrough]];
+			case Type::BOOLEAN:
+				if constexpr (std::is_integral_v<T>) {
+					if constexpr (std::is_signed_v<T>) {
+						if (m_integer < static_cast<std::int64_t>(std::numeric_limits<T>::min()) ||
+						    m_integer > static_cast<std::int64_t>(std::numeric_limits<T>::max())) {
+							return Conversion::UNKNOWN;
+						}
+					} else {
+						if (m_integer < 0 || static_cast<std::uint64_t>(m_integer) > static_cast<std::uint64_t>(std::numeric_limits<T>::max())) {
+							return Conversion::UNKNOWN;
+						}
+					}
+					result = static_cast<T>(m_integer);
+				} else {
+					result = static_cast<T>(m_integer);
+				}
+				return Conversion::OK;
+			case Type::FLOAT:
+				if constexpr (std::is_integral_v<T>) {
+					if (std::isfinite(m_float) && std::trunc(m_float) == m_float) {
+						return Conversion::UNKNOWN; // Shortest form of a whole number has no decimal point.
+					}
+					return Conversion::INVALID;
+				} else if constexpr (std::is_same_v<T, double>) {
+					result = m_float;
+					return Conversion::OK;
+				} else {
+					if (static_cast<double>(static_cast<T>(m_float)) != m_float) {
+						return Conversion::UNKNOWN; // Narrowing the double may round differently than reading its shortest form would.
+					}
+					result = static_cast<T>(m_float);
+					return Conversion::OK;
+				}
+		}
+		return Conversion::UNKNOWN;
+	}
+
+	[[nodiscard]] auto format() const -> Value {
+		switch (m_type) {
+			case Type::NONE: break;
+			case Type::INTEGER: return util::toString(m_integer);
+			case Type::FLOAT: return util::toString(m_float);
+			case Type::BOOLEAN: return (m_integer != 0) ? Value{"1"} : Value{"0"};
+		}
+		return Value{};
+	}
+
+private:
+	Type m_type = Type::NONE;
+	union {
+		std::int64_t m_integer = 0;
+		double m_float;
+	};
+};
+
 struct Result final {
 	Status status;
-	Value value;
+	Value value;     // Text of the value. Left empty until text() is called if the value was produced as a scalar.
+	Scalar scalar{}; // Number that the value holds, if it is known.
 
 	Result(Status status, Value value)
 		: status(status)
 		, value(std::move(value)) {}
 
+	Result(Status status, Scalar scalar)
+		: status(status)
+		, scalar(scalar) {}
+
+	Result(Status status, Value value, Scalar scalar)
+		: status(status)
+		, value(std::move(value))
+		, scalar(scalar) {}
+
 	auto reset() noexcept -> void {
 		status = Status::NONE;
 		value.clear();
+		scalar = Scalar{};
+	}
+
+	// Get the text of the value, formatting the scalar if that hasn't been done yet.
+	auto text() -> Value& {
+		if (scalar && value.empty()) {
+			value = scalar.format();
+		}
+		return value;
 	}
 };
 using CommandArguments = std::vector<Result>;
 
 class CommandView final {
 private:
-	using Container = util::Span<const Result>;
+	using Container = util::Span<Result>;
 
 public:
 	using size_type = typename Container::size_type;
@@ -104,11 +227,11 @@ public:
 			return m_it >= other.m_it;
 		}
 
-		[[nodiscard]] constexpr auto operator*() const -> reference {
-			return m_it->value;
+		[[nodiscard]] auto operator*() const -> reference {
+			return m_it->text();
 		}
 
-		[[nodiscard]] constexpr auto operator->() const -> pointer {
+		[[nodiscard]] auto operator->() const -> pointer {
 			return std::addressof(**this);
 		}
 
@@ -140,8 +263,8 @@ public:
 			return *this;
 		}
 
-		[[nodiscard]] constexpr auto operator[](difference_type n) -> reference {
-			return m_it[n].value;
+		[[nodiscard]] auto operator[](difference_type n) -> reference {
+			return m_it[n].text();
 		}
 
 		[[nodiscard]] constexpr friend auto operator+(const iterator& lhs, difference_type rhs) -> iterator {
@@ -166,7 +289,7 @@ public:
 
 	using reverse_iterator = std::reverse_iterator<iterator>;
 
-	constexpr explicit CommandView(util::Span<const Result> arguments) noexcept
+	constexpr explicit CommandView(util::Span<Result> arguments) noexcept
 		: m_arguments(arguments) {}
 
 	[[nodiscard]] constexpr auto size() const noexcept -> size_type {
@@ -209,16 +332,21 @@ public:
 		return this->rend();
 	}
 
-	[[nodiscard]] constexpr auto front() const noexcept -> reference {
-		return m_arguments.front().value;
+	[[nodiscard]] auto front() const -> reference {
+		return m_arguments.front().text();
 	}
 
-	[[nodiscard]] constexpr auto back() const noexcept -> reference {
-		return m_arguments.back().value;
+	[[nodiscard]] auto back() const -> reference {
+		return m_arguments.back().text();
 	}
 
-	[[nodiscard]] constexpr auto operator[](size_type i) const noexcept -> reference {
-		return m_arguments[i].value;
+	[[nodiscard]] auto operator[](size_type i) const -> reference {
+		return m_arguments[i].text();
+	}
+
+	// Get the number that an argument holds, if it is known without parsing its text.
+	[[nodiscard]] constexpr auto scalar(size_type i) const noexcept -> const Scalar& {
+		return m_arguments[i].scalar;
 	}
 
 	[[nodiscard]] constexpr auto subCommand(std::size_t offset, std::size_t count) const -> CommandView {
@@ -257,13 +385,34 @@ template <typename... Args>
 	return {Status::NONE, Value{}};
 }
 
+namespace detail {
+
+template <typename T>
+[[nodiscard]] inline auto numberResult(Status status, T value) -> Result {
+	if constexpr (std::is_integral_v<T>) {
+		if constexpr (std::is_unsigned_v<T>) {
+			if (value > static_cast<std::make_unsigned_t<std::int64_t>>(std::numeric_limits<std::int64_t>::max())) {
+				return {status, util::toString(value)};
+			}
+		}
+		return {status, Scalar{static_cast<std::int64_t>(value)}};
+	} else {
+		if constexpr (!std::is_same_v<T, double>) {
+			return {status, util::toString(value)}; // The shortest form of a float is not that of the same number as a double.
+		}
+		return {status, Scalar{static_cast<double>(value)}};
+	}
+}
+
+} // namespace detail
+
 [[nodiscard]] inline auto done(bool value) -> Result {
-	return {Status::VALUE, (value) ? Value{"1"} : Value{"0"}};
+	return {Status::VALUE, Scalar{value}};
 }
 
 template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>>>
 [[nodiscard]] inline auto done(T value) -> Result {
-	return {Status::VALUE, util::toString(value)};
+	return detail::numberResult(Status::VALUE, value);
 }
 
 [[nodiscard]] inline auto notDone(Progress progress) -> Result {
@@ -311,12 +460,12 @@ template <typename... Args>
 }
 
 [[nodiscard]] inline auto returned(bool value) -> Result {
-	return {Status::RETURN_VALUE, (value) ? Value{"1"} : Value{"0"}};
+	return {Status::RETURN_VALUE, Scalar{value}};
 }
 
 template <typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>>>
 [[nodiscard]] inline auto returned(T value) -> Result {
-	return {Status::RETURN_VALUE, util::toString(value)};
+	return detail::numberResult(Status::RETURN_VALUE, value);
 }
 
 template <typename... Args>
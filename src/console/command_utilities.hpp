@@ -19,6 +19,7 @@
 #include <cassert>      // assert
 #include <cstddef>      // std::size_t
 #include <fmt/core.h>   // fmt::format
+#include <optional>     // std::optional, std::nullopt
 #include <string>       // std::string
 #include <string_view>  // std::string_view
 #include <system_error> // std::error_code
@@ -52,41 +53,36 @@ private:
 
 enum class NumberConstraint : std::uint8_t { NONE, NON_ZERO, POSITIVE, NEGATIVE, NON_NEGATIVE, NON_POSITIVE };
 
-template <typename T, NumberConstraint CONSTRAINT = NumberConstraint::NONE>
-[[nodiscard]] inline auto parseNumber(ParseError& parseError, std::string_view str, std::string_view name) -> T {
+template <typename T, NumberConstraint CONSTRAINT>
+[[nodiscard]] constexpr auto satisfiesConstraint(T val) noexcept -> bool {
 	static_assert(!(std::is_unsigned_v<T> && (CONSTRAINT == NumberConstraint::NEGATIVE || CONSTRAINT == NumberConstraint::NON_POSITIVE)),
 	              "These constraints do not make sense for an unsigned type.");
 	static_assert(!(std::is_unsigned_v<T> && (CONSTRAINT == NumberConstraint::NON_ZERO)),
 	              "Use POSITIVE instead of NON_ZERO for unsigned types.");
 
+	if constexpr (CONSTRAINT == NumberConstraint::NON_ZERO) {
+		return val != T{0};
+	} else if constexpr (CONSTRAINT == NumberConstraint::POSITIVE) {
+		return val > T{0};
+	} else if constexpr (CONSTRAINT == NumberConstraint::NEGATIVE) {
+		return val < T{0};
+	} else if constexpr (CONSTRAINT == NumberConstraint::NON_NEGATIVE) {
+		return val >= T{0};
+	} else if constexpr (CONSTRAINT == NumberConstraint::NON_POSITIVE) {
+		return val <= T{0};
+	} else {
+		return true;
+	}
+}
+
+template <typename T, NumberConstraint CONSTRAINT = NumberConstraint::NONE>
+[[nodiscard]] inline auto parseNumber(ParseError& parseError, std::string_view str, std::string_view name) -> T {
 	if (parseError) {
 		return T{};
 	}
 
-	if (const auto val = util::stringTo<T>(str)) {
-		if constexpr (CONSTRAINT == NumberConstraint::NON_ZERO) {
-			if (val != T{0}) {
-				return *val;
-			}
-		} else if constexpr (CONSTRAINT == NumberConstraint::POSITIVE) {
-			if (val > T{0}) {
-				return *val;
-			}
-		} else if constexpr (CONSTRAINT == NumberConstraint::NEGATIVE) {
-			if (val < T{0}) {
-				return *val;
-			}
-		} else if constexpr (CONSTRAINT == NumberConstraint::NON_NEGATIVE) {
-			if (val >= T{0}) {
-				return *val;
-			}
-		} else if constexpr (CONSTRAINT == NumberConstraint::NON_POSITIVE) {
-			if (val <= T{0}) {
-				return *val;
-			}
-		} else {
-			return *val;
-		}
+	if (const auto val = util::stringTo<T>(str); val && satisfiesConstraint<T, CONSTRAINT>(*val)) {
+		return *val;
 	}
 
 	static constexpr auto typeStr = []() -> std::string_view {
@@ -126,6 +122,36 @@ template <typename T, NumberConstraint CONSTRAINT = NumberConstraint::NONE>
 	return T{};
 }
 
+// Parse a command argument as a number, reading its scalar directly if it has one.
+template <typename T, NumberConstraint CONSTRAINT = NumberConstraint::NONE>
+[[nodiscard]] inline auto parseNumber(ParseError& parseError, CommandView argv, std::size_t i, std::string_view name) -> T {
+	if (parseError) {
+		return T{};
+	}
+
+	if (auto val = T{}; argv.scalar(i).convert(val) == Scalar::Conversion::OK && satisfiesConstraint<T, CONSTRAINT>(val)) {
+		return val;
+	}
+	return cmd::parseNumber<T, CONSTRAINT>(parseError, argv[i], name);
+}
+
+// Like parseNumber, but without building an error message, so that arguments that hold a different kind of number never
+// have to be formatted as text.
+template <typename T, NumberConstraint CONSTRAINT = NumberConstraint::NONE>
+[[nodiscard]] inline auto tryParseNumber(CommandView argv, std::size_t i) -> std::optional<T> {
+	auto val = T{};
+	switch (argv.scalar(i).convert(val)) {
+		case Scalar::Conversion::OK: return (satisfiesConstraint<T, CONSTRAINT>(val)) ? std::optional<T>{val} : std::nullopt;
+		case Scalar::Conversion::INVALID: return std::nullopt;
+		case Scalar::Conversion::UNKNOWN: break;
+	}
+
+	if (const auto parsed = util::stringTo<T>(argv[i]); parsed && satisfiesConstraint<T, CONSTRAINT>(*parsed)) {
+		return *parsed;
+	}
+	return std::nullopt;
+}
+
 [[nodiscard]] inline auto parseBool(ParseError& parseError, std::string_view str, std::string_view name) -> bool {
 	if (parseError) {
 		return false;
@@ -29,6 +29,7 @@ CONVAR_CALLBACK(updateGoalWeights) {
 // clang-format off
 ConVarFloatMinMax	bot_range_shotgun{					"bot_range_shotgun",				0.5f,	ConVar::SERVER_VARIABLE,	"Fraction of bot_range below which soldier bots use their shotgun.", 0.0f, 1.0f};
 ConVarIntMinMax		bot_range{							"bot_range",						18,		ConVar::SERVER_VARIABLE,	"The radius of the circle in which bots can see enemy players.", 0, -1};
+ConVarIntMinMax		bot_path_repair_limit{				"bot_path_repair_limit",			400,	ConVar::SERVER_VARIABLE,	"Maximum number of tiles bots search to get back onto their path after fighting before planning a new one. 0 = Always plan a new path.", 0, -1};
 ConVarFloatMinMax	bot_defend_time{					"bot_defend_time",					4.0f,	ConVar::SERVER_VARIABLE,	"How many seconds bots wait while defending.", 0.0f, -1.0f};
 ConVarFloatMinMax	bot_heal_time{						"bot_heal_time",					2.0f,	ConVar::SERVER_VARIABLE,	"How many seconds bots spend healing.", 0.0f, -1.0f};
 ConVarFloatMinMax	bot_heal_cooldown{					"bot_heal_cooldown",				2.0f,	ConVar::SERVER_VARIABLE,	"How many seconds bots wait before healing again.", 0.0f, -1.0f};
@@ -5,6 +5,7 @@
 
 extern ConVarFloatMinMax bot_range_shotgun;
 extern ConVarIntMinMax bot_range;
+extern ConVarIntMinMax bot_path_repair_limit;
 extern ConVarFloatMinMax bot_defend_time;
 extern ConVarFloatMinMax bot_heal_time;
 extern ConVarFloatMinMax bot_heal_cooldown;
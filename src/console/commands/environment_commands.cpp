@@ -6,6 +6,7 @@
 #include "../command.hpp"                // cmd::...
 #include "../command_options.hpp"        // cmd::...
 #include "../command_utilities.hpp"      // cmd::...
+#include "../compiled_script.hpp"        // CompiledScript
 #include "../environment.hpp"            // Environment
 #include "../process.hpp"                // CallFrameHandle
 #include "../script.hpp"                 // Script
@@ -17,6 +18,7 @@
 #include <cstddef>    // std::size_t
 #include <cstdint>    // std::int64_t
 #include <functional> // std::greater
+#include <memory>     // std::shared_ptr, std::make_shared
 #include <variant>    // std::get_if
 #include <vector>     // std::vector
 
@@ -64,8 +66,8 @@ CON_COMMAND(var, "<name> [value]", ConCommand::NO_FLAGS, "Create a local variabl
 		return cmd::error("{}: No environment!", self.getName());
 	}
 
-	if (const auto [it, inserted] = frame.env()->objects.try_emplace(argv[1], Environment::Variable{(argv.size() == 3) ? argv[2] : std::string{}});
-	    !inserted) {
+	auto var = (argv.size() == 3) ? Environment::Variable{argv[2], argv.scalar(2)} : Environment::Variable{};
+	if (const auto [it, inserted] = frame.env()->objects.try_emplace(argv[1], std::move(var)); !inserted) {
 		return util::match(it->second)(
 			[&](const Environment::Variable&) { return cmd::error("{}: A variable named {} already exists.", self.getName(), argv[1]); },
 			[&](const Environment::Constant&) { return cmd::error("{}: A constant named {} already exists.", self.getName(), argv[1]); },
@@ -182,7 +184,7 @@ CON_COMMAND(set, "<name> <value>", ConCommand::NO_FLAGS,
 		return cmd::error("{}: No environment!", self.getName());
 	}
 
-	auto var = Environment::Variable{argv[2]};
+	auto var = Environment::Variable{argv[2], argv.scalar(2)};
 	frame.env()->objects.insert_or_assign(argv[1], std::move(var));
 	return cmd::done();
 }
@@ -199,7 +201,7 @@ CON_COMMAND(function, "<name> [arguments...] <script>", ConCommand::NO_FLAGS,
 
 	auto function = Environment::Function{};
 	function.parameters.insert(function.parameters.end(), argv.begin() + 2, argv.end() - 1);
-	function.body = Script::parse(argv[argv.size() - 1]);
+	function.body = CompiledScript::compile(argv[argv.size() - 1]);
 
 	if (const auto [it, inserted] = frame.env()->objects.try_emplace(argv[1], std::move(function)); !inserted) {
 		return util::match(it->second)(
@@ -354,7 +356,7 @@ CON_COMMAND(sort, "<name>", ConCommand::NO_FLAGS, "Sort an array.",
 CON_COMMAND(foreach, "<parameter> <name> <script>", ConCommand::NO_FLAGS, "Execute script for each key/value in a table/array.", {}, nullptr) {
 	struct State final {
 		std::vector<std::string> values;
-		Script body;
+		std::shared_ptr<const CompiledScript> body;
 		std::size_t i = 0;
 	};
 
@@ -368,7 +370,7 @@ CON_COMMAND(foreach, "<parameter> <name> <script>", ConCommand::NO_FLAGS, "Execu
 				if (const auto* const arr = std::get_if<Environment::Array>(obj)) {
 					auto& state = data.emplace<State>();
 					state.values = *arr;
-					state.body = Script::parse(argv[3]);
+					state.body = CompiledScript::compile(argv[3]);
 					assert(frame.arguments().size() == 4);
 					frame.arguments().pop_back();
 					frame.arguments()[2].reset();
@@ -381,7 +383,7 @@ CON_COMMAND(foreach, "<parameter> <name> <script>", ConCommand::NO_FLAGS, "Execu
 					for (const auto& kv : *table) {
 						state.values.push_back(kv.first);
 					}
-					state.body = Script::parse(argv[3]);
+					state.body = CompiledScript::compile(argv[3]);
 					assert(frame.arguments().size() == 4);
 					frame.arguments().pop_back();
 					frame.arguments()[2].reset();
@@ -402,7 +404,7 @@ CON_COMMAND(foreach, "<parameter> <name> <script>", ConCommand::NO_FLAGS, "Execu
 			}
 
 			if (frame.arguments()[2].status == cmd::Status::RETURN_VALUE) {
-				return cmd::returned(std::move(frame.arguments()[2].value));
+				return std::move(frame.arguments()[2]);
 			}
 
 			auto& state = std::any_cast<State&>(data);
@@ -568,7 +570,7 @@ CON_COMMAND(toggle, "<name> [key]", ConCommand::NO_FLAGS, "Toggle the value of a
 		}
 
 		frame.arguments().push_back(cmd::done());
-		if (!frame.call(2, frame.env(), frame.arguments()[1].value)) {
+		if (!frame.call(2, frame.env(), frame.arguments()[1].text())) {
 			return cmd::error("{}: Stack overflow.", self.getName());
 		}
 		return cmd::notDone(1);
@@ -638,6 +640,7 @@ CON_COMMAND(clear, "<name>", ConCommand::NO_FLAGS, "Erase all content from an ex
 		return util::match(*obj)(
 			[&](Environment::Variable& var) {
 				var.value.clear();
+				var.scalar = cmd::Scalar{};
 				return cmd::done();
 			},
 			[&](Environment::Constant&) { return cmd::error("{}: Cannot change the value of a constant.", self.getName()); },
@@ -663,6 +666,7 @@ CON_COMMAND(assign, "<name> <value>", ConCommand::NO_FLAGS, "Re-initialize an ex
 		return util::match(*obj)(
 			[&](Environment::Variable& var) {
 				var.value = argv[2];
+				var.scalar = argv.scalar(2);
 				return cmd::done();
 			},
 			[&](Environment::Constant&) { return cmd::error("{}: Cannot change the value of a constant.", self.getName()); },
@@ -687,7 +691,8 @@ CON_COMMAND(append, "<name> <value>", ConCommand::NO_FLAGS, "Append to an existi
 	if (auto* const obj = frame.process()->findObject(frame.env(), argv[1])) {
 		return util::match(*obj)(
 			[&](Environment::Variable& var) {
-				var.value.append(argv[2]);
+				var.text().append(argv[2]);
+				var.scalar = cmd::Scalar{};
 				return cmd::done();
 			},
 			[&](Environment::Constant&) { return cmd::error("{}: Cannot change the value of a constant.", self.getName()); },
@@ -21,6 +21,7 @@ ConVarString data_subdir_shaders{		"data_subdir_shaders",		"shaders",		ConVar::I
 ConVarString data_subdir_screens{		"data_subdir_screens",		"screens",		ConVar::INIT | ConVar::ADMIN_ONLY | ConVar::NO_RCON,	"Screen file subdirectory."};
 ConVarString data_subdir_screenshots{	"data_subdir_screenshots",	"screenshots",	ConVar::INIT | ConVar::ADMIN_ONLY | ConVar::NO_RCON,	"Screenshot file subdirectory."};
 ConVarString data_subdir_downloads{		"data_subdir_downloads",	"downloads",	ConVar::INIT | ConVar::ADMIN_ONLY | ConVar::NO_RCON,	"Downloaded data subdirectory."};
+ConVarString data_subdir_cache{			"data_subdir_cache",		"cache",		ConVar::INIT | ConVar::ADMIN_ONLY | ConVar::NO_RCON,	"Downloaded resource cache subdirectory, where files are stored by content hash."};
 // clang-format on
 
 CON_COMMAND(file_read, "<filepath>", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON, "Get the entire contents of a file.", {},
@@ -15,6 +15,7 @@ extern ConVarString data_subdir_shaders;
 extern ConVarString data_subdir_screens;
 extern ConVarString data_subdir_screenshots;
 extern ConVarString data_subdir_downloads;
+extern ConVarString data_subdir_cache;
 
 CON_COMMAND_EXTERN(file_read);
 CON_COMMAND_EXTERN(file_append);
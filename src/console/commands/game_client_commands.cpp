@@ -76,6 +76,7 @@ ConVarIntMinMax		cl_throttle_max_period{					"cl_throttle_max_period",				6,
 ConVarBool			cl_allow_resource_download{				"cl_allow_resource_download",			true,				ConVar::CLIENT_SETTING,								"Whether or not to automatically download resources (like the map) when connecting to a server."};
 ConVarIntMinMax		cl_max_resource_download_size{			"cl_max_resource_download_size",		500000,				ConVar::CLIENT_SETTING,								"Maximum size (in bytes) that is allowed for a single resource when downloading from the server (0 = unlimited).", 0, -1};
 ConVarIntMinMax		cl_max_resource_total_download_size{	"cl_max_resource_total_download_size",	1000000000,			ConVar::CLIENT_SETTING,								"Maximum total sum of resource sizes (in bytes) to download from the server (0 = unlimited).", 0, -1};
+ConVarBool			cl_resource_prefetch{					"cl_resource_prefetch",					true,				ConVar::CLIENT_SETTING,								"Whether or not to download the resources of the server's next map in the background while playing."};
 ConVarString		address{								"address",								"",					ConVar::CLIENT_SETTING | ConVar::NOT_RUNNING_GAME,	"Remote address to connect to."};
 ConVarIntMinMax		port{									"port",									0,					ConVar::CLIENT_SETTING | ConVar::NOT_RUNNING_GAME,	"Remote port to connect to.", 0, 65535};
 ConVarIntMinMax		cl_port{								"cl_port",								0,					ConVar::CLIENT_SETTING | ConVar::NOT_RUNNING_GAME,	"Port used by the client. Set to 0 to choose automatically.", 0, 65535};
@@ -20,6 +20,7 @@ extern ConVarIntMinMax cl_throttle_max_period;
 extern ConVarBool cl_allow_resource_download;
 extern ConVarIntMinMax cl_max_resource_download_size;
 extern ConVarIntMinMax cl_max_resource_total_download_size;
+extern ConVarBool cl_resource_prefetch;
 extern ConVarString address;
 extern ConVarIntMinMax port;
 extern ConVarIntMinMax cl_port;
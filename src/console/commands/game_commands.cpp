@@ -15,6 +15,7 @@
 #include "../command.hpp"                    // cmd::...
 #include "../command_options.hpp"            // cmd::...
 #include "../command_utilities.hpp"          // cmd::...
+#include "../compiled_script.hpp"            // CompiledScript
 #include "../process.hpp"                    // Process
 #include "../script.hpp"                     // Script::escapedString
 #include "../suggestions.hpp"                // Suggestions
@@ -321,7 +322,7 @@ CON_COMMAND(open_textinput, "<script>", ConCommand::ADMIN_ONLY | ConCommand::NO_
 	if (argv.size() != 2) {
 		return cmd::error(self.getUsage());
 	}
-	game.setConsoleModeTextInput([&game, script = Script::parse(argv[1])](std::string_view text) {
+	game.setConsoleModeTextInput([&game, script = CompiledScript::compile(argv[1])](std::string_view text) {
 		auto func = Environment::Function{};
 		func.body = script;
 		func.parameters.emplace_back("text");
@@ -341,7 +342,7 @@ CON_COMMAND(open_password, "<script>", ConCommand::ADMIN_ONLY | ConCommand::NO_R
 	if (frame.progress() == 0) {
 		return cmd::deferToNextFrame(1);
 	}
-	game.setConsoleModePassword([&game, script = Script::parse(argv[1])](std::string_view password) {
+	game.setConsoleModePassword([&game, script = CompiledScript::compile(argv[1])](std::string_view password) {
 		auto func = Environment::Function{};
 		func.body = script;
 		func.parameters.emplace_back("password");
@@ -5,15 +5,13 @@
 #include "../../game/server/game_server.hpp" // GameServer
 #include "../../network/config.hpp"          // net::MAX_USERNAME_LENGTH
 #include "../../network/endpoint.hpp"        // net::IpEndpoint
-#include "../../utilities/algorithm.hpp"     // util::collect, util::sort, util::transform
-#include "../../utilities/file.hpp"          // util::dumpFile
-#include "../../utilities/reference.hpp"     // util::Reference
+#include "../../utilities/algorithm.hpp"     // util::collect, util::transform
+#include "../../utilities/file.hpp"          // util::dumpFile, util::pathIsBelowDirectory
 #include "../../utilities/string.hpp"        // util::contains, util::join
 #include "../command.hpp"                    // cmd::...
 #include "../command_utilities.hpp"          // cmd::...
-#include "../script.hpp"                     // Script
 #include "../suggestions.hpp"                // Suggestions, SUGGESTIONS
-#include "file_commands.hpp"                 // data_dir, data_subdir_maps, data_subdir_cfg
+#include "file_commands.hpp"                 // data_dir, data_subdir_maps, data_subdir_logs
 #include "game_commands.hpp"                 // maplist
 
 #include <cassert>      // assert
@@ -75,6 +73,13 @@ CONVAR_CALLBACK(updateBotAiRequirePlayers) {
 	return cmd::done();
 }
 
+CONVAR_CALLBACK(updateBotThreads) {
+	if (server) {
+		server->updateBotThreads();
+	}
+	return cmd::done();
+}
+
 CONVAR_CALLBACK(updateMapName) {
 	if (!self.getRaw().empty() && !util::contains(self.getRaw(), '.')) {
 		self.setSilent(fmt::format("{}.txt", self.getRaw()));
@@ -121,7 +126,11 @@ ConVarIntMinMax		sv_tickrate{					"sv_tickrate",						60,												ConVar::SER
 ConVarIntMinMax		sv_bot_tickrate{				"sv_bot_tickrate",					10,												ConVar::SERVER_SETTING,								"The rate (in Hz) at which bots think. Should be a divisor of sv_tickrate for best results.", 1, 1000, updateBotTickrate};
 ConVarBool			sv_bot_ai_enable{				"sv_bot_ai_enable",					true,											ConVar::SERVER_VARIABLE,							"Whether or not to tick bots.", updateBotAiEnable};
 ConVarBool			sv_bot_ai_require_players{		"sv_bot_ai_require_players",		true,											ConVar::SERVER_SETTING,								"Whether or not there needs to be players connected to the server in order for bots to update.", updateBotAiRequirePlayers};
+ConVarIntMinMax		sv_bot_threads{					"sv_bot_threads",					0,												ConVar::SERVER_SETTING,								"Number of extra worker threads to use for bot thinking. 0 = Think on the main server thread only.", 0, 64, updateBotThreads};
+ConVarIntMinMax		sv_bot_ai_max_thinks{			"sv_bot_ai_max_thinks",				16,												ConVar::SERVER_SETTING,								"Maximum number of bots that think per server tick. Bots that don't fit are deferred to the next tick, most overdue first. 0 = unlimited.", 0, -1};
+ConVarIntMinMax		sv_bot_ai_max_paths{			"sv_bot_ai_max_paths",				4,												ConVar::SERVER_SETTING,								"Maximum number of bot paths to find per server tick. Paths that don't fit are deferred to the next tick. 0 = unlimited.", 0, -1};
 ConVarIntMinMax		sv_max_ticks_per_frame{			"sv_max_ticks_per_frame",			10,												ConVar::SERVER_SETTING,								"How many ticks that are allowed to run on one server frame.", 1, -1};
+ConVarBool			sv_sleep_until_tick{			"sv_sleep_until_tick",				true,											ConVar::HOST_SETTING,								"Whether or not a headless server should sleep until its next tick or an incoming packet instead of running at fps_max."};
 ConVarIntMinMax		sv_playerlimit{					"sv_playerlimit",					24,												ConVar::SERVER_SETTING,								"How many clients are allowed to connect to the server.", 1, 65535};
 ConVarIntMinMax		sv_max_username_length{			"sv_max_username_length",			static_cast<int>(net::MAX_USERNAME_LENGTH),		ConVar::SERVER_SETTING,								"Maximum username length for connecting clients.", 1, static_cast<int>(net::MAX_USERNAME_LENGTH)};
 ConVarFloatMinMax	sv_disconnect_cooldown{			"sv_disconnect_cooldown",			DISCONNECT_DURATION_SECONDS,					ConVar::SERVER_SETTING,								"How many seconds to wait before letting a client connect again after disconnecting.", 0.0f, -1.0f};
@@ -132,6 +141,7 @@ ConVarString		sv_hostname{					"sv_hostname",						"",												ConVar::SERVER
 ConVarBool			sv_allow_resource_download{		"sv_allow_resource_download",		true,											ConVar::SERVER_SETTING,								"Whether or not to let clients download resources from your server.", updateAllowResourceDownload};
 ConVarFloatMinMax	sv_resource_upload_rate{		"sv_resource_upload_rate",			10000.0f,										ConVar::SERVER_SETTING,								"Rate (in bytes per second) at which resources are uploaded to clients.", 1.0f, -1.0f, updateResourceUploadInterval};
 ConVarIntMinMax		sv_resource_upload_chunk_size{	"sv_resource_upload_chunk_size",	1000,											ConVar::SERVER_SETTING,								"How big (in bytes) chunks to split resources up into when uploading to clients.", 1, -1, updateResourceUploadInterval};
+ConVarBool			sv_resource_prefetch{			"sv_resource_prefetch",				true,											ConVar::SERVER_SETTING,								"Whether or not to offer the resources of the next map to clients while the current map is being played."};
 ConVarHashed		sv_password{					"sv_password",						"",												ConVar::SERVER_PASSWORD,							"Server password for connecting clients."};
 ConVarBool			sv_rtv_enable{					"sv_rtv_enable",					true,											ConVar::SERVER_SETTING,								"Whether or not vote-based map switching is enabled."};
 ConVarFloatMinMax	sv_rtv_delay{					"sv_rtv_delay",						20.0f,											ConVar::SERVER_SETTING,								"How many seconds to wait after switching maps before allowing players to rock the vote again.", 0.0f, -1.0f};
@@ -142,11 +152,13 @@ ConVarIntMinMax		sv_bot_count{					"sv_bot_count",						10,												ConVar::S
 ConVarIntMinMax		sv_port{						"sv_port",							25605,											ConVar::SERVER_SETTING | ConVar::NOT_RUNNING_GAME,	"Local port to use when starting a server.", 0, 65535};
 ConVarString		sv_config_file{					"sv_config_file",					"sv_config.cfg",								ConVar::HOST_SETTING,								"Main server config file to read at startup and save to at shutdown."};
 ConVarString		sv_autoexec_file{				"sv_autoexec_file",					"sv_autoexec.cfg",								ConVar::HOST_SETTING,								"Server autoexec file to read at startup."};
+ConVarString		sv_inventory_file{				"sv_inventory_file",				"sv_inventories.db",							ConVar::HOST_SETTING,								"Binary inventory database to load at startup and save to along with the server config. Leave empty to store inventories in the server config instead."};
 ConVarString		sv_map_rotation{				"sv_map_rotation",					"",												ConVar::SERVER_SETTING,								"Server map rotation for rock the vote. Map names are separated in the same way as commands."};
 ConVarString		sv_motd{						"sv_motd",							"",												ConVar::SERVER_SETTING,								"Server message of the day. Shown to clients when they have successfully connected."};
 ConVarIntMinMax		sv_max_clients{					"sv_max_clients",					65536,											ConVar::SERVER_SETTING,								"Maximum number of connections to handle simultaneously. When the limit is hit, any remaining packets received from unconnected addresses will be ignored.", 0, -1};
 ConVarIntMinMax		sv_max_connecting_clients{		"sv_max_connecting_clients",		10,												ConVar::SERVER_SETTING,								"Maximum number of new connections to handle simultaneously. When the limit is hit, any remaining packets received from unconnected addresses will be ignored.", 0, -1};
 ConVarIntMinMax		sv_config_auto_save_interval{	"sv_config_auto_save_interval",		5,												ConVar::SERVER_SETTING,								"Minutes between automatic server config saves. 0 = Disable autosave.", 0, -1, updateConfigAutoSaveInterval};
+ConVarFloatMinMax	sv_perf_log_interval{			"sv_perf_log_interval",				0.0f,											ConVar::SERVER_SETTING,								"Seconds between server performance log lines. 0 = Disable.", 0.0f, -1.0f};
 ConVarIntMinMax		sv_score_level_interval{		"sv_score_level_interval",			20,												ConVar::SERVER_SETTING,								"Number of points required to level up.", 1, -1};
 ConVarFloatMinMax	sv_afk_autokick_time{			"sv_afk_autokick_time",				60.0f,											ConVar::SERVER_SETTING,								"Automatically kick players if they haven't done anything for this many seconds (0 = unlimited).", 0.0f, -1.0f};
 ConVarIntMinMax		sv_max_connections_per_ip{		"sv_max_connections_per_ip",		10,												ConVar::SERVER_SETTING,								"Maximum number of connections to accept from the same IP address (0 = unlimited).", 0, -1};
@@ -260,6 +272,34 @@ CON_COMMAND(bot_kick, "<name/all>", ConCommand::SERVER, "Kick one or all bots fr
 	return cmd::done();
 }
 
+CON_COMMAND(bot_test_determinism, "[tick count]", ConCommand::SERVER | ConCommand::ADMIN_ONLY,
+            "Check that running the same ticks again, with bots thinking on worker threads, gives the same world.", {}, nullptr) {
+	if (argv.size() > 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+	const auto tickCount = (argv.size() == 2) ? cmd::parseNumber<int, cmd::NumberConstraint::POSITIVE>(parseError, argv[1], "tick count") : 100;
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	assert(server);
+	if (const auto mismatch = server->testBotDeterminism(tickCount)) {
+		return cmd::error("{}: The world differed between the two runs at tick {}.", self.getName(), *mismatch);
+	}
+	return cmd::done();
+}
+
+CON_COMMAND(sv_bot_ai_status, "", ConCommand::SERVER | ConCommand::ADMIN_ONLY, "Show bot AI scheduler statistics.", {}, nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
+
+	assert(server);
+	return cmd::done(server->getBotAiStatusString());
+}
+
 CON_COMMAND(sv_has_players, "", ConCommand::SERVER, "Check if the server has any non-bot players.", {}, nullptr) {
 	if (argv.size() != 1) {
 		return cmd::error(self.getUsage());
@@ -390,38 +430,46 @@ CON_COMMAND(sv_ban_list, "", ConCommand::SERVER | ConCommand::ADMIN_ONLY, "List
 }
 
 CON_COMMAND(sv_writeconfig, "", ConCommand::SERVER | ConCommand::ADMIN_ONLY | ConCommand::NO_RCON, "Save the current server config.", {}, nullptr) {
-	using BannedPlayerRef = util::Reference<const GameServer::BannedPlayers::value_type>;
-	using Refs = std::vector<BannedPlayerRef>;
+	assert(server);
+	if (const auto result = server->writeConfig(); !result.error.empty()) {
+		return cmd::error("{}: {}", self.getName(), result.error);
+	}
+	return cmd::done();
+}
 
-	static constexpr auto compareBannedPlayerRefs = [](const auto& lhs, const auto& rhs) {
-		return lhs->second.username < rhs->second.username;
-	};
+CON_COMMAND(sv_config_save_status, "", ConCommand::SERVER | ConCommand::ADMIN_ONLY, "Show config save statistics.", {}, nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
 
-	static constexpr auto getBannedPlayerCommand = [](const auto& kv) {
-		const auto& [ip, bannedPlayer] = *kv;
-		return fmt::format("{} {} {}",
-		                   GET_COMMAND(sv_ban).getName(),
-		                   Script::escapedString(std::string{ip}),
-		                   Script::escapedString(bannedPlayer.username));
-	};
+	assert(server);
+	return cmd::done(server->getConfigSaveStatusString());
+}
+
+CON_COMMAND(sv_perf, "", ConCommand::SERVER | ConCommand::ADMIN_ONLY, "Show how long the recent server tick frames took, per phase.", {}, nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
+
+	assert(server);
+	return cmd::done(server->getPerf().getStatusString());
+}
+
+CON_COMMAND(sv_perf_export, "<filename>", ConCommand::SERVER | ConCommand::ADMIN_ONLY | ConCommand::NO_RCON,
+            "Write the recent server tick frame timings and counts to a CSV file in the logs directory.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto logsDirectory = fmt::format("{}/{}", data_dir, data_subdir_logs);
+	const auto filepath = fmt::format("{}/{}", logsDirectory, argv[1]);
+	if (!util::pathIsBelowDirectory(filepath, logsDirectory)) {
+		return cmd::error("{}: Invalid filename \"{}\".", self.getName(), argv[1]);
+	}
 
 	assert(server);
-	if (!util::dumpFile(fmt::format("{}/{}/{}", data_dir, data_subdir_cfg, sv_config_file),
-	                    fmt::format("{}\n"
-	                                "\n"
-	                                "// Inventories:\n"
-	                                "{}\n"
-	                                "// Remote console:\n"
-	                                "{}\n"
-	                                "\n"
-	                                "// Banned IPs:\n"
-	                                "{}\n",
-	                                GameServer::getConfigHeader(),
-	                                server->getInventoryConfig(),
-	                                server->getRconConfig(),
-	                                server->getBannedPlayers() | util::collect<Refs>() | util::sort(compareBannedPlayerRefs) |
-	                                    util::transform(getBannedPlayerCommand) | util::join('\n')))) {
-		return cmd::error("{}: Failed to save config file \"{}\"!", self.getName(), sv_config_file);
+	if (!util::dumpFile(filepath, server->getPerf().exportCsv())) {
+		return cmd::error("{}: Failed to save perf file \"{}\"!", self.getName(), argv[1]);
 	}
 	return cmd::done();
 }
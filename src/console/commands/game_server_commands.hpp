@@ -10,7 +10,11 @@ extern ConVarIntMinMax sv_tickrate;
 extern ConVarIntMinMax sv_bot_tickrate;
 extern ConVarBool sv_bot_ai_enable;
 extern ConVarBool sv_bot_ai_require_players;
+extern ConVarIntMinMax sv_bot_threads;
+extern ConVarIntMinMax sv_bot_ai_max_thinks;
+extern ConVarIntMinMax sv_bot_ai_max_paths;
 extern ConVarIntMinMax sv_max_ticks_per_frame;
+extern ConVarBool sv_sleep_until_tick;
 extern ConVarIntMinMax sv_playerlimit;
 extern ConVarIntMinMax sv_max_username_length;
 extern ConVarFloatMinMax sv_disconnect_cooldown;
@@ -21,6 +25,7 @@ extern ConVarString sv_hostname;
 extern ConVarBool sv_allow_resource_download;
 extern ConVarFloatMinMax sv_resource_upload_rate;
 extern ConVarIntMinMax sv_resource_upload_chunk_size;
+extern ConVarBool sv_resource_prefetch;
 extern ConVarHashed sv_password;
 extern ConVarBool sv_rtv_enable;
 extern ConVarFloatMinMax sv_rtv_delay;
@@ -31,11 +36,13 @@ extern ConVarIntMinMax sv_bot_count;
 extern ConVarIntMinMax sv_port;
 extern ConVarString sv_config_file;
 extern ConVarString sv_autoexec_file;
+extern ConVarString sv_inventory_file;
 extern ConVarString sv_map_rotation;
 extern ConVarString sv_motd;
 extern ConVarIntMinMax sv_max_clients;
 extern ConVarIntMinMax sv_max_connecting_clients;
 extern ConVarIntMinMax sv_config_auto_save_interval;
+extern ConVarFloatMinMax sv_perf_log_interval;
 extern ConVarIntMinMax sv_score_level_interval;
 extern ConVarFloatMinMax sv_afk_autokick_time;
 extern ConVarIntMinMax sv_max_connections_per_ip;
@@ -62,5 +69,9 @@ CON_COMMAND_EXTERN(sv_unban);
 CON_COMMAND_EXTERN(sv_ban_list);
 
 CON_COMMAND_EXTERN(sv_writeconfig);
+CON_COMMAND_EXTERN(sv_config_save_status);
+
+CON_COMMAND_EXTERN(sv_perf);
+CON_COMMAND_EXTERN(sv_perf_export);
 
 #endif
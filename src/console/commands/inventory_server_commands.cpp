@@ -3,12 +3,16 @@
 #include "../../game/data/hat.hpp"           // Hat
 #include "../../game/server/game_server.hpp" // GameServer
 #include "../../utilities/algorithm.hpp"     // util::transform, util::collect, util::copy, util::contains
+#include "../../utilities/file.hpp"          // util::dumpFile
 #include "../../utilities/string.hpp"        // util::join, util::stringTo
 #include "../command.hpp"                    // cmd::...
 #include "../command_utilities.hpp"          // cmd::...
 #include "../suggestions.hpp"                // Suggestions, SUGGESTIONS
+#include "file_commands.hpp"                 // data_dir, data_subdir_cfg
 
-#include <cassert> // assert
+#include <cassert>    // assert
+#include <fmt/core.h> // fmt::format
+#include <utility>    // std::as_const
 
 namespace {
 
@@ -98,6 +102,19 @@ CON_COMMAND(sv_inventory_list, "", ConCommand::SERVER, "List all inventories on
 	return cmd::done(server->getInventoryList());
 }
 
+CON_COMMAND(sv_inventory_export, "<filename>", ConCommand::SERVER | ConCommand::ADMIN_ONLY | ConCommand::NO_RCON,
+            "Write all inventories to a config file that can be imported into another server.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	assert(server);
+	if (!util::dumpFile(fmt::format("{}/{}/{}", data_dir, data_subdir_cfg, argv[1]), server->getInventoryConfig())) {
+		return cmd::error("{}: Failed to save inventory config file \"{}\"!", self.getName(), argv[1]);
+	}
+	return cmd::done();
+}
+
 CON_COMMAND(sv_inventory_exists, "<inventory_id>", ConCommand::SERVER, "Check if a certain inventory exists.", {}, suggestInventoryId) {
 	if (argv.size() != 2) {
 		return cmd::error(self.getUsage());
@@ -127,7 +144,7 @@ CON_COMMAND(sv_inventory_get_points, "<inventory_id>", ConCommand::SERVER, "Get
 	}
 
 	assert(server);
-	const auto* const score = server->inventoryPoints(id);
+	const auto* const score = std::as_const(*server).inventoryPoints(id);
 	if (!score) {
 		return cmd::error("{}: Inventory \"{}\" not found.", self.getName(), argv[1]);
 	}
@@ -191,7 +208,7 @@ CON_COMMAND(sv_inventory_get_level, "<inventory_id>", ConCommand::SERVER, "Get t
 	}
 
 	assert(server);
-	const auto* const level = server->inventoryLevel(id);
+	const auto* const level = std::as_const(*server).inventoryLevel(id);
 	if (!level) {
 		return cmd::error("{}: Inventory \"{}\" not found.", self.getName(), argv[1]);
 	}
@@ -7,6 +7,7 @@ CON_COMMAND_EXTERN(sv_inventory_add);
 CON_COMMAND_EXTERN(sv_inventory_remove);
 
 CON_COMMAND_EXTERN(sv_inventory_list);
+CON_COMMAND_EXTERN(sv_inventory_export);
 
 CON_COMMAND_EXTERN(sv_inventory_exists);
 
@@ -28,17 +28,14 @@ auto unaryOp(ConCommand& self, cmd::CommandView argv, Func func) -> cmd::Result
 	constexpr auto CONSTRAINT = (ALLOW_ZERO) ? cmd::NumberConstraint::NONE : cmd::NumberConstraint::NON_ZERO;
 
 	if constexpr (TRY_INTEGER) {
-		auto parseError = cmd::ParseError{};
-
-		const auto x = cmd::parseNumber<std::int64_t, CONSTRAINT>(parseError, argv[1], "right hand operand");
-		if (!parseError) {
-			return cmd::done(func(x));
+		if (const auto x = cmd::tryParseNumber<std::int64_t, CONSTRAINT>(argv, 1)) {
+			return cmd::done(func(*x));
 		}
 	}
 
 	auto parseError = cmd::ParseError{};
 
-	const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, argv[1], "right hand operand");
+	const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, argv, 1, "right hand operand");
 	if (parseError) {
 		return cmd::error("{}: {}", self.getName(), *parseError);
 	}
@@ -56,21 +53,17 @@ auto binaryOp(ConCommand& self, cmd::CommandView argv, Func func) -> cmd::Result
 	constexpr auto RHS_CONSTRAINT = (ALLOW_RHS_ZERO) ? cmd::NumberConstraint::NONE : cmd::NumberConstraint::NON_ZERO;
 
 	if constexpr (TRY_INTEGER) {
-		auto parseError = cmd::ParseError{};
-
-		const auto x = cmd::parseNumber<std::int64_t, LHS_CONSTRAINT>(parseError, argv[1], "left hand operand");
-		if (!parseError) {
-			const auto y = cmd::parseNumber<std::int64_t, RHS_CONSTRAINT>(parseError, argv[2], "right hand operand");
-			if (!parseError) {
-				return cmd::done(func(x, y));
+		if (const auto x = cmd::tryParseNumber<std::int64_t, LHS_CONSTRAINT>(argv, 1)) {
+			if (const auto y = cmd::tryParseNumber<std::int64_t, RHS_CONSTRAINT>(argv, 2)) {
+				return cmd::done(func(*x, *y));
 			}
 		}
 	}
 
 	auto parseError = cmd::ParseError{};
 
-	const auto x = cmd::parseNumber<T, LHS_CONSTRAINT>(parseError, argv[1], "left hand operand");
-	const auto y = cmd::parseNumber<T, RHS_CONSTRAINT>(parseError, argv[2], "right hand operand");
+	const auto x = cmd::parseNumber<T, LHS_CONSTRAINT>(parseError, argv, 1, "left hand operand");
+	const auto y = cmd::parseNumber<T, RHS_CONSTRAINT>(parseError, argv, 2, "right hand operand");
 	if (parseError) {
 		return cmd::error("{}: {}", self.getName(), *parseError);
 	}
@@ -91,44 +84,38 @@ auto foldOp(ConCommand& self, cmd::CommandView argv, Func func) -> cmd::Result {
 	[[maybe_unused]] auto validInteger = true;
 
 	if constexpr (TRY_INTEGER) {
-		auto parseError = cmd::ParseError{};
-		const auto x = cmd::parseNumber<std::int64_t, CONSTRAINT>(parseError, argv[1], "argument");
-		if (parseError) {
-			parseError = cmd::ParseError{};
-			const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, argv[1], "argument");
+		if (const auto x = cmd::tryParseNumber<std::int64_t, CONSTRAINT>(argv, 1)) {
+			integerValue = *x;
+			value = static_cast<T>(*x);
+		} else {
+			auto parseError = cmd::ParseError{};
+			value = cmd::parseNumber<T, CONSTRAINT>(parseError, argv, 1, "argument");
 			if (parseError) {
 				return cmd::error("{}: {}", self.getName(), *parseError);
 			}
-			value = x;
 			validInteger = false;
-		} else {
-			integerValue = x;
-			value = static_cast<T>(x);
 		}
 	} else {
 		auto parseError = cmd::ParseError{};
-		const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, argv[1], "argument");
+		value = cmd::parseNumber<T, CONSTRAINT>(parseError, argv, 1, "argument");
 		if (parseError) {
 			return cmd::error("{}: {}", self.getName(), *parseError);
 		}
-		value = x;
 	}
 
-	for (const auto& arg : argv.subCommand(2)) {
+	for (auto i = std::size_t{2}; i < argv.size(); ++i) {
 		if constexpr (TRY_INTEGER) {
-			auto parseError = cmd::ParseError{};
 			if (validInteger) {
-				const auto x = cmd::parseNumber<std::int64_t, CONSTRAINT>(parseError, arg, "argument");
-				if (!parseError) {
-					integerValue = func(integerValue, x);
-					value = func(value, static_cast<T>(x));
+				if (const auto x = cmd::tryParseNumber<std::int64_t, CONSTRAINT>(argv, i)) {
+					integerValue = func(integerValue, *x);
+					value = func(value, static_cast<T>(*x));
 					continue;
 				}
 				validInteger = false;
 			}
 		}
 		auto parseError = cmd::ParseError{};
-		const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, arg, "argument");
+		const auto x = cmd::parseNumber<T, CONSTRAINT>(parseError, argv, i, "argument");
 		if (parseError) {
 			return cmd::error("{}: {}", self.getName(), *parseError);
 		}
@@ -152,7 +139,7 @@ CON_COMMAND(approx_eq, "<x> <y> <epsilon>", ConCommand::NO_FLAGS, "Is x approxim
 
 	auto parseError = cmd::ParseError{};
 
-	const auto epsilon = cmd::parseNumber<double>(parseError, argv[3], "epsilon");
+	const auto epsilon = cmd::parseNumber<double>(parseError, argv, 3, "epsilon");
 	if (parseError) {
 		return cmd::error("{}: {}", self.getName(), *parseError);
 	}
@@ -245,7 +232,7 @@ CON_COMMAND(decimal, "<x> <n>", ConCommand::NO_FLAGS, "Round x to n decimal plac
 
 	auto parseError = cmd::ParseError{};
 
-	const auto n = cmd::parseNumber<std::size_t>(parseError, argv[2], "number of decimal places");
+	const auto n = cmd::parseNumber<std::size_t>(parseError, argv, 2, "number of decimal places");
 	if (parseError) {
 		return cmd::error("{}: {}", self.getName(), *parseError);
 	}
@@ -351,29 +338,22 @@ CON_COMMAND(clamp, "<x> <low> <high>", ConCommand::NO_FLAGS, "Return x clamped b
 		return cmd::error(self.getUsage());
 	}
 
-	{
-		auto parseError = cmd::ParseError{};
-
-		const auto x = cmd::parseNumber<std::int64_t>(parseError, argv[1], "value");
-		if (!parseError) {
-			const auto low = cmd::parseNumber<std::int64_t>(parseError, argv[2], "lower limit");
-			if (!parseError) {
-				const auto high = cmd::parseNumber<std::int64_t>(parseError, argv[3], "upper limit");
-				if (!parseError) {
-					if (low > high) {
-						return cmd::error("{}: Lower limit must not be higher than the upper limit.", self.getName());
-					}
-					return cmd::done(std::clamp(x, low, high));
+	if (const auto x = cmd::tryParseNumber<std::int64_t>(argv, 1)) {
+		if (const auto low = cmd::tryParseNumber<std::int64_t>(argv, 2)) {
+			if (const auto high = cmd::tryParseNumber<std::int64_t>(argv, 3)) {
+				if (*low > *high) {
+					return cmd::error("{}: Lower limit must not be higher than the upper limit.", self.getName());
 				}
+				return cmd::done(std::clamp(*x, *low, *high));
 			}
 		}
 	}
 
 	auto parseError = cmd::ParseError{};
 
-	const auto x = cmd::parseNumber<double>(parseError, argv[1], "value");
-	const auto low = cmd::parseNumber<double>(parseError, argv[2], "lower limit");
-	const auto high = cmd::parseNumber<double>(parseError, argv[3], "upper limit");
+	const auto x = cmd::parseNumber<double>(parseError, argv, 1, "value");
+	const auto low = cmd::parseNumber<double>(parseError, argv, 2, "lower limit");
+	const auto high = cmd::parseNumber<double>(parseError, argv, 3, "upper limit");
 	if (parseError) {
 		return cmd::error("{}: {}", self.getName(), *parseError);
 	}
@@ -415,12 +395,12 @@ CON_COMMAND(is_number, "<x>", ConCommand::NO_FLAGS, "Check if a string contains
 	if (argv.size() != 2) {
 		return cmd::error(self.getUsage());
 	}
-	return cmd::done(util::stringTo<double>(argv[1]) != std::nullopt);
+	return cmd::done(cmd::tryParseNumber<double>(argv, 1) != std::nullopt);
 }
 
 CON_COMMAND(is_integer, "<x>", ConCommand::NO_FLAGS, "Check if a string contains a valid integer.", {}, nullptr) {
 	if (argv.size() != 2) {
 		return cmd::error(self.getUsage());
 	}
-	return cmd::done(util::stringTo<std::int64_t>(argv[1]) != std::nullopt);
+	return cmd::done(cmd::tryParseNumber<std::int64_t>(argv, 1) != std::nullopt);
 }
@@ -49,6 +49,10 @@ ConVarIntMinMax		meta_cl_throttle_limit{			"meta_cl_throttle_limit",			6,		ConVa
 ConVarIntMinMax		meta_cl_throttle_max_period{	"meta_cl_throttle_max_period",		6,		ConVar::CLIENT_SETTING,										"Maximum number of packet sends to skip in a row while the meta client send rate is throttled.", 0, -1, updateThrottle};
 ConVarIntMinMax		meta_cl_max_server_connections{	"meta_cl_max_server_connections",	32,		ConVar::CLIENT_SETTING,										"Maximum number of simultaneous connections to open to game servers received from the meta server.", 1, 1000};
 ConVarIntMinMax		meta_cl_sendrate{				"meta_cl_cmdrate",					10,		ConVar::CLIENT_SETTING,										"The rate (in Hz) at which to send packets to the server.", 1, 1000, updateSendInterval};
+ConVarString		meta_cl_filter_map{				"meta_cl_filter_map",				"",		ConVar::CLIENT_SETTING,										"Only list game servers running this map. Leave empty to list all maps."};
+ConVarBool			meta_cl_filter_not_empty{		"meta_cl_filter_not_empty",			false,	ConVar::CLIENT_SETTING,										"Only list game servers with at least one player."};
+ConVarBool			meta_cl_filter_not_full{		"meta_cl_filter_not_full",			false,	ConVar::CLIENT_SETTING,										"Only list game servers that have room for more players."};
+ConVarBool			meta_cl_ping_servers{			"meta_cl_ping_servers",				false,	ConVar::CLIENT_SETTING,										"Connect to each listed game server after a refresh to measure its ping."};
 // clang-format on
 
 CON_COMMAND(meta_is_connecting, "", ConCommand::META_CLIENT | ConCommand::ADMIN_ONLY | ConCommand::NO_RCON,
@@ -94,10 +98,21 @@ CON_COMMAND(meta_info, "", ConCommand::META_CLIENT | ConCommand::ADMIN_ONLY | Co
             "Get the current server info retrieved by the meta client.", {}, nullptr) {
 	assert(metaClient);
 	static constexpr auto compareMetaInfo = [](const auto& lhs, const auto& rhs) {
-		return lhs->ping < rhs->ping;
+		// Servers with a known ping come first.
+		if (lhs->ping.has_value() != rhs->ping.has_value()) {
+			return lhs->ping.has_value();
+		}
+		if (lhs->ping && *lhs->ping != *rhs->ping) {
+			return *lhs->ping < *rhs->ping;
+		}
+		return lhs->info.playerCount > rhs->info.playerCount;
 	};
 
 	static constexpr auto formatMetaInfo = [](const auto& metaInfo) {
+		// An unknown ping is left empty so that scripts can tell it apart.
+		const auto ping = (metaInfo->ping) ?
+			fmt::format("{}", std::chrono::duration_cast<std::chrono::duration<Latency, std::milli>>(*metaInfo->ping).count()) :
+			Script::escapedString("");
 		return fmt::format(
 			"{{\n"
 			"  ip {}\n"
@@ -110,14 +125,14 @@ CON_COMMAND(meta_info, "", ConCommand::META_CLIENT | ConCommand::ADMIN_ONLY | Co
 			"  ping {}\n"
 			"  tickrate {}\n"
 			"}}",
-			Script::escapedString(std::string{metaInfo->endpoint}),
+			Script::escapedString(std::string{metaInfo->info.endpoint}),
 			Script::escapedString(net::sanitizeMessage(metaInfo->info.hostName)),
 			Script::escapedString(net::sanitizeMessage(metaInfo->info.gameVersion)),
 			Script::escapedString(net::sanitizeMessage(metaInfo->info.mapName)),
 			metaInfo->info.playerCount,
 			metaInfo->info.botCount,
 			metaInfo->info.maxPlayerCount,
-			std::chrono::duration_cast<std::chrono::duration<Latency, std::milli>>(metaInfo->ping).count(),
+			ping,
 			metaInfo->info.tickrate);
 	};
 
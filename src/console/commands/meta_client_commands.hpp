@@ -12,6 +12,10 @@ extern ConVarIntMinMax meta_cl_throttle_limit;
 extern ConVarIntMinMax meta_cl_throttle_max_period;
 extern ConVarIntMinMax meta_cl_max_server_connections;
 extern ConVarIntMinMax meta_cl_sendrate;
+extern ConVarString meta_cl_filter_map;
+extern ConVarBool meta_cl_filter_not_empty;
+extern ConVarBool meta_cl_filter_not_full;
+extern ConVarBool meta_cl_ping_servers;
 
 CON_COMMAND_EXTERN(meta_is_connecting);
 CON_COMMAND_EXTERN(meta_refresh);
@@ -83,6 +83,8 @@ ConVarIntMinMax		meta_sv_max_clients{				"meta_sv_max_clients",					255,							C
 ConVarIntMinMax		meta_sv_max_connecting_clients{		"meta_sv_max_connecting_clients",		10,								ConVar::SERVER_SETTING,										"Maximum number of new connections to handle simultaneously on the meta server. When the limit is hit, any remaining packets received from unconnected addresses will be ignored.", 0, -1};
 ConVarIntMinMax		meta_sv_config_auto_save_interval{	"meta_sv_config_auto_save_interval",	5,								ConVar::SERVER_SETTING,										"Minutes between automatic meta server config saves. 0 = Disable autosave.", 0, -1, updateConfigAutoSaveInterval};
 ConVarIntMinMax		meta_sv_max_connections_per_ip{		"meta_sv_max_connections_per_ip",		10,								ConVar::SERVER_SETTING,										"Maximum number of connections to accept from the same IP address on the meta server (0 = unlimited).", 0, -1};
+ConVarFloatMinMax	meta_sv_cookie_lifetime{			"meta_sv_cookie_lifetime",				5.0f,							ConVar::SERVER_SETTING,										"How many seconds a handshake cookie sent to a new meta client stays valid. New clients have to echo a valid cookie before the meta server allocates a connection for them (0 = don't require cookies).", 0.0f, -1.0f};
+ConVarIntMinMax		meta_sv_server_list_page_size{		"meta_sv_server_list_page_size",		32,								ConVar::SERVER_SETTING,										"Maximum number of game servers to send to a meta client in one server list message.", 1, -1};
 ConVarString		meta_sv_private_address_override{	"meta_sv_private_address_override",		"",								ConVar::SERVER_SETTING,										"If non-empty, the meta server will advertise servers with private addresses as this address instead.", updatePrivateAddressOverride};
 // clang-format on
 
@@ -20,6 +20,8 @@ extern ConVarIntMinMax meta_sv_max_clients;
 extern ConVarIntMinMax meta_sv_max_connecting_clients;
 extern ConVarIntMinMax meta_sv_config_auto_save_interval;
 extern ConVarIntMinMax meta_sv_max_connections_per_ip;
+extern ConVarFloatMinMax meta_sv_cookie_lifetime;
+extern ConVarIntMinMax meta_sv_server_list_page_size;
 extern ConVarString meta_sv_private_address_override;
 
 CON_COMMAND_EXTERN(meta_sv_kick);
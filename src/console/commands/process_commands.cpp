@@ -5,6 +5,7 @@
 #include "../../utilities/string.hpp"    // util::join, util::contains, util::stringTo, util::toString
 #include "../command.hpp"                // cmd::...
 #include "../command_utilities.hpp"      // cmd::...
+#include "../compiled_script.hpp"        // CompiledScript
 #include "../process.hpp"                // Process, CallFrameHandle
 #include "../suggestions.hpp"            // Suggestions
 #include "file_commands.hpp"             // data_dir, data_subdir_cfg, data_subdir_downloads
@@ -12,9 +13,12 @@
 #include <any>        // std::any, std::any_cast
 #include <cassert>    // assert
 #include <fmt/core.h> // fmt::format
+#include <memory>     // std::shared_ptr, std::make_shared
+#include <utility>    // std::move
 
 // clang-format off
 ConVarIntMinMax	await_limit{"await_limit",	10000,	ConVar::WRITE_ADMIN_ONLY | ConVar::NO_RCON_WRITE,	"Default await limit.", 0, -1};
+ConVarIntMinMax	process_budget{"process_budget",	4000,	ConVar::WRITE_ADMIN_ONLY | ConVar::NO_RCON_WRITE,	"Maximum number of microseconds that each background process and the server console process may run per frame. 0 = unlimited.", 0, -1};
 #ifdef NDEBUG
 ConVarBool 		cvar_debug{	"debug",		false,	ConVar::WRITE_ADMIN_ONLY | ConVar::NO_RCON,			"Debug mode."};
 #else
@@ -113,8 +117,8 @@ CON_COMMAND(else, "<script>", ConCommand::NO_FLAGS, "Execute script if the previ
 
 CON_COMMAND(while, "<condition_script> <script>", ConCommand::NO_FLAGS, "Execute script while a condition holds true.", {}, nullptr) {
 	struct State final {
-		Script condition;
-		Script body;
+		std::shared_ptr<const CompiledScript> condition;
+		std::shared_ptr<const CompiledScript> body;
 	};
 
 	switch (frame.progress()) {
@@ -124,8 +128,8 @@ CON_COMMAND(while, "<condition_script> <script>", ConCommand::NO_FLAGS, "Execute
 			}
 
 			auto& state = data.emplace<State>();
-			state.condition = Script::parse(argv[1]);
-			state.body = Script::parse(argv[2]);
+			state.condition = CompiledScript::compile(argv[1]);
+			state.body = CompiledScript::compile(argv[2]);
 
 			assert(frame.arguments().size() == 3);
 			frame.arguments().pop_back();
@@ -167,7 +171,7 @@ CON_COMMAND(while, "<condition_script> <script>", ConCommand::NO_FLAGS, "Execute
 			}
 
 			if (frame.arguments()[1].status == cmd::Status::RETURN_VALUE) {
-				return cmd::returned(std::move(frame.arguments()[1].value));
+				return std::move(frame.arguments()[1]);
 			}
 
 			const auto& state = std::any_cast<const State&>(data);
@@ -184,7 +188,7 @@ CON_COMMAND(while, "<condition_script> <script>", ConCommand::NO_FLAGS, "Execute
 
 CON_COMMAND(for, "<parameter> <start> <end> [step] <script>", ConCommand::NO_FLAGS, "Execute script a given number of times.", {}, nullptr) {
 	struct State final {
-		Script body;
+		std::shared_ptr<const CompiledScript> body;
 		cmd::Progress i{};
 		cmd::Progress end{};
 		cmd::Progress step{};
@@ -197,7 +201,7 @@ CON_COMMAND(for, "<parameter> <start> <end> [step] <script>", ConCommand::NO_FLA
 			}
 
 			auto& state = data.emplace<State>();
-			state.body = Script::parse(argv.back());
+			state.body = CompiledScript::compile(argv.back());
 
 			auto parseError = cmd::ParseError{};
 			state.i = cmd::parseNumber<cmd::Progress>(parseError, argv[2], "start value");
@@ -216,7 +220,8 @@ CON_COMMAND(for, "<parameter> <start> <end> [step] <script>", ConCommand::NO_FLA
 			}
 
 			auto env = std::make_shared<Environment>(frame.env());
-			env->objects.try_emplace(argv[1], Environment::Variable{util::toString(state.i)});
+			auto i = cmd::done(state.i);
+			env->objects.try_emplace(argv[1], Environment::Variable{std::move(i.value), i.scalar});
 			frame.arguments().resize(3, cmd::done());
 			frame.arguments()[2].reset();
 			if (const auto bodyFrame = frame.call(2, std::move(env), state.body)) {
@@ -237,7 +242,7 @@ CON_COMMAND(for, "<parameter> <start> <end> [step] <script>", ConCommand::NO_FLA
 			}
 
 			if (frame.arguments()[2].status == cmd::Status::RETURN_VALUE) {
-				return cmd::returned(std::move(frame.arguments()[2].value));
+				return std::move(frame.arguments()[2]);
 			}
 
 			auto& state = std::any_cast<State&>(data);
@@ -247,7 +252,8 @@ CON_COMMAND(for, "<parameter> <start> <end> [step] <script>", ConCommand::NO_FLA
 			}
 
 			auto env = std::make_shared<Environment>(frame.env());
-			env->objects.try_emplace(argv[1], Environment::Variable{util::toString(state.i)});
+			auto i = cmd::done(state.i);
+			env->objects.try_emplace(argv[1], Environment::Variable{std::move(i.value), i.scalar});
 			frame.arguments()[2].reset();
 			if (const auto bodyFrame = frame.call(2, std::move(env), state.body)) {
 				bodyFrame->makeSection();
@@ -299,7 +305,7 @@ CON_COMMAND(exec, "<filename>", ConCommand::NO_FLAGS, "Execute a script file in
 			return cmd::error("{}: Couldn't read \"{}\".", self.getName(), argv[1]);
 		}
 	}
-	if (!frame.tailCall(frame.env(), *buf)) {
+	if (!frame.tailCall(frame.env(), CompiledScript::compileFile(std::move(*buf)))) {
 		return cmd::error("{}: Stack overflow.", self.getName());
 	}
 	return cmd::done();
@@ -319,12 +325,21 @@ CON_COMMAND(file, "<filename>", ConCommand::NO_FLAGS, "Execute a script file in
 			return cmd::error("{}: Couldn't read \"{}\".", self.getName(), argv[1]);
 		}
 	}
-	if (!frame.tailCall(std::make_shared<Environment>(frame.env()), *buf)) {
+	if (!frame.tailCall(std::make_shared<Environment>(frame.env()), CompiledScript::compileFile(std::move(*buf)))) {
 		return cmd::error("{}: Stack overflow.", self.getName());
 	}
 	return cmd::done();
 }
 
+CON_COMMAND(script_cache_clear, "", ConCommand::NO_FLAGS, "Clear the cache of parsed scripts and script files.", {}, nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
+
+	CompiledScript::clearCache();
+	return cmd::done();
+}
+
 CON_COMMAND(import, "<command...>", ConCommand::NO_FLAGS, "Execute a command with the current environment as its export target.", {}, nullptr) {
 	if (argv.size() < 2) {
 		return cmd::error(self.getUsage());
@@ -436,7 +451,7 @@ CON_COMMAND(assert, "<condition> [message...]", ConCommand::NO_FLAGS, "Raise an
 		}
 
 		frame.arguments().insert(frame.arguments().begin() + 1, cmd::done());
-		if (!frame.call(1, frame.env(), frame.arguments()[2].value)) {
+		if (!frame.call(1, frame.env(), frame.arguments()[2].text())) {
 			return cmd::error("{}: Stack overflow.", self.getName());
 		}
 		return cmd::notDone(1);
@@ -5,6 +5,7 @@
 #include "../convar.hpp"      // ConVar...
 
 extern ConVarIntMinMax await_limit;
+extern ConVarIntMinMax process_budget;
 extern ConVarBool cvar_debug;
 
 CON_COMMAND_EXTERN(void);
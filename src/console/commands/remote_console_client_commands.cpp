@@ -58,7 +58,7 @@ CON_COMMAND(rcon_login, "<username> [password]", ConCommand::CLIENT | ConCommand
 				return cmd::error("{}: Connection error.", self.getName());
 			}
 
-			if (!client->writeRconLoginInfoRequest(frame.arguments()[1].value)) {
+			if (!client->writeRconLoginInfoRequest(frame.arguments()[1].text())) {
 				return cmd::error("{}: Failed to write info request.", self.getName());
 			}
 
@@ -21,6 +21,7 @@ CON_COMMAND(echo, "[strings...]", ConCommand::NO_FLAGS,
 		}
 
 		if (!frame.process()->input()->isDone()) {
+			frame.process()->waitForInput();
 			return cmd::deferToNextFrame((wrote) ? 1 : 0);
 		}
 
@@ -193,6 +194,7 @@ CON_COMMAND(read, "", ConCommand::NO_FLAGS, "Read a string from the process inpu
 		return cmd::done(std::move(*result));
 	}
 
+	frame.process()->waitForInput();
 	return cmd::deferToNextFrame(0);
 }
 
@@ -205,5 +207,6 @@ CON_COMMAND(readln, "", ConCommand::NO_FLAGS, "Read a line from the process inpu
 		return cmd::done(std::move(*result));
 	}
 
+	frame.process()->waitForInput();
 	return cmd::deferToNextFrame(0);
 }
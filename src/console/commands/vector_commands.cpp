@@ -0,0 +1,748 @@
+#include "vector_commands.hpp"
+
+#include "../../utilities/string.hpp"      // util::stringTo, util::toString
+#include "../../utilities/tile_matrix.hpp" // util::TileMatrix
+#include "../command.hpp"                  // cmd::...
+#include "../command_utilities.hpp"        // cmd::...
+#include "../environment.hpp"              // Environment
+#include "../process.hpp"                  // Process, CallFrameHandle
+#include "../script.hpp"                   // Script
+
+#include <array>       // std::array
+#include <cmath>       // std::hypot
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::int64_t
+#include <optional>    // std::optional, std::nullopt
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <utility>     // std::move
+#include <variant>     // std::get_if
+
+// The vector and matrix values used by these commands are tables in the same format as the ones made by the script
+// implementations that they replace, so values can be passed between the two freely:
+// A vector is a table with the keys x and y, and a matrix is a table with the keys w, h and _v, where _v is an array of the
+// elements in row-major order.
+
+namespace {
+
+constexpr auto VEC2_KEYS = std::array<std::string_view, 2>{"x", "y"};
+constexpr auto MATRIX_KEYS = std::array<std::string_view, 3>{"w", "h", "_v"};
+
+// Scripts can't make matrices larger than this, so that a size doesn't overflow or make the server allocate arbitrary
+// amounts of memory.
+constexpr auto MAX_MATRIX_ELEMENTS = std::size_t{1} << 20;
+
+// Number read from a vector component or matrix element. Arithmetic on numbers gives exactly the same results as the
+// corresponding math commands, including keeping integers as integers.
+struct Number final {
+	std::optional<std::int64_t> integer{}; // Set if the number reads as an integer.
+	double real = 0.0;
+};
+
+[[nodiscard]] auto readNumber(std::string_view str) -> std::optional<Number> {
+	if (const auto real = util::stringTo<double>(str)) {
+		return Number{util::stringTo<std::int64_t>(str), *real};
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] auto scalarNumber(const cmd::Scalar& scalar) -> Number {
+	auto result = Number{};
+	if (auto integer = std::int64_t{}; scalar.getType() == cmd::Scalar::Type::INTEGER && scalar.convert(integer) == cmd::Scalar::Conversion::OK) {
+		result.integer = integer;
+	}
+	[[maybe_unused]] const auto conversion = scalar.convert(result.real);
+	return result;
+}
+
+[[nodiscard]] auto argumentNumber(cmd::CommandView argv, std::size_t i) -> std::optional<Number> {
+	if (const auto& scalar = argv.scalar(i)) {
+		return scalarNumber(scalar);
+	}
+	return readNumber(argv[i]);
+}
+
+template <bool TRY_INTEGER, typename Func>
+[[nodiscard]] auto apply(const Number& lhs, const Number& rhs, Func func) -> cmd::Scalar {
+	if constexpr (TRY_INTEGER) {
+		if (lhs.integer && rhs.integer) {
+			return cmd::Scalar{static_cast<std::int64_t>(func(*lhs.integer, *rhs.integer))};
+		}
+	}
+	return cmd::Scalar{static_cast<double>(func(lhs.real, rhs.real))};
+}
+
+[[nodiscard]] auto negate(const Number& x) -> cmd::Scalar {
+	return (x.integer) ? cmd::Scalar{-*x.integer} : cmd::Scalar{-x.real};
+}
+
+constexpr auto plus = [](auto x, auto y) {
+	return x + y;
+};
+
+constexpr auto minus = [](auto x, auto y) {
+	return x - y;
+};
+
+constexpr auto times = [](auto x, auto y) {
+	return x * y;
+};
+
+// Read the values of some keys from a table in the format given by Environment::tableString.
+template <std::size_t N>
+[[nodiscard]] auto readFields(std::string_view table, const std::array<std::string_view, N>& keys) -> std::optional<std::array<std::string, N>> {
+	auto result = std::array<std::string, N>{};
+	auto found = std::size_t{0};
+	for (auto& command : Script::parse(table)) {
+		if (command.size() > 2) {
+			return std::nullopt;
+		}
+		for (auto i = std::size_t{0}; i < N; ++i) {
+			if (command.front().value == keys[i]) {
+				if (command.size() == 2) {
+					result[i] = std::move(command[1].value);
+				}
+				++found;
+				break;
+			}
+		}
+	}
+	if (found != N) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+template <std::size_t N>
+[[nodiscard]] auto fieldsString(const std::array<std::string_view, N>& keys, const std::array<std::string, N>& values) -> std::string {
+	auto result = std::string{};
+	for (auto i = std::size_t{0}; i < N; ++i) {
+		if (i != 0) {
+			result.push_back('\n');
+		}
+		result.append(Script::escapedString(keys[i]));
+		result.push_back(' ');
+		result.append(Script::escapedString(values[i]));
+	}
+	return result;
+}
+
+struct Vec2 final {
+	Number x;
+	Number y;
+};
+
+[[nodiscard]] auto readVec2(std::string_view str) -> std::optional<Vec2> {
+	if (const auto fields = readFields(str, VEC2_KEYS)) {
+		if (const auto x = readNumber((*fields)[0])) {
+			if (const auto y = readNumber((*fields)[1])) {
+				return Vec2{*x, *y};
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] auto vec2String(const cmd::Scalar& x, const cmd::Scalar& y) -> std::string {
+	return fieldsString(VEC2_KEYS, {x.format(), y.format()});
+}
+
+struct Matrix final {
+	std::size_t width = 0;
+	std::size_t height = 0;
+	Environment::Array elements{};
+};
+
+// Get the number of elements in a matrix of the given size, or nothing if the size is too large.
+[[nodiscard]] auto matrixElementCount(std::size_t width, std::size_t height) noexcept -> std::optional<std::size_t> {
+	if (width != 0 && height > MAX_MATRIX_ELEMENTS / width) {
+		return std::nullopt;
+	}
+	return width * height;
+}
+
+[[nodiscard]] auto readMatrix(std::string_view width, std::string_view height, std::string_view elements) -> std::optional<Matrix> {
+	auto result = Matrix{};
+	if (const auto w = util::stringTo<std::size_t>(width)) {
+		if (const auto h = util::stringTo<std::size_t>(height)) {
+			if (const auto count = matrixElementCount(*w, *h)) {
+				result.width = *w;
+				result.height = *h;
+				[[maybe_unused]] const auto appendResult = Environment::appendToArray(result.elements, elements);
+				if (result.elements.size() == *count) {
+					return result;
+				}
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] auto readMatrix(std::string_view str) -> std::optional<Matrix> {
+	if (const auto fields = readFields(str, MATRIX_KEYS)) {
+		return readMatrix((*fields)[0], (*fields)[1], (*fields)[2]);
+	}
+	return std::nullopt;
+}
+
+[[nodiscard]] auto readMatrix(const Environment::Table& table) -> std::optional<Matrix> {
+	const auto w = table.find("w");
+	const auto h = table.find("h");
+	const auto v = table.find("_v");
+	if (w == table.end() || h == table.end() || v == table.end()) {
+		return std::nullopt;
+	}
+	return readMatrix(w->second, h->second, v->second);
+}
+
+[[nodiscard]] auto matrixString(const Matrix& matrix) -> std::string {
+	return fieldsString(MATRIX_KEYS, {util::toString(matrix.width), util::toString(matrix.height), Environment::arrayString(matrix.elements)});
+}
+
+// Read the elements of a matrix as numbers, apply a function to each one and return the resulting matrix.
+template <typename Func>
+[[nodiscard]] auto transformElements(const Matrix& matrix, Func func) -> std::optional<Matrix> {
+	auto result = Matrix{matrix.width, matrix.height, {}};
+	result.elements.reserve(matrix.elements.size());
+	for (auto i = std::size_t{0}; i < matrix.elements.size(); ++i) {
+		const auto x = readNumber(matrix.elements[i]);
+		if (!x) {
+			return std::nullopt;
+		}
+		result.elements.push_back(func(*x, i).format());
+	}
+	return result;
+}
+
+// Character matrices are strings with one row per line, as used by generic entities.
+// Rows that are shorter than the widest row are padded with spaces.
+[[nodiscard]] auto charMatrix(std::string_view str) -> util::TileMatrix<char> {
+	return util::TileMatrix<char>{str, ' '};
+}
+
+[[nodiscard]] auto charMatrixString(const util::TileMatrix<char>& matrix) -> std::string {
+	auto str = matrix.getString();
+	if (!str.empty()) {
+		str.pop_back(); // No newline after the last row.
+	}
+	return str;
+}
+
+} // namespace
+
+CON_COMMAND(vec2, "<x> <y>", ConCommand::NO_FLAGS, "Create a 2D vector.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	return cmd::done(fieldsString(VEC2_KEYS, {argv[1], argv[2]}));
+}
+
+CON_COMMAND(vec2_neg, "<a>", ConCommand::NO_FLAGS, "Negate a 2D vector.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	return cmd::done(vec2String(negate(a->x), negate(a->y)));
+}
+
+CON_COMMAND(vec2_add, "<a> <b>", ConCommand::NO_FLAGS, "Add two 2D vectors.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readVec2(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[2]);
+	}
+	return cmd::done(vec2String(apply<true>(a->x, b->x, plus), apply<true>(a->y, b->y, plus)));
+}
+
+CON_COMMAND(vec2_sub, "<a> <b>", ConCommand::NO_FLAGS, "Subtract a 2D vector from another.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readVec2(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[2]);
+	}
+	return cmd::done(vec2String(apply<true>(a->x, b->x, minus), apply<true>(a->y, b->y, minus)));
+}
+
+CON_COMMAND(vec2_dot, "<a> <b>", ConCommand::NO_FLAGS, "Get the dot product of two 2D vectors.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readVec2(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[2]);
+	}
+	const auto x = scalarNumber(apply<true>(a->x, b->x, times));
+	const auto y = scalarNumber(apply<true>(a->y, b->y, times));
+	return cmd::Result{cmd::Status::VALUE, apply<true>(x, y, plus)};
+}
+
+CON_COMMAND(vec2_mul, "<a> <b>", ConCommand::NO_FLAGS, "Multiply a 2D vector by a number, or a number by a 2D vector.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	if (const auto a = readVec2(argv[1])) {
+		if (const auto b = argumentNumber(argv, 2)) {
+			return cmd::done(vec2String(apply<true>(a->x, *b, times), apply<true>(a->y, *b, times)));
+		}
+	} else if (const auto b = readVec2(argv[2])) {
+		if (const auto a = argumentNumber(argv, 1)) {
+			return cmd::done(vec2String(apply<true>(b->x, *a, times), apply<true>(b->y, *a, times)));
+		}
+	}
+	return cmd::error("{}: Expected a vector and a number.", self.getName());
+}
+
+CON_COMMAND(vec2_div, "<a> <b>", ConCommand::NO_FLAGS, "Divide a 2D vector by a number.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = argumentNumber(argv, 2);
+	if (!b) {
+		return cmd::error("{}: Invalid number \"{}\".", self.getName(), argv[2]);
+	}
+
+	static constexpr auto divide = [](auto x, auto y) {
+		return x / y; // Division by 0 is allowed for floating point.
+	};
+	return cmd::done(vec2String(apply<false>(a->x, *b, divide), apply<false>(a->y, *b, divide)));
+}
+
+CON_COMMAND(vec2_length, "<a>", ConCommand::NO_FLAGS, "Get the length of a 2D vector.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readVec2(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	return cmd::Result{cmd::Status::VALUE, apply<false>(a->x, a->y, [](auto x, auto y) { return std::hypot(x, y); })};
+}
+
+CON_COMMAND(vec2_str, "<a>", ConCommand::NO_FLAGS, "Format a 2D vector as a string.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto fields = readFields(argv[1], VEC2_KEYS);
+	if (!fields) {
+		return cmd::error("{}: Invalid vector \"{}\".", self.getName(), argv[1]);
+	}
+	return cmd::done("({}, {})", (*fields)[0], (*fields)[1]);
+}
+
+CON_COMMAND(matrix, "<w> <h> [initializer]", ConCommand::NO_FLAGS, "Create a matrix, either filled with zeros or from an array of elements.", {}, nullptr) {
+	if (argv.size() != 3 && argv.size() != 4) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto w = cmd::parseNumber<std::size_t>(parseError, argv, 1, "width");
+	const auto h = cmd::parseNumber<std::size_t>(parseError, argv, 2, "height");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	const auto count = matrixElementCount(w, h);
+	if (!count) {
+		return cmd::error("{}: Matrix size {}x{} is too large (max {} elements).", self.getName(), w, h, MAX_MATRIX_ELEMENTS);
+	}
+
+	auto matrix = Matrix{w, h, {}};
+	if (argv.size() == 4) {
+		if (auto result = Environment::appendToArray(matrix.elements, argv[3]); result.status == cmd::Status::ERROR_MSG) {
+			return result;
+		}
+		if (matrix.elements.size() != *count) {
+			return cmd::error("{}: Expected {} elements for a {}x{} matrix, got {}.", self.getName(), *count, w, h, matrix.elements.size());
+		}
+	} else {
+		matrix.elements.resize(*count, "0");
+	}
+	return cmd::done(matrixString(matrix));
+}
+
+CON_COMMAND(mat_is_square, "<a>", ConCommand::NO_FLAGS, "Check if a matrix is square.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+	return cmd::done(a->width == a->height);
+}
+
+CON_COMMAND(mat_get, "<a> <x> <y>", ConCommand::NO_FLAGS, "Get an element of a matrix.", {}, nullptr) {
+	if (argv.size() != 4) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto x = cmd::parseNumber<std::size_t>(parseError, argv, 2, "x");
+	const auto y = cmd::parseNumber<std::size_t>(parseError, argv, 3, "y");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+	if (x >= a->width || y >= a->height) {
+		return cmd::error("{}: Matrix index out of range ({}, {}) / ({}, {}).", self.getName(), x, y, a->width, a->height);
+	}
+	return cmd::done(std::move(a->elements[y * a->width + x]));
+}
+
+CON_COMMAND(mat_set, "<name> <x> <y> <value>", ConCommand::NO_FLAGS, "Set an element of a matrix object.", {}, nullptr) {
+	if (argv.size() != 5) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto x = cmd::parseNumber<std::size_t>(parseError, argv, 2, "x");
+	const auto y = cmd::parseNumber<std::size_t>(parseError, argv, 3, "y");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	auto* const obj = frame.process()->findObject(frame.env(), argv[1]);
+	if (!obj) {
+		return cmd::error("{}: Couldn't find \"{}\".", self.getName(), argv[1]);
+	}
+
+	auto* const table = std::get_if<Environment::Table>(obj);
+	auto* const var = std::get_if<Environment::Variable>(obj);
+	auto a = (table) ? readMatrix(*table) : (var) ? readMatrix(var->text()) : std::nullopt;
+	if (!a) {
+		return cmd::error("{}: {} is not a matrix.", self.getName(), argv[1]);
+	}
+	if (x >= a->width || y >= a->height) {
+		return cmd::error("{}: Matrix index out of range ({}, {}) / ({}, {}).", self.getName(), x, y, a->width, a->height);
+	}
+
+	a->elements[y * a->width + x] = argv[4];
+	if (table) {
+		(*table)["_v"] = Environment::arrayString(a->elements);
+	} else {
+		var->value = matrixString(*a);
+		var->scalar = cmd::Scalar{};
+	}
+	return cmd::done();
+}
+
+CON_COMMAND(mat_neg, "<a>", ConCommand::NO_FLAGS, "Negate a matrix.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+
+	const auto result = transformElements(*a, [](const Number& x, std::size_t) { return negate(x); });
+	if (!result) {
+		return cmd::error("{}: Matrix has non-numeric elements.", self.getName());
+	}
+	return cmd::done(matrixString(*result));
+}
+
+CON_COMMAND(mat_add, "<a> <b>", ConCommand::NO_FLAGS, "Add two matrices.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readMatrix(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[2]);
+	}
+	if (a->width != b->width || a->height != b->height) {
+		return cmd::error("{}: Matrix sizes don't match.", self.getName());
+	}
+
+	auto valid = true;
+	const auto result = transformElements(*a, [&](const Number& x, std::size_t i) {
+		const auto y = readNumber(b->elements[i]);
+		valid = valid && y.has_value();
+		return (y) ? apply<true>(x, *y, plus) : cmd::Scalar{};
+	});
+	if (!result || !valid) {
+		return cmd::error("{}: Matrix has non-numeric elements.", self.getName());
+	}
+	return cmd::done(matrixString(*result));
+}
+
+CON_COMMAND(mat_sub, "<a> <b>", ConCommand::NO_FLAGS, "Subtract a matrix from another.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readMatrix(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[2]);
+	}
+	if (a->width != b->width || a->height != b->height) {
+		return cmd::error("{}: Matrix sizes don't match.", self.getName());
+	}
+
+	auto valid = true;
+	const auto result = transformElements(*a, [&](const Number& x, std::size_t i) {
+		const auto y = readNumber(b->elements[i]);
+		valid = valid && y.has_value();
+		return (y) ? apply<true>(x, scalarNumber(negate(*y)), plus) : cmd::Scalar{};
+	});
+	if (!result || !valid) {
+		return cmd::error("{}: Matrix has non-numeric elements.", self.getName());
+	}
+	return cmd::done(matrixString(*result));
+}
+
+CON_COMMAND(mat_mul, "<a> <b>", ConCommand::NO_FLAGS, "Multiply two matrices.", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+	const auto b = readMatrix(argv[2]);
+	if (!b) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[2]);
+	}
+	if (a->width != b->height) {
+		return cmd::error("{}: Matrix sizes don't match.", self.getName());
+	}
+
+	auto result = Matrix{b->width, a->height, {}};
+	result.elements.reserve(result.width * result.height);
+	for (auto y = std::size_t{0}; y < result.height; ++y) {
+		for (auto x = std::size_t{0}; x < result.width; ++x) {
+			auto sum = Number{std::int64_t{0}, 0.0};
+			for (auto i = std::size_t{0}; i < a->width; ++i) {
+				const auto lhs = readNumber(a->elements[y * a->width + i]);
+				const auto rhs = readNumber(b->elements[i * b->width + x]);
+				if (!lhs || !rhs) {
+					return cmd::error("{}: Matrix has non-numeric elements.", self.getName());
+				}
+				sum = scalarNumber(apply<true>(sum, scalarNumber(apply<true>(*lhs, *rhs, times)), plus));
+			}
+			result.elements.push_back(((sum.integer) ? cmd::Scalar{*sum.integer} : cmd::Scalar{sum.real}).format());
+		}
+	}
+	return cmd::done(matrixString(result));
+}
+
+CON_COMMAND(mat_str, "<a>", ConCommand::NO_FLAGS, "Format a matrix as a string with one row per line.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto a = readMatrix(argv[1]);
+	if (!a) {
+		return cmd::error("{}: Invalid matrix \"{}\".", self.getName(), argv[1]);
+	}
+
+	auto str = std::string{};
+	for (auto y = std::size_t{0}; y < a->height; ++y) {
+		if (y != 0) {
+			str.push_back('\n');
+		}
+		for (auto x = std::size_t{0}; x < a->width; ++x) {
+			if (x != 0) {
+				str.push_back(' ');
+			}
+			str.append(a->elements[y * a->width + x]);
+		}
+	}
+	return cmd::done(std::move(str));
+}
+
+CON_COMMAND(charmat_get, "<matrix> <x> <y>", ConCommand::NO_FLAGS, "Get a character in a character matrix.", {}, nullptr) {
+	if (argv.size() != 4) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto x = cmd::parseNumber<std::size_t>(parseError, argv, 2, "x");
+	const auto y = cmd::parseNumber<std::size_t>(parseError, argv, 3, "y");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	const auto matrix = charMatrix(argv[1]);
+	if (x >= matrix.getWidth() || y >= matrix.getHeight()) {
+		return cmd::error("{}: Matrix index out of range ({}, {}) / ({}, {}).", self.getName(), x, y, matrix.getWidth(), matrix.getHeight());
+	}
+	return cmd::done(std::string(1, matrix.getUnchecked(x, y)));
+}
+
+CON_COMMAND(charmat_set, "<matrix> <x> <y> <char>", ConCommand::NO_FLAGS, "Get a character matrix with one character replaced.", {}, nullptr) {
+	if (argv.size() != 5) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto x = cmd::parseNumber<std::size_t>(parseError, argv, 2, "x");
+	const auto y = cmd::parseNumber<std::size_t>(parseError, argv, 3, "y");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	if (argv[4].size() != 1) {
+		return cmd::error("{}: Invalid character \"{}\".", self.getName(), argv[4]);
+	}
+
+	auto matrix = charMatrix(argv[1]);
+	if (x >= matrix.getWidth() || y >= matrix.getHeight()) {
+		return cmd::error("{}: Matrix index out of range ({}, {}) / ({}, {}).", self.getName(), x, y, matrix.getWidth(), matrix.getHeight());
+	}
+	matrix.setUnchecked(x, y, argv[4].front());
+	return cmd::done(charMatrixString(matrix));
+}
+
+CON_COMMAND(charmat_blit, "<matrix> <x> <y> <source> [transparent_char]", ConCommand::NO_FLAGS,
+            "Get a character matrix with another one drawn on top of it at a certain position.", {}, nullptr) {
+	if (argv.size() != 5 && argv.size() != 6) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto x = cmd::parseNumber<int>(parseError, argv, 2, "x");
+	const auto y = cmd::parseNumber<int>(parseError, argv, 3, "y");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	if (argv.size() == 6 && argv[5].size() != 1) {
+		return cmd::error("{}: Invalid transparent character \"{}\".", self.getName(), argv[5]);
+	}
+
+	auto matrix = charMatrix(argv[1]);
+	const auto source = charMatrix(argv[4]);
+	const auto width = static_cast<int>(matrix.getWidth());
+	const auto height = static_cast<int>(matrix.getHeight());
+	for (auto sy = 0; sy < static_cast<int>(source.getHeight()); ++sy) {
+		for (auto sx = 0; sx < static_cast<int>(source.getWidth()); ++sx) {
+			const auto ch = source.getUnchecked(static_cast<std::size_t>(sx), static_cast<std::size_t>(sy));
+			if (argv.size() == 6 && ch == argv[5].front()) {
+				continue;
+			}
+			if (x + sx >= 0 && x + sx < width && y + sy >= 0 && y + sy < height) {
+				matrix.setUnchecked(static_cast<std::size_t>(x + sx), static_cast<std::size_t>(y + sy), ch);
+			}
+		}
+	}
+	return cmd::done(charMatrixString(matrix));
+}
+
+CON_COMMAND(charmat_transpose, "<matrix>", ConCommand::NO_FLAGS, "Get the transpose of a character matrix.", {}, nullptr) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto matrix = charMatrix(argv[1]);
+	auto result = util::TileMatrix<char>{matrix.getHeight(), matrix.getWidth()};
+	for (auto y = std::size_t{0}; y < result.getHeight(); ++y) {
+		for (auto x = std::size_t{0}; x < result.getWidth(); ++x) {
+			result.setUnchecked(x, y, matrix.getUnchecked(y, x));
+		}
+	}
+	return cmd::done(charMatrixString(result));
+}
+
+CON_COMMAND(charmat_rotate, "<matrix> <quarter_turns>", ConCommand::NO_FLAGS,
+            "Get a character matrix rotated clockwise by a number of quarter turns (negative for counter-clockwise).", {}, nullptr) {
+	if (argv.size() != 3) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto parseError = cmd::ParseError{};
+
+	const auto quarterTurns = cmd::parseNumber<int>(parseError, argv, 2, "quarter turns");
+	if (parseError) {
+		return cmd::error("{}: {}", self.getName(), *parseError);
+	}
+
+	const auto matrix = charMatrix(argv[1]);
+	const auto w = matrix.getWidth();
+	const auto h = matrix.getHeight();
+	switch ((quarterTurns % 4 + 4) % 4) {
+		case 1: {
+			auto result = util::TileMatrix<char>{h, w};
+			for (auto y = std::size_t{0}; y < w; ++y) {
+				for (auto x = std::size_t{0}; x < h; ++x) {
+					result.setUnchecked(x, y, matrix.getUnchecked(y, h - 1 - x));
+				}
+			}
+			return cmd::done(charMatrixString(result));
+		}
+		case 2: {
+			auto result = util::TileMatrix<char>{w, h};
+			for (auto y = std::size_t{0}; y < h; ++y) {
+				for (auto x = std::size_t{0}; x < w; ++x) {
+					result.setUnchecked(x, y, matrix.getUnchecked(w - 1 - x, h - 1 - y));
+				}
+			}
+			return cmd::done(charMatrixString(result));
+		}
+		case 3: {
+			auto result = util::TileMatrix<char>{h, w};
+			for (auto y = std::size_t{0}; y < w; ++y) {
+				for (auto x = std::size_t{0}; x < h; ++x) {
+					result.setUnchecked(x, y, matrix.getUnchecked(w - 1 - y, x));
+				}
+			}
+			return cmd::done(charMatrixString(result));
+		}
+		default: break;
+	}
+	return cmd::done(charMatrixString(matrix));
+}
@@ -0,0 +1,32 @@
+#ifndef AF2_CONSOLE_COMMANDS_VECTOR_COMMANDS_HPP
+#define AF2_CONSOLE_COMMANDS_VECTOR_COMMANDS_HPP
+
+#include "../con_command.hpp" // ConCommand, CON_COMMAND, CON_COMMAND_EXTERN
+
+CON_COMMAND_EXTERN(vec2);
+CON_COMMAND_EXTERN(vec2_neg);
+CON_COMMAND_EXTERN(vec2_add);
+CON_COMMAND_EXTERN(vec2_sub);
+CON_COMMAND_EXTERN(vec2_dot);
+CON_COMMAND_EXTERN(vec2_mul);
+CON_COMMAND_EXTERN(vec2_div);
+CON_COMMAND_EXTERN(vec2_length);
+CON_COMMAND_EXTERN(vec2_str);
+
+CON_COMMAND_EXTERN(matrix);
+CON_COMMAND_EXTERN(mat_is_square);
+CON_COMMAND_EXTERN(mat_get);
+CON_COMMAND_EXTERN(mat_set);
+CON_COMMAND_EXTERN(mat_neg);
+CON_COMMAND_EXTERN(mat_add);
+CON_COMMAND_EXTERN(mat_sub);
+CON_COMMAND_EXTERN(mat_mul);
+CON_COMMAND_EXTERN(mat_str);
+
+CON_COMMAND_EXTERN(charmat_get);
+CON_COMMAND_EXTERN(charmat_set);
+CON_COMMAND_EXTERN(charmat_blit);
+CON_COMMAND_EXTERN(charmat_transpose);
+CON_COMMAND_EXTERN(charmat_rotate);
+
+#endif
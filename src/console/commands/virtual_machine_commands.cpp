@@ -1,5 +1,6 @@
 #include "virtual_machine_commands.hpp"
 
+#include "../../utilities/file.hpp"   // util::dumpFile, util::pathIsBelowDirectory
 #include "../../utilities/string.hpp" // util::contains
 #include "../call_frame_handle.hpp"   // CallFrameHandle
 #include "../command.hpp"             // cmd::...
@@ -8,8 +9,10 @@
 #include "../process.hpp"             // Process
 #include "../suggestions.hpp"         // Suggestions
 #include "../virtual_machine.hpp"     // VirtualMachine
+#include "file_commands.hpp"          // data_dir
 
-#include <any> // std::any, std::any_cast
+#include <any>        // std::any, std::any_cast
+#include <fmt/core.h> // fmt::format
 
 CON_COMMAND(current_time, "", ConCommand::NO_FLAGS, "Get the current timestamp in milliseconds.", {}, nullptr) {
 	if (argv.size() != 1) {
@@ -102,10 +105,12 @@ CON_COMMAND(sleep, "<milliseconds>", ConCommand::NO_FLAGS, "Delay remaining comm
 
 		const auto endTime = vm.getTime() * 1000.0f + milliseconds;
 		data.emplace<float>(endTime);
+		frame.process()->sleepUntil(endTime / 1000.0f);
 		return cmd::deferToNextFrame(1);
 	}
 
 	if (const auto endTime = std::any_cast<float>(data); vm.getTime() * 1000.0f < endTime) {
+		frame.process()->sleepUntil(endTime / 1000.0f);
 		return cmd::deferToNextFrame(1);
 	}
 
@@ -308,6 +313,62 @@ CON_COMMAND(ps, "", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON, "List all curr
 	return cmd::done(vm.processSummary());
 }
 
+CON_COMMAND(profile_start, "", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON, "Clear the script profile and start recording a new one.", {},
+            nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
+
+	vm.profiler().clear();
+	vm.profiler().start();
+	return cmd::done();
+}
+
+CON_COMMAND(profile_stop, "", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON, "Stop recording the script profile.", {}, nullptr) {
+	if (argv.size() != 1) {
+		return cmd::error(self.getUsage());
+	}
+
+	vm.profiler().stop();
+	return cmd::done();
+}
+
+CON_COMMAND(profile_report, "[count]", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON,
+            "List the commands and functions that scripts have spent the most time in since the profile was started.", {}, nullptr) {
+	if (argv.size() != 1 && argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	auto count = std::size_t{20};
+	if (argv.size() == 2) {
+		auto parseError = cmd::ParseError{};
+		count = cmd::parseNumber<std::size_t>(parseError, argv[1], "count");
+		if (parseError) {
+			return cmd::error("{}: {}", self.getName(), *parseError);
+		}
+	}
+
+	return cmd::done(vm.profiler().report(count));
+}
+
+CON_COMMAND(profile_dump, "<filepath>", ConCommand::ADMIN_ONLY | ConCommand::NO_RCON,
+            "Write the script profile to a file as collapsed stacks that can be turned into a flame graph.", {}, Suggestions::suggestFile<1>) {
+	if (argv.size() != 2) {
+		return cmd::error(self.getUsage());
+	}
+
+	const auto filepath = fmt::format("{}/{}", data_dir, argv[1]);
+	if (!util::pathIsBelowDirectory(filepath, data_dir)) {
+		return cmd::error("{}: Invalid filepath \"{}\".", self.getName(), argv[1]);
+	}
+
+	if (!util::dumpFile(filepath, vm.profiler().collapsedStacks())) {
+		return cmd::error("{}: Couldn't open \"{}\" for writing.", self.getName(), filepath);
+	}
+
+	return cmd::done();
+}
+
 CON_COMMAND(release, "<process>", ConCommand::ADMIN_ONLY, "Release a process and have it run independently in the background.", {},
             VirtualMachine::suggestProcessId<1>) {
 	if (argv.size() != 2) {
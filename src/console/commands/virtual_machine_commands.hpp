@@ -26,6 +26,11 @@ CON_COMMAND_EXTERN(stop);
 
 CON_COMMAND_EXTERN(ps);
 
+CON_COMMAND_EXTERN(profile_start);
+CON_COMMAND_EXTERN(profile_stop);
+CON_COMMAND_EXTERN(profile_report);
+CON_COMMAND_EXTERN(profile_dump);
+
 CON_COMMAND_EXTERN(release);
 
 CON_COMMAND_EXTERN(launch);
@@ -0,0 +1,128 @@
+#include "compiled_script.hpp"
+
+#include <cassert>       // assert
+#include <functional>    // std::hash
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move
+
+namespace {
+
+using ScriptCache = std::unordered_map<std::string_view, std::shared_ptr<const CompiledScript>>;
+
+using FileCache = std::unordered_map<std::size_t, std::shared_ptr<const CompiledScript>>;
+
+auto scriptCache() -> ScriptCache& {
+	static auto cache = ScriptCache{};
+	return cache;
+}
+
+auto fileCache() -> FileCache& {
+	static auto cache = FileCache{};
+	return cache;
+}
+
+} // namespace
+
+auto CompiledScript::compile(Script script) -> std::shared_ptr<const CompiledScript> {
+	return std::make_shared<const CompiledScript>(std::move(script), std::string{});
+}
+
+auto CompiledScript::compile(std::string_view script) -> std::shared_ptr<const CompiledScript> {
+	if (script.size() > MAX_CACHED_SCRIPT_LENGTH) {
+		return CompiledScript::compile(Script::parse(script));
+	}
+
+	auto& cache = scriptCache();
+	if (const auto it = cache.find(script); it != cache.end()) {
+		return it->second;
+	}
+
+	if (cache.size() >= MAX_CACHE_SIZE) {
+		cache.clear();
+	}
+
+	// The key views the source string owned by the compiled script itself.
+	auto compiled = std::make_shared<const CompiledScript>(Script::parse(script), std::string{script});
+	cache.emplace(compiled->getSource(), compiled);
+	return compiled;
+}
+
+auto CompiledScript::compileFile(std::string source) -> std::shared_ptr<const CompiledScript> {
+	auto& cache = fileCache();
+	const auto hash = std::hash<std::string_view>{}(source);
+	if (const auto it = cache.find(hash); it != cache.end() && it->second->getSource() == source) {
+		return it->second;
+	}
+
+	if (cache.size() >= MAX_FILE_CACHE_SIZE) {
+		cache.clear();
+	}
+
+	auto script = Script::parse(source);
+	auto compiled = std::make_shared<const CompiledScript>(std::move(script), std::move(source));
+	cache.insert_or_assign(hash, compiled);
+	return compiled;
+}
+
+auto CompiledScript::clearCache() noexcept -> void {
+	scriptCache().clear();
+	fileCache().clear();
+}
+
+auto CompiledScript::getCacheSize() noexcept -> std::size_t {
+	return scriptCache().size() + fileCache().size();
+}
+
+CompiledScript::CompiledScript(Script script, std::string source)
+	: m_source(std::move(source)) {
+	m_commands.reserve(script.size());
+	for (auto& arguments : script) {
+		assert(!arguments.empty());
+		auto& command = m_commands.emplace_back();
+		command.pipe = (arguments.back().flags & Script::Argument::PIPE) != 0;
+		if ((arguments.front().flags & (Script::Argument::EXEC | Script::Argument::EXPAND)) == 0) {
+			command.symbol = SymbolRef{Symbol::get(arguments.front().value)};
+		}
+		for (auto i = std::size_t{0}; i < arguments.size(); ++i) {
+			const auto& argument = arguments[i];
+			if ((argument.flags & Script::Argument::EXPAND) != 0) {
+				command.expand = true;
+			}
+			if ((argument.flags & Script::Argument::EXEC) != 0) {
+				command.subScripts.resize(arguments.size());
+				command.subScripts[i] = CompiledScript::compile(std::string_view{argument.value});
+			}
+		}
+		command.arguments = std::move(arguments);
+	}
+}
+
+auto CompiledScript::getSource() const noexcept -> std::string_view {
+	return m_source;
+}
+
+auto CompiledScript::size() const noexcept -> std::size_t {
+	return m_commands.size();
+}
+
+auto CompiledScript::empty() const noexcept -> bool {
+	return m_commands.empty();
+}
+
+auto CompiledScript::front() const noexcept -> const Command& {
+	assert(!m_commands.empty());
+	return m_commands.front();
+}
+
+auto CompiledScript::begin() const noexcept -> std::vector<Command>::const_iterator {
+	return m_commands.begin();
+}
+
+auto CompiledScript::end() const noexcept -> std::vector<Command>::const_iterator {
+	return m_commands.end();
+}
+
+auto CompiledScript::operator[](std::size_t i) const noexcept -> const Command& {
+	assert(i < m_commands.size());
+	return m_commands[i];
+}
@@ -0,0 +1,77 @@
+#ifndef AF2_CONSOLE_COMPILED_SCRIPT_HPP
+#define AF2_CONSOLE_COMPILED_SCRIPT_HPP
+
+#include "environment.hpp" // Environment
+#include "script.hpp"      // Script
+#include "symbol.hpp"      // Symbol, SymbolRef
+
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
+#include <memory>      // std::shared_ptr
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <variant>     // std::variant, std::monostate
+#include <vector>      // std::vector
+
+class ConCommand;
+class ConVar;
+
+// Immutable form of a script that is prepared once and then shared by every call frame that runs it.
+class CompiledScript final {
+public:
+	// What the name of a command was found to refer to the last time it was executed.
+	struct Binding final {
+		using Target = std::variant<std::monostate, Environment::Object*, ConCommand*, ConVar*>;
+
+		Target target{};           // Monostate if the name is an alias, an input action or unknown.
+		std::uint64_t version = 0; // Version of the symbol when the binding was made, or 0 if it hasn't been made yet.
+		std::uint64_t envId = 0;   // Environment that the command was executed in.
+		std::uint64_t ownerId = 0; // Environment that the object was found in.
+		std::size_t depth = 0;     // Number of parents between the two environments.
+	};
+
+	struct Command final {
+		Script::Command arguments{};                                     // Arguments as parsed.
+		std::vector<std::shared_ptr<const CompiledScript>> subScripts{}; // Compiled script of each EXEC argument. Empty if there are none.
+		SymbolRef symbol{};                                              // Symbol of the command name, or null if it is only known after expansion.
+		mutable Binding binding{};                                       // Cached lookup of the command name. Only used if there is a symbol.
+		bool expand = false;                                             // Whether any argument needs to be expanded before use.
+		bool pipe = false;                                               // Whether the output of this command is piped to the next one.
+	};
+
+	static constexpr auto MAX_CACHE_SIZE = std::size_t{1024};
+	static constexpr auto MAX_CACHED_SCRIPT_LENGTH = std::size_t{8192};
+	static constexpr auto MAX_FILE_CACHE_SIZE = std::size_t{64};
+
+	// Compile a script that has already been parsed.
+	[[nodiscard]] static auto compile(Script script) -> std::shared_ptr<const CompiledScript>;
+
+	// Parse and compile a script. Short scripts are cached by their source text, so that script strings which are
+	// executed over and over again, such as loop bodies and $(...) expressions, are only parsed once.
+	[[nodiscard]] static auto compile(std::string_view script) -> std::shared_ptr<const CompiledScript>;
+
+	// Parse and compile the contents of a script file. Files of any length are cached by a hash of their contents, so
+	// executing a file that hasn't changed since the last time it was executed doesn't parse it again.
+	[[nodiscard]] static auto compileFile(std::string source) -> std::shared_ptr<const CompiledScript>;
+
+	static auto clearCache() noexcept -> void;
+	[[nodiscard]] static auto getCacheSize() noexcept -> std::size_t;
+
+	CompiledScript() noexcept = default;
+	CompiledScript(Script script, std::string source);
+
+	[[nodiscard]] auto getSource() const noexcept -> std::string_view;
+
+	[[nodiscard]] auto size() const noexcept -> std::size_t;
+	[[nodiscard]] auto empty() const noexcept -> bool;
+	[[nodiscard]] auto front() const noexcept -> const Command&;
+	[[nodiscard]] auto begin() const noexcept -> std::vector<Command>::const_iterator;
+	[[nodiscard]] auto end() const noexcept -> std::vector<Command>::const_iterator;
+	[[nodiscard]] auto operator[](std::size_t i) const noexcept -> const Command&;
+
+private:
+	std::vector<Command> m_commands{};
+	std::string m_source{};
+};
+
+#endif
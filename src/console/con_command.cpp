@@ -3,6 +3,7 @@
 #include "../utilities/algorithm.hpp" // util::noneOf, util::transform
 #include "../utilities/string.hpp"    // util::join
 #include "convar.hpp"                 // ConVar...
+#include "symbol.hpp"                 // Symbol
 
 #include <cassert>    // assert
 #include <fmt/core.h> // fmt::format
@@ -14,10 +15,8 @@ auto ConCommand::all() -> std::unordered_map<std::string_view, ConCommand&>& {
 }
 
 auto ConCommand::find(std::string_view name) -> ConCommand* {
-	auto& commands = ConCommand::all();
-
-	const auto it = commands.find(name);
-	return (it == commands.end()) ? nullptr : &it->second;
+	const auto* const symbol = Symbol::find(name);
+	return (symbol) ? symbol->command : nullptr;
 }
 
 ConCommand::ConCommand(std::string name, std::string parameters, Flags flags, std::string description, std::vector<cmd::OptionSpec> options,
@@ -34,10 +33,15 @@ ConCommand::ConCommand(std::string name, std::string parameters, Flags flags, st
 	assert(ConVar::all().count(this->getName()) == 0);
 	assert(ConCommand::all().count(this->getName()) == 0);
 	ConCommand::all().emplace(this->getName(), *this);
+	Symbol::get(this->getName()).command = this;
 }
 
 ConCommand::~ConCommand() {
 	ConCommand::all().erase(this->getName());
+	if (auto* const symbol = Symbol::find(this->getName())) {
+		symbol->command = nullptr;
+		symbol->release();
+	}
 }
 
 auto ConCommand::getName() const noexcept -> std::string_view {
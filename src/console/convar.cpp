@@ -8,6 +8,7 @@
 #include "con_command.hpp"                // ConCommand
 #include "process.hpp"                    // Process
 #include "script.hpp"                     // Script
+#include "symbol.hpp"                     // Symbol
 
 #include <cassert>    // assert
 #include <cstdlib>    // std::byte
@@ -19,10 +20,8 @@ auto ConVar::all() -> std::unordered_map<std::string_view, ConVar&>& {
 }
 
 auto ConVar::find(std::string_view name) -> ConVar* {
-	auto& cvars = ConVar::all();
-
-	const auto it = cvars.find(name);
-	return (it == cvars.end()) ? nullptr : &it->second;
+	const auto* const symbol = Symbol::find(name);
+	return (symbol) ? symbol->cvar : nullptr;
 }
 
 ConVar::ConVar(Type type, std::string name, std::string defaultValue, Flags flags, std::string description, Callback onModified)
@@ -39,10 +38,15 @@ ConVar::ConVar(Type type, std::string name, std::string defaultValue, Flags flag
 	assert(ConVar::all().count(this->getName()) == 0);
 	assert(ConCommand::all().count(this->getName()) == 0);
 	ConVar::all().emplace(this->getName(), *this);
+	Symbol::get(this->getName()).cvar = this;
 }
 
 ConVar::~ConVar() {
 	ConVar::all().erase(this->getName());
+	if (auto* const symbol = Symbol::find(this->getName())) {
+		symbol->cvar = nullptr;
+		symbol->release();
+	}
 }
 
 auto ConVar::set(std::string_view value, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient)
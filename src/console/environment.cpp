@@ -7,6 +7,26 @@
 #include <fmt/core.h> // fmt::format
 #include <utility>    // std::move
 
+namespace {
+
+auto nextEnvironmentId() noexcept -> std::uint64_t {
+	static auto id = std::uint64_t{0};
+	return ++id;
+}
+
+} // namespace
+
+auto Environment::Variable::text() -> std::string& {
+	if (scalar && value.empty()) {
+		value = scalar.format();
+	}
+	return value;
+}
+
+auto Environment::Variable::text() const -> std::string {
+	return (scalar && value.empty()) ? scalar.format() : value;
+}
+
 auto Environment::arrayString(const Array& arr) -> std::string {
 	return arr | util::transform(Script::escapedString) | util::join('\n');
 }
@@ -47,14 +67,17 @@ auto Environment::appendToTable(Table& table, std::string_view script) -> cmd::R
 }
 
 Environment::Environment(std::shared_ptr<Environment> parent)
-	: parent(std::move(parent)) {}
+	: parent(std::move(parent))
+	, id(nextEnvironmentId()) {}
 
 Environment::Environment(ObjectMap objects, AliasMap aliases)
-	: objects(std::move(objects))
+	: id(nextEnvironmentId())
+	, objects(std::move(objects))
 	, aliases(std::move(aliases)) {}
 
 Environment::Environment(std::shared_ptr<Environment> parent, ObjectMap objects, AliasMap aliases)
 	: parent(std::move(parent))
+	, id(nextEnvironmentId())
 	, objects(std::move(objects))
 	, aliases(std::move(aliases)) {}
 
@@ -62,3 +85,10 @@ auto Environment::reset() noexcept -> void {
 	aliases.clear();
 	objects.clear();
 }
+
+auto Environment::reuse(std::shared_ptr<Environment> newParent) noexcept -> void {
+	assert(objects.empty());
+	assert(aliases.empty());
+	parent = std::move(newParent);
+	id = nextEnvironmentId();
+}
@@ -3,7 +3,9 @@
 
 #include "command.hpp" // cmd::...
 #include "script.hpp"  // Script
+#include "symbol.hpp"  // Symbol, SymbolMap
 
+#include <cstdint>       // std::uint64_t
 #include <memory>        // std::shared_ptr
 #include <string>        // std::string
 #include <string_view>   // std::string_view
@@ -11,9 +13,16 @@
 #include <variant>       // std::variant
 #include <vector>        // std::vector
 
+class CompiledScript;
+
 struct Environment final {
 	struct Variable final {
-		std::string value;
+		std::string value; // Left empty until text() is called if the variable was assigned a scalar.
+		cmd::Scalar scalar{};
+
+		// Get the text of the variable, formatting the scalar if that hasn't been done yet.
+		auto text() -> std::string&;
+		[[nodiscard]] auto text() const -> std::string;
 	};
 
 	struct Constant final {
@@ -22,14 +31,14 @@ struct Environment final {
 
 	struct Function final {
 		std::vector<std::string> parameters;
-		Script body;
+		std::shared_ptr<const CompiledScript> body; // Compiled once when the function is defined and shared by every call.
 	};
 
 	using Array = std::vector<std::string>;
 	using Table = std::unordered_map<std::string, std::string>;
 	using Object = std::variant<Variable, Constant, Function, Array, Table>;
-	using ObjectMap = std::unordered_map<std::string, Object>;
-	using AliasMap = std::unordered_map<std::string, Script::Command>;
+	using ObjectMap = SymbolMap<Object>;
+	using AliasMap = SymbolMap<Script::Command>;
 
 	static auto arrayString(const Array& arr) -> std::string;
 	static auto tableString(const Table& table) -> std::string;
@@ -43,7 +52,11 @@ struct Environment final {
 
 	auto reset() noexcept -> void;
 
+	// Give a reset environment a new parent and identity, so that it can be used as if it had just been created.
+	auto reuse(std::shared_ptr<Environment> newParent) noexcept -> void;
+
 	std::shared_ptr<Environment> parent{};
+	std::uint64_t id; // Unique for every environment created during the program, unlike its address.
 	ObjectMap objects{};
 	AliasMap aliases{};
 };
@@ -10,11 +10,17 @@ auto IOBuffer::isDone() const noexcept -> bool {
 	return m_done;
 }
 
+auto IOBuffer::getRevision() const noexcept -> std::uint64_t {
+	return m_revision;
+}
+
 auto IOBuffer::setDone(bool done) noexcept -> void {
+	++m_revision;
 	m_done = done;
 }
 
 auto IOBuffer::write(std::string_view str) -> void {
+	++m_revision;
 	if (m_str) {
 		m_str->append(str);
 	} else {
@@ -23,6 +29,7 @@ auto IOBuffer::write(std::string_view str) -> void {
 }
 
 auto IOBuffer::writeln(std::string_view str) -> void {
+	++m_revision;
 	if (m_str) {
 		m_str->push_back('\n');
 		m_str->append(str);
@@ -1,6 +1,7 @@
 #ifndef AF2_CONSOLE_IO_BUFFER_HPP
 #define AF2_CONSOLE_IO_BUFFER_HPP
 
+#include <cstdint>     // std::uint64_t
 #include <optional>    // std::optional, std::nullopt
 #include <string>      // std::string
 #include <string_view> // std::string_view
@@ -10,6 +11,9 @@ public:
 	[[nodiscard]] auto canRead() const noexcept -> bool;
 	[[nodiscard]] auto isDone() const noexcept -> bool;
 
+	// Get a number that changes every time the buffer is written to or marked as done.
+	[[nodiscard]] auto getRevision() const noexcept -> std::uint64_t;
+
 	auto setDone(bool done) noexcept -> void;
 
 	auto write(std::string_view str) -> void;
@@ -20,6 +24,7 @@ public:
 
 private:
 	std::optional<std::string> m_str{};
+	std::uint64_t m_revision = 0;
 	bool m_done = true;
 };
 
@@ -18,8 +18,10 @@
 
 #include <algorithm>  // std::minmax
 #include <cassert>    // assert
+#include <cstdint>    // std::uint64_t
 #include <fmt/core.h> // fmt::format
-#include <variant>    // std::holds_alternative
+#include <iterator>   // std::make_move_iterator
+#include <variant>    // std::holds_alternative, std::get_if
 
 namespace {
 
@@ -90,24 +92,56 @@ auto Process::getProgress() const -> float {
 	auto total = std::size_t{0};
 	auto done = std::size_t{0};
 	for (const auto& frame : m_callStack) {
-		total += frame.commands.size();
+		total += frame.script->size();
 		done += std::min(frame.programCounter, total);
 	}
 	return (total == 0) ? 1.0f : static_cast<float>(done) / static_cast<float>(total);
 }
 
+auto Process::getWaitState() const noexcept -> WaitState {
+	return m_waitState;
+}
+
+auto Process::getCpuTime() const noexcept -> std::chrono::microseconds {
+	return m_cpuTime;
+}
+
+auto Process::getLastCpuTime() const noexcept -> std::chrono::microseconds {
+	return m_lastCpuTime;
+}
+
+auto Process::getThrottleCount() const noexcept -> std::size_t {
+	return m_throttleCount;
+}
+
+auto Process::blocked(float currentTime) const noexcept -> bool {
+	if (!m_children.empty()) {
+		return false; // Children are run by their parent.
+	}
+	switch (m_waitState) {
+		case WaitState::READY: return false;
+		case WaitState::SLEEPING: return currentTime < m_wakeTime;
+		case WaitState::INPUT: return m_input->getRevision() == m_inputRevision;
+	}
+	return false;
+}
+
 auto Process::defined(const std::shared_ptr<Environment>& env, const std::string& name) const -> bool { // NOLINT(readability-convert-member-functions-to-static)
-	if (ConCommand::find(name)) {
-		return true;
+	const auto* const symbol = Symbol::find(name);
+	if (!symbol) {
+		return false;
 	}
-	if (ConVar::find(name)) {
+	if (symbol->command || symbol->cvar) {
 		return true;
 	}
+	if (symbol->definitions == 0) {
+		return false;
+	}
 	for (auto* pEnv = env.get(); pEnv != nullptr; pEnv = pEnv->parent.get()) {
-		if (pEnv->objects.count(name) != 0) {
+		if (pEnv->objects.count(*symbol) != 0) {
 			return true;
 		}
-		if (pEnv->aliases.count(name) != 0) {
+		if (pEnv->aliases.count(*symbol) != 0) {
 			return true;
 		}
 	}
@@ -118,22 +152,26 @@ auto Process::findObject(const std::shared_ptr<Environment>& env, const std::str
 	-> Environment::Object* {
 	auto aliasDepth = std::size_t{0};
 
-	const auto* pName = &name;
+	const auto* symbol = Symbol::find(name);
 	do {
+		if (!symbol || symbol->definitions == 0) {
+			return nullptr;
+		}
+
 		for (auto* pEnv = env.get();; pEnv = pEnv->parent.get()) {
 			if (!pEnv) {
 				return nullptr;
 			}
 
-			if (const auto it = pEnv->aliases.find(*pName); it != pEnv->aliases.end()) {
+			if (const auto it = pEnv->aliases.find(*symbol); it != pEnv->aliases.end()) {
 				if (const auto& cmd = it->second; cmd.size() == 1) {
-					pName = &cmd.front().value;
+					symbol = Symbol::find(cmd.front().value);
 					++aliasDepth;
 					break;
 				}
 			}
 
-			if (const auto it = pEnv->objects.find(*pName); it != pEnv->objects.end()) {
+			if (const auto it = pEnv->objects.find(*symbol); it != pEnv->objects.end()) {
 				return &it->second;
 			}
 		}
@@ -142,25 +180,39 @@ auto Process::findObject(const std::shared_ptr<Environment>& env, const std::str
 }
 
 auto Process::format(float currentTime) const -> std::string {
+	static constexpr auto formatWaitState = [](WaitState waitState) -> std::string_view {
+		switch (waitState) {
+			case WaitState::READY: return "ready";
+			case WaitState::SLEEPING: return "sleeping";
+			case WaitState::INPUT: return "waiting for input";
+		}
+		return "unknown";
+	};
+
 	return fmt::format(
-		"#{} ({:g}%) {}s:\n"
+		"#{} ({:g}%) {}s, {}, CPU {:.3f} ms (last {} us, throttled {} times):\n"
 		"{}",
 		static_cast<int>(m_id),
 		this->getProgress() * 100.0f,
 		static_cast<unsigned>(currentTime - m_startTime),
+		formatWaitState(m_waitState),
+		std::chrono::duration<double, std::milli>{m_cpuTime}.count(),
+		m_lastCpuTime.count(),
+		m_throttleCount,
 		m_callStack | util::transform([](const CallFrame& frame) {
-			static constexpr auto formatCommand = [](const Script::Command& command) {
-				if (command.empty()) {
+			static constexpr auto formatCommand = [](const CompiledScript::Command& command) {
+				const auto& arguments = command.arguments;
+				if (arguments.empty()) {
 					return std::string{};
 				}
-				if (command.size() == 1) {
-					return command.front().value;
+				if (arguments.size() == 1) {
+					return arguments.front().value;
 				}
-				return fmt::format("{}({})", command.front().value, util::subview(command, 1) | util::transform(Script::argumentString) | util::join(", "));
+				return fmt::format("{}({})", arguments.front().value, util::subview(arguments, 1) | util::transform(Script::argumentString) | util::join(", "));
 			};
 
-			return fmt::format((frame.commands.size() <= 2) ? "  {}" : "  {}...",
-		                       frame.commands | util::take(2) | util::transform(formatCommand) | util::join("; "));
+			return fmt::format((frame.script->size() <= 2) ? "  {}" : "  {}...",
+		                       *frame.script | util::take(2) | util::transform(formatCommand) | util::join("; "));
 		}) | util::join('\n'));
 }
 
@@ -233,7 +285,7 @@ auto Process::end() noexcept -> void {
 	DEBUG_MSG(Msg::CONSOLE_DETAILED, "Process {} ended.", this->getId());
 
 	for (auto& frame : m_callStack) {
-		frame.programCounter = frame.commands.size();
+		frame.programCounter = frame.script->size();
 	}
 
 	if (m_output) {
@@ -244,53 +296,104 @@ auto Process::end() noexcept -> void {
 	}
 
 	m_children.clear();
+	m_waitState = WaitState::READY;
+}
+
+auto Process::sleepUntil(float time) noexcept -> void {
+	m_waitState = WaitState::SLEEPING;
+	m_wakeTime = time;
+}
+
+auto Process::waitForInput() noexcept -> void {
+	m_waitState = WaitState::INPUT;
+	m_inputRevision = m_input->getRevision();
+}
+
+auto Process::runFor(std::chrono::microseconds budget, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer,
+                     MetaClient* metaClient) -> cmd::Result {
+	auto guard = util::ScopeGuard{[this] {
+		m_deadline.reset();
+	}};
+
+	if (budget.count() > 0) {
+		m_deadline = Clock::now() + budget;
+	}
+	return this->run(game, server, client, metaServer, metaClient);
 }
 
 auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient, std::size_t targetFrameIndex)
 	-> cmd::Result {
 	auto result = cmd::done();
-	auto guard = util::ScopeGuard{[this] {
-		m_running = false;
+	const auto outermost = !m_running; // Time spent in nested runs is already counted by the outermost one.
+	auto guard = util::ScopeGuard{[this, outermost] {
+		m_running = !outermost;
 	}};
 
 	m_running = true;
 
 	DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED, "Process {} running...", this->getId()) {
+		const auto blocked = this->blocked(m_vm->getTime());
+		if (blocked) {
+			DEBUG_MSG(Msg::CONSOLE_DETAILED, "Process {} is blocked.", this->getId());
+			result = cmd::Result{cmd::Status::DEFER_TO_NEXT_FRAME, cmd::Value{}};
+		} else {
+			m_waitState = WaitState::READY;
+		}
+
+		const auto startTime = Clock::now();
 		auto iteration = 0;
-		while (m_callStack.size() > targetFrameIndex) {
+		while (!blocked && m_callStack.size() > targetFrameIndex) {
 			if (m_callStack.back().executing) {
 				break;
 			}
 
-			if (m_callStack.back().programCounter >= m_callStack.back().commands.size()) {
-				m_callStack.pop_back();
+			if (m_callStack.back().programCounter >= m_callStack.back().script->size()) {
+				this->popFrame();
 				continue;
 			}
 
 			const auto frameIndex = m_callStack.size() - 1;
 			auto frame = util::Reference{m_callStack[frameIndex]};
-			const auto& command = frame->commands[frame->programCounter];
-			auto& commandState = frame->commandStates[frame->programCounter];
+			const auto& command = (*frame->script)[frame->programCounter];
+			auto& commandState = this->commandState(*frame, frame->programCounter);
 
 			if (await_limit > 0 && iteration > await_limit) {
 				result = cmd::deferToNextFrame(commandState.progress);
 				break;
 			}
 
+			if (outermost && m_deadline && iteration > 0 && iteration % DEADLINE_CHECK_INTERVAL == 0 && Clock::now() >= *m_deadline) {
+				DEBUG_MSG(Msg::CONSOLE_DETAILED, "Process {} ran out of time.", this->getId());
+				++m_throttleCount;
+				result = cmd::deferToNextFrame(commandState.progress);
+				break;
+			}
+
 			++iteration;
-			if ((command.back().flags & Script::Argument::PIPE) != 0) {
+			if (command.pipe) {
 				this->setupPipeline(result, frame);
 				frame = m_callStack[frameIndex];
 			} else if (!commandState.argsExpanded) {
+				const auto stackSize = m_callStack.size();
 				if (this->expandArgs(frameIndex)) {
+					if (m_vm->profiler().enabled()) {
+						this->labelFrames(stackSize, command.symbol);
+					}
 					continue; // Don't update status.
 				}
 
 				frame = m_callStack[frameIndex];
-				result = cmd::error("{}: Stack overflow.", frame->commands[frame->programCounter].front().value);
-			} else if (commandState.arguments.front().value.empty()) {
+				result = cmd::error("{}: Stack overflow.", (*frame->script)[frame->programCounter].arguments.front().value);
+			} else if (commandState.arguments.front().text().empty()) {
 				result = cmd::error("Empty command name.");
 			} else {
+				const auto profiling = m_vm->profiler().enabled();
+				auto symbol = SymbolRef{};
+				if (profiling) {
+					symbol = (command.symbol) ? command.symbol : SymbolRef{Symbol::get(commandState.arguments.front().value)};
+				}
+				const auto stackSize = m_callStack.size();
+				const auto executeTime = (profiling) ? Clock::now() : Clock::time_point{};
 				frame->executing = true;
 				DEBUG_MSG_INDENT(
 					Msg::CONSOLE_DETAILED,
@@ -301,9 +404,22 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 						commandState.arguments.front().value :
                         fmt::format("{} {}",
 				                    commandState.arguments.front().value,
-				                    util::subview(commandState.arguments, 1) | util::transform([](const auto& arg) { return arg.value; }) |
+				                    util::subview(commandState.arguments, 1) | util::transform([](auto& arg) { return arg.text(); }) |
 				                        util::transform(Script::escapedString) | util::join(' '))) {
-					if (!this->checkAliases(result, frame->env, commandState.arguments, frame->returnFrameIndex, frame->returnArgumentIndex) &&
+					if (!this->checkBinding(result,
+					                        command,
+					                        frame->env,
+					                        commandState.arguments,
+					                        commandState.data,
+					                        frameIndex,
+					                        frame->returnFrameIndex,
+					                        frame->returnArgumentIndex,
+					                        game,
+					                        server,
+					                        client,
+					                        metaServer,
+					                        metaClient) &&
+					    !this->checkAliases(result, frame->env, commandState.arguments, frame->returnFrameIndex, frame->returnArgumentIndex) &&
 					    !this->checkObjects(result, frame->env, commandState.arguments, frame->returnFrameIndex, frame->returnArgumentIndex) &&
 					    !this->checkGlobals(result, commandState.arguments, commandState.data, frameIndex, game, server, client, metaServer, metaClient)) {
 						if (client) {
@@ -335,6 +451,10 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 						}
 					}
 
+					if (profiling) {
+						this->profile(frameIndex, symbol, stackSize, Clock::now() - executeTime);
+					}
+
 					if (frameIndex < m_callStack.size()) {
 						frame = m_callStack[frameIndex];
 						frame->executing = false;
@@ -348,7 +468,7 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 			frame->status = result.status;
 			if (frame->returnFrameIndex != NO_FRAME) {
 				auto& retFrame = m_callStack[frame->returnFrameIndex];
-				auto& arguments = retFrame.commandStates[retFrame.programCounter].arguments;
+				auto& arguments = this->commandState(retFrame, retFrame.programCounter).arguments;
 				if (frame->returnArgumentIndex < arguments.size()) {
 					arguments[frame->returnArgumentIndex] = result;
 				}
@@ -361,16 +481,16 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 				case cmd::Status::CONTINUE:
 					while (m_callStack.size() > targetFrameIndex) {
 						if (m_callStack.back().firstInSection) {
-							m_callStack.pop_back();
+							this->popFrame();
 							break;
 						}
-						m_callStack.pop_back();
+						this->popFrame();
 					}
 					continue;
 				case cmd::Status::NOT_DONE: [[fallthrough]];
 				case cmd::Status::DEFER_TO_NEXT_FRAME:
-					if (frame->programCounter < frame->commandStates.size()) {
-						auto& state = frame->commandStates[frame->programCounter];
+					if (frame->programCounter < frame->script->size()) {
+						auto& state = this->commandState(*frame, frame->programCounter);
 						auto& progress = state.progress;
 						const auto newProgress = util::stringTo<cmd::Progress>(result.value);
 						assert(newProgress);
@@ -387,8 +507,8 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 					}
 					break;
 				default:
-					if (frame->programCounter < frame->commandStates.size()) {
-						auto& state = frame->commandStates[frame->programCounter];
+					if (frame->programCounter < frame->script->size()) {
+						auto& state = this->commandState(*frame, frame->programCounter);
 						state.data.reset();
 						state.arguments.clear();
 						++frame->programCounter;
@@ -401,11 +521,17 @@ auto Process::run(Game& game, GameServer* server, GameClient* client, MetaServer
 			}
 		}
 
+		if (outermost && !blocked) {
+			m_lastCpuTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime);
+			m_cpuTime += m_lastCpuTime;
+		}
+
 		DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED, "Running child processes of process {}...", this->getId()) {
 			m_vm->runProcesses(m_children, game, server, client, metaServer, metaClient);
 		}
 	}
 	DEBUG_MSG(Msg::CONSOLE_DETAILED, "Process {} {}.", this->getId(), (this->done()) ? "done" : "not done");
+	result.text(); // Callers outside of the process only look at the text.
 	return result;
 }
 
@@ -440,7 +566,7 @@ auto Process::awaitLimited(Game& game, GameServer* server, GameClient* client, M
 
 auto Process::call(std::shared_ptr<Environment> env, std::string_view script, std::size_t returnFrameIndex, std::size_t returnArgumentIndex,
                    const std::shared_ptr<Environment>& exportTarget) -> std::optional<CallFrameHandle> {
-	return this->call(std::move(env), Script::parse(script), returnFrameIndex, returnArgumentIndex, exportTarget);
+	return this->call(std::move(env), CompiledScript::compile(script), returnFrameIndex, returnArgumentIndex, exportTarget);
 }
 
 auto Process::call(std::shared_ptr<Environment> env, cmd::CommandView argv, std::size_t returnFrameIndex, std::size_t returnArgumentIndex,
@@ -460,20 +586,33 @@ auto Process::call(std::shared_ptr<Environment> env, Script::Command command, st
 
 auto Process::call(std::shared_ptr<Environment> env, Script commands, std::size_t returnFrameIndex, std::size_t returnArgumentIndex,
                    const std::shared_ptr<Environment>& exportTarget) -> std::optional<CallFrameHandle> {
+	return this->call(std::move(env), CompiledScript::compile(std::move(commands)), returnFrameIndex, returnArgumentIndex, exportTarget);
+}
+
+auto Process::call(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script, std::size_t returnFrameIndex,
+                   std::size_t returnArgumentIndex, const std::shared_ptr<Environment>& exportTarget) -> std::optional<CallFrameHandle> {
+	assert(script);
 	const auto frameIndex = m_callStack.size();
 	assert(returnFrameIndex == NO_FRAME || returnFrameIndex < frameIndex);
 	DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED,
 	                 "Process {} called {}.",
 	                 this->getId(),
-	                 (commands.empty())    ? "no commands" :
-	                 (commands.size() > 1) ? "several commands" :
-                                             commands.front().front().value) {
+	                 (script->empty())    ? "no commands" :
+	                 (script->size() > 1) ? "several commands" :
+                                            script->front().arguments.front().value) {
 		if (frameIndex == Process::MAX_STACK_SIZE) {
 			DEBUG_MSG(Msg::CONSOLE_DETAILED, "Stack overflow!");
 			return std::nullopt;
 		}
 
-		m_callStack.emplace_back(std::move(env), std::move(commands), returnFrameIndex, returnArgumentIndex, exportTarget);
+		const auto firstCommandState = m_commandStateCount;
+		m_commandStateCount += script->size();
+		if (m_commandStates.size() < m_commandStateCount) {
+			m_commandStates.resize(m_commandStateCount); // Never invalidates references to the states of the frames below.
+		}
+
+		m_callStack.emplace_back(std::move(env), std::move(script), firstCommandState, returnFrameIndex, returnArgumentIndex, exportTarget);
+		m_waitState = WaitState::READY; // The new frame has not been run yet.
 	}
 	return CallFrameHandle{this->shared_from_this(), frameIndex};
 }
@@ -485,7 +624,17 @@ auto Process::call(std::shared_ptr<Environment> env, const Environment::Function
 
 auto Process::call(std::shared_ptr<Environment> env, const Environment::Function& function, util::Span<const cmd::Value> args, std::size_t returnFrameIndex,
                    std::size_t returnArgumentIndex, const std::shared_ptr<Environment>& exportTarget) -> std::optional<CallFrameHandle> {
-	auto frame = this->call(std::make_shared<Environment>(std::move(env)), function.body, returnFrameIndex, returnArgumentIndex, exportTarget);
+	auto arguments = cmd::CommandArguments{};
+	arguments.reserve(args.size());
+	for (const auto& arg : args) {
+		arguments.push_back(cmd::done(arg));
+	}
+	return this->call(std::move(env), function, std::move(arguments), returnFrameIndex, returnArgumentIndex, exportTarget);
+}
+
+auto Process::call(std::shared_ptr<Environment> env, const Environment::Function& function, cmd::CommandArguments args, std::size_t returnFrameIndex,
+                   std::size_t returnArgumentIndex, const std::shared_ptr<Environment>& exportTarget) -> std::optional<CallFrameHandle> {
+	auto frame = this->call(this->makeEnvironment(std::move(env)), function.body, returnFrameIndex, returnArgumentIndex, exportTarget);
 	if (frame) {
 		frame->makeSection();
 		if (args.empty()) {
@@ -496,19 +645,19 @@ auto Process::call(std::shared_ptr<Environment> env, const Environment::Function
 				if (i < function.parameters.size()) {
 					const auto& param = function.parameters[i];
 					if (param == "...") {
-						frame->env()->objects["@"] = Environment::Array{args[i]};
+						frame->env()->objects["@"] = Environment::Array{std::move(args[i].text())};
 					} else {
-						frame->env()->objects[param] = Environment::Variable{args[i]};
+						frame->env()->objects[param] = Environment::Variable{std::move(args[i].value), args[i].scalar};
 					}
 				} else {
 					auto& obj = frame->env()->objects.try_emplace("@", Environment::Array{}).first->second;
 					if (auto* const arr = std::get_if<Environment::Array>(&obj)) {
-						arr->push_back(args[i]);
+						arr->push_back(std::move(args[i].text()));
 					} else {
 						assert(std::holds_alternative<Environment::Variable>(obj));
-						auto value = std::move(std::get_if<Environment::Variable>(&obj)->value);
+						auto value = std::move(std::get_if<Environment::Variable>(&obj)->text());
 
-						obj = Environment::Array{std::move(value), args[i]};
+						obj = Environment::Array{std::move(value), std::move(args[i].text())};
 					}
 				}
 			}
@@ -562,16 +711,75 @@ auto operator!=(const Process& lhs, const Process& rhs) noexcept -> bool {
 	return !(lhs == rhs);
 }
 
+auto Process::commandState(const CallFrame& frame, std::size_t i) noexcept -> CommandState& {
+	assert(i < frame.script->size());
+	assert(frame.firstCommandState + i < m_commandStateCount);
+	return m_commandStates[frame.firstCommandState + i];
+}
+
+auto Process::makeEnvironment(std::shared_ptr<Environment> parent) -> std::shared_ptr<Environment> {
+	if (m_environmentPool.empty()) {
+		return std::make_shared<Environment>(std::move(parent));
+	}
+	auto env = std::move(m_environmentPool.back());
+	m_environmentPool.pop_back();
+	env->reuse(std::move(parent));
+	return env;
+}
+
+auto Process::popFrame() -> void {
+	assert(!m_callStack.empty());
+	auto& frame = m_callStack.back();
+	for (auto i = frame.firstCommandState; i < m_commandStateCount; ++i) {
+		auto& state = m_commandStates[i];
+		state.arguments.clear();
+		state.progress = 0;
+		state.data.reset();
+		state.argsExpanded = false;
+	}
+	m_commandStateCount = frame.firstCommandState;
+
+	// Keep the local environment for a later call if nothing else refers to it.
+	if (frame.env.use_count() == 1 && m_environmentPool.size() < MAX_ENVIRONMENT_POOL_SIZE) {
+		frame.env->reset();
+		frame.env->parent.reset();
+		m_environmentPool.push_back(std::move(frame.env));
+	}
+	m_callStack.pop_back();
+}
+
+auto Process::labelFrames(std::size_t stackSize, const SymbolRef& label) noexcept -> void {
+	for (auto i = stackSize; i < m_callStack.size(); ++i) {
+		m_callStack[i].label = label;
+	}
+}
+
+auto Process::profile(std::size_t frameIndex, const SymbolRef& symbol, std::size_t stackSize, Clock::duration time) -> void {
+	auto& stack = m_profileStack;
+	stack.clear();
+	for (auto i = std::size_t{0}; i <= frameIndex && i < m_callStack.size(); ++i) {
+		if (const auto& label = m_callStack[i].label) {
+			stack.append(label->name);
+			stack.push_back(';');
+		}
+	}
+	stack.append(symbol->name);
+
+	const auto frames = (m_callStack.size() > stackSize) ? m_callStack.size() - stackSize : std::size_t{0};
+	m_vm->profiler().record(stack, std::chrono::duration_cast<std::chrono::nanoseconds>(time), frames);
+	this->labelFrames(stackSize, symbol);
+}
+
 auto Process::handleError(cmd::Result error) -> bool {
 	DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED, "Unwinding stack.") {
 		while (!m_callStack.empty()) {
 			if (m_callStack.back().firstInTryBlock) {
-				m_callStack.pop_back();
+				this->popFrame();
 				DEBUG_MSG(Msg::CONSOLE_DETAILED, "Reached beginning of try block. {} stack frames left.", m_callStack.size());
 				m_latestError = std::move(error.value);
 				return true;
 			}
-			m_callStack.pop_back();
+			this->popFrame();
 		}
 	}
 
@@ -592,11 +800,11 @@ auto Process::handleError(cmd::Result error) -> bool {
 auto Process::setupPipeline(cmd::Result& result, CallFrame& frame) -> void {
 	DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED, "Pipeline setting up...") {
 		auto parent = std::shared_ptr<Process>{};
-		for (const auto& command : util::subview(frame.commands, frame.programCounter)) {
-			assert(!command.empty());
+		for (const auto& command : util::subview(*frame.script, frame.programCounter)) {
+			assert(!command.arguments.empty());
 			++frame.programCounter;
 			if (auto process = (parent) ? parent->launchChildProcess(this->getUserFlags()) : this->launchChildProcess(this->getUserFlags())) {
-				auto cmd = command;
+				auto cmd = command.arguments;
 				cmd.back().flags &= ~Script::Argument::PIPE;
 				if (!process->call(frame.env, std::move(cmd))) {
 					result = cmd::error("Failed to setup pipe: Stack overflow.");
@@ -614,7 +822,7 @@ auto Process::setupPipeline(cmd::Result& result, CallFrame& frame) -> void {
 				return;
 			}
 
-			if ((command.back().flags & Script::Argument::PIPE) == 0) {
+			if (!command.pipe) {
 				break;
 			}
 		}
@@ -624,7 +832,36 @@ auto Process::setupPipeline(cmd::Result& result, CallFrame& frame) -> void {
 
 auto Process::expandArgs(std::size_t frameIndex) -> bool {
 	const auto iPc = m_callStack[frameIndex].programCounter;
-	auto command = m_callStack[frameIndex].commands[iPc];
+	const auto script = m_callStack[frameIndex].script; // Keep the script alive in case the frame is popped by a call below.
+	const auto& compiledCommand = (*script)[iPc];
+	if (!compiledCommand.expand) {
+		// Nothing to expand, so the arguments can be read straight from the shared script, and every EXEC argument already has a compiled script.
+		const auto& command = compiledCommand.arguments;
+		auto& arguments = this->commandState(m_callStack[frameIndex], iPc).arguments;
+		arguments.clear();
+		arguments.reserve(command.size());
+		for (const auto& arg : command) {
+			if ((arg.flags & Script::Argument::EXEC) != 0) {
+				arguments.push_back(cmd::done());
+			} else {
+				arguments.push_back(cmd::done(arg.value));
+			}
+		}
+
+		for (auto returnArgumentIndex = command.size(); returnArgumentIndex-- > 0;) {
+			if (const auto& retArg = command[returnArgumentIndex]; (retArg.flags & Script::Argument::EXEC) != 0) {
+				DEBUG_MSG_INDENT(Msg::CONSOLE_DETAILED, "Expanding process {} stack[{}][{}].", this->getId(), frameIndex, returnArgumentIndex) {
+					if (!this->call(m_callStack[frameIndex].env, compiledCommand.subScripts[returnArgumentIndex], frameIndex, returnArgumentIndex)) {
+						return false;
+					}
+				}
+			}
+		}
+		this->commandState(m_callStack[frameIndex], iPc).argsExpanded = true;
+		return true;
+	}
+
+	auto command = compiledCommand.arguments;
 	for (auto i = std::size_t{0}; i < command.size();) {
 		if ((command[i].flags & Script::Argument::EXPAND) != 0) {
 			if (auto* const obj = this->findObject(m_callStack[frameIndex].env, command[i].value)) {
@@ -648,7 +885,7 @@ auto Process::expandArgs(std::size_t frameIndex) -> bool {
 		++i;
 	}
 
-	auto& arguments = m_callStack[frameIndex].commandStates[iPc].arguments;
+	auto& arguments = this->commandState(m_callStack[frameIndex], iPc).arguments;
 	arguments.clear();
 	arguments.reserve(command.size());
 	for (auto& arg : command) {
@@ -668,20 +905,98 @@ auto Process::expandArgs(std::size_t frameIndex) -> bool {
 			}
 		}
 	}
-	m_callStack[frameIndex].commandStates[iPc].argsExpanded = true;
+	this->commandState(m_callStack[frameIndex], iPc).argsExpanded = true;
 	return true;
 }
 
+auto Process::bind(const CompiledScript::Command& command, const std::shared_ptr<Environment>& env) -> const CompiledScript::Binding::Target& {
+	assert(command.symbol);
+	const auto& symbol = *command.symbol;
+	auto& binding = command.binding;
+	const auto envId = (env) ? env->id : std::uint64_t{0};
+	if (binding.version == symbol.version) {
+		// Nothing with this name has been defined or removed since the binding was made.
+		if (binding.envId == envId || symbol.definitions == 0) {
+			return binding.target;
+		}
+		if (symbol.definitions == 1 && binding.ownerId != 0) {
+			// The only definition is still where it was found, so it is the one we get if we can reach it the same way.
+			auto* pEnv = env.get();
+			for (auto i = std::size_t{0}; pEnv && i < binding.depth; ++i) {
+				pEnv = pEnv->parent.get();
+			}
+			if (pEnv && pEnv->id == binding.ownerId) {
+				return binding.target;
+			}
+		}
+	}
+
+	binding = CompiledScript::Binding{};
+	binding.version = symbol.version;
+	binding.envId = envId;
+	auto depth = std::size_t{0};
+	for (auto* pEnv = env.get(); pEnv != nullptr; pEnv = pEnv->parent.get(), ++depth) {
+		if (pEnv->aliases.count(symbol) != 0) {
+			binding.ownerId = pEnv->id;
+			binding.depth = depth;
+			return binding.target;
+		}
+	}
+	depth = 0;
+	for (auto* pEnv = env.get(); pEnv != nullptr; pEnv = pEnv->parent.get(), ++depth) {
+		if (const auto it = pEnv->objects.find(symbol); it != pEnv->objects.end()) {
+			binding.target = &it->second;
+			binding.ownerId = pEnv->id;
+			binding.depth = depth;
+			return binding.target;
+		}
+	}
+	if (symbol.command) {
+		binding.target = symbol.command;
+	} else if (symbol.cvar) {
+		binding.target = symbol.cvar;
+	}
+	return binding.target;
+}
+
+auto Process::checkBinding(cmd::Result& result, const CompiledScript::Command& command, const std::shared_ptr<Environment>& env,
+                           cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, std::size_t returnFrameIndex,
+                           std::size_t returnArgumentIndex, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer,
+                           MetaClient* metaClient) -> bool {
+	if (!command.symbol) {
+		return false;
+	}
+
+	const auto& target = this->bind(command, env);
+	if (auto* const obj = std::get_if<Environment::Object*>(&target)) {
+		result = this->callObject(env, **obj, arguments, returnFrameIndex, returnArgumentIndex);
+		return true;
+	}
+	if (auto* const cmd = std::get_if<ConCommand*>(&target)) {
+		result = this->callCommand(**cmd, arguments, data, frameIndex, game, server, client, metaServer, metaClient);
+		return true;
+	}
+	if (auto* const cvar = std::get_if<ConVar*>(&target)) {
+		result = this->callCvar(**cvar, arguments, game, server, client, metaServer, metaClient);
+		return true;
+	}
+	return false; // Aliases and input actions take the slow path.
+}
+
 auto Process::checkAliases(cmd::Result& result, const std::shared_ptr<Environment>& env, cmd::CommandArguments& arguments,
                            std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> bool {
 	assert(!arguments.empty());
+	const auto* const symbol = Symbol::find(arguments.front().value);
+	if (!symbol || symbol->definitions == 0) {
+		return false;
+	}
 	for (auto* pEnv = env.get(); pEnv != nullptr; pEnv = pEnv->parent.get()) {
-		if (const auto it = pEnv->aliases.find(arguments.front().value); it != pEnv->aliases.end()) {
+		if (const auto it = pEnv->aliases.find(*symbol); it != pEnv->aliases.end()) {
 			auto cmd = it->second;
 			assert(!cmd.empty());
 			cmd.reserve(cmd.size() + arguments.size() - 1);
 			for (auto& argument : util::subview(arguments, 1)) {
-				cmd.emplace_back(std::move(argument.value));
+				cmd.emplace_back(std::move(argument.text()));
 			}
 
 			if (this->call(env, std::move(cmd), returnFrameIndex, returnArgumentIndex)) {
@@ -698,165 +1013,121 @@ auto Process::checkAliases(cmd::Result& result, const std::shared_ptr<Environmen
 auto Process::checkObjects(cmd::Result& result, const std::shared_ptr<Environment>& env, cmd::CommandArguments& arguments,
                            std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> bool {
 	assert(!arguments.empty());
+	const auto* const symbol = Symbol::find(arguments.front().value);
+	if (!symbol || symbol->definitions == 0) {
+		return false;
+	}
 	for (auto* pEnv = env.get(); pEnv != nullptr; pEnv = pEnv->parent.get()) {
-		if (const auto it = pEnv->objects.find(arguments.front().value); it != pEnv->objects.end()) {
-			result = util::match(it->second)(
-				[&](Environment::Variable& var) {
-					if (arguments.size() == 1) {
-						return cmd::done(var.value);
-					}
-					if (arguments.size() == 2) {
-						var.value = std::move(arguments[1].value);
-						return cmd::done();
-					}
-					return cmd::error("Usage: {0} or {0} <value>", arguments.front().value);
-				},
-				[&](Environment::Constant& constant) {
-					if (arguments.size() == 1) {
-						return cmd::done(constant.value);
-					}
-					return cmd::error("Usage: {0}", arguments.front().value);
-				},
-				[&](Environment::Function& function) {
-					if (arguments.size() == function.parameters.size() + 1 ||
-				        (!function.parameters.empty() && arguments.size() >= function.parameters.size() && function.parameters.back() == "...")) {
-						auto args = std::vector<cmd::Value>{};
-						args.reserve(arguments.size() - 1);
-						for (auto& argument : util::subview(arguments, 1)) {
-							args.emplace_back(std::move(argument.value));
-						}
-						if (!this->call(env, function, args, returnFrameIndex, returnArgumentIndex)) {
-							return cmd::error("{}: Stack overflow.", arguments.front().value);
-						}
-						return cmd::done();
-					}
-					return cmd::error("Usage: {} {}", arguments.front().value, function.parameters | util::transform([](const auto& param) {
-																				   return fmt::format("<{}>", param);
-																			   }) | util::join(' '));
-				},
-				[&](Environment::Array& arr) {
-					if (arguments.size() == 1) {
-						return cmd::done(Environment::arrayString(arr));
-					}
-					if (arguments.size() == 2) {
-						auto parseError = cmd::ParseError{};
+		if (const auto it = pEnv->objects.find(*symbol); it != pEnv->objects.end()) {
+			result = this->callObject(env, it->second, arguments, returnFrameIndex, returnArgumentIndex);
+			return true;
+		}
+	}
+	return false;
+}
 
-						auto index = cmd::parseNumber<int>(parseError, arguments[1].value, "array index");
-						if (parseError) {
-							return cmd::error("{}: {}", arguments.front().value, *parseError);
-						}
+auto Process::callObject(const std::shared_ptr<Environment>& env, Environment::Object& object, cmd::CommandArguments& arguments,
+                         std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> cmd::Result {
+	assert(!arguments.empty());
+	return util::match(object)(
+		[&](Environment::Variable& var) {
+			if (arguments.size() == 1) {
+				return cmd::Result{cmd::Status::VALUE, var.value, var.scalar};
+			}
+			if (arguments.size() == 2) {
+				var.value = std::move(arguments[1].value);
+				var.scalar = arguments[1].scalar;
+				return cmd::done();
+			}
+			return cmd::error("Usage: {0} or {0} <value>", arguments.front().value);
+		},
+		[&](Environment::Constant& constant) {
+			if (arguments.size() == 1) {
+				return cmd::done(constant.value);
+			}
+			return cmd::error("Usage: {0}", arguments.front().value);
+		},
+		[&](Environment::Function& function) {
+			if (arguments.size() == function.parameters.size() + 1 ||
+		        (!function.parameters.empty() && arguments.size() >= function.parameters.size() && function.parameters.back() == "...")) {
+				auto args = cmd::CommandArguments{std::make_move_iterator(arguments.begin() + 1), std::make_move_iterator(arguments.end())};
+				if (!this->call(env, function, std::move(args), returnFrameIndex, returnArgumentIndex)) {
+					return cmd::error("{}: Stack overflow.", arguments.front().value);
+				}
+				return cmd::done();
+			}
+			return cmd::error("Usage: {} {}", arguments.front().value, function.parameters | util::transform([](const auto& param) {
+																		   return fmt::format("<{}>", param);
+																	   }) | util::join(' '));
+		},
+		[&](Environment::Array& arr) {
+			if (arguments.size() == 1) {
+				return cmd::done(Environment::arrayString(arr));
+			}
+			if (arguments.size() == 2) {
+				auto parseError = cmd::ParseError{};
 
-						if (index < 0) {
-							index += static_cast<int>(arr.size());
-						}
+				auto index = cmd::parseNumber<int>(parseError, cmd::CommandView{arguments}, 1, "array index");
+				if (parseError) {
+					return cmd::error("{}: {}", arguments.front().value, *parseError);
+				}
 
-						const auto i = static_cast<std::size_t>(index);
-						if (i < arr.size()) {
-							return cmd::done(arr[i]);
-						}
-						return cmd::error("{}: Array index out of range ({}/{}).", arguments.front().value, i, arr.size());
-					}
-					if (arguments.size() == 3) {
-						auto parseError = cmd::ParseError{};
+				if (index < 0) {
+					index += static_cast<int>(arr.size());
+				}
 
-						auto index = cmd::parseNumber<int>(parseError, arguments[1].value, "array index");
-						if (parseError) {
-							return cmd::error("{}: {}", arguments.front().value, *parseError);
-						}
+				const auto i = static_cast<std::size_t>(index);
+				if (i < arr.size()) {
+					return cmd::done(arr[i]);
+				}
+				return cmd::error("{}: Array index out of range ({}/{}).", arguments.front().value, i, arr.size());
+			}
+			if (arguments.size() == 3) {
+				auto parseError = cmd::ParseError{};
 
-						if (index < 0) {
-							index += static_cast<int>(arr.size());
-						}
+				auto index = cmd::parseNumber<int>(parseError, cmd::CommandView{arguments}, 1, "array index");
+				if (parseError) {
+					return cmd::error("{}: {}", arguments.front().value, *parseError);
+				}
 
-						const auto i = static_cast<std::size_t>(index);
-						if (i < arr.size()) {
-							arr[i] = std::move(arguments[2].value);
-							return cmd::done();
-						}
-						return cmd::error("{}: Array index out of range ({}/{}).", arguments.front().value, i, arr.size());
-					}
-					return cmd::error("Usage: {0} or {0} <index> or {0} <index> <value>", arguments.front().value);
-				},
-				[&](Environment::Table& table) {
-					if (arguments.size() == 1) {
-						return cmd::done(Environment::tableString(table));
-					}
-					if (arguments.size() == 2) {
-						if (const auto elemIt = table.find(arguments[1].value); elemIt != table.end()) {
-							return cmd::done(elemIt->second);
-						}
-						return cmd::done();
-					}
-					if (arguments.size() == 3) {
-						table[arguments[1].value] = std::move(arguments[2].value);
-						return cmd::done();
-					}
-					return cmd::error("Usage: {0} or {0} <key> or {0} <key> <value>", arguments.front().value);
-				});
-			return true;
-		}
-	}
-	return false;
+				if (index < 0) {
+					index += static_cast<int>(arr.size());
+				}
+
+				const auto i = static_cast<std::size_t>(index);
+				if (i < arr.size()) {
+					arr[i] = std::move(arguments[2].text());
+					return cmd::done();
+				}
+				return cmd::error("{}: Array index out of range ({}/{}).", arguments.front().value, i, arr.size());
+			}
+			return cmd::error("Usage: {0} or {0} <index> or {0} <index> <value>", arguments.front().value);
+		},
+		[&](Environment::Table& table) {
+			if (arguments.size() == 1) {
+				return cmd::done(Environment::tableString(table));
+			}
+			if (arguments.size() == 2) {
+				if (const auto elemIt = table.find(arguments[1].text()); elemIt != table.end()) {
+					return cmd::done(elemIt->second);
+				}
+				return cmd::done();
+			}
+			if (arguments.size() == 3) {
+				table[arguments[1].text()] = std::move(arguments[2].text());
+				return cmd::done();
+			}
+			return cmd::error("Usage: {0} or {0} <key> or {0} <key> <value>", arguments.front().value);
+		});
 }
 
 auto Process::checkGlobals(cmd::Result& result, cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, Game& game,
                            GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient) -> bool {
 	assert(!arguments.empty());
 	if (auto&& cmd = ConCommand::find(arguments.front().value)) /* Check commands. */ {
-		if ((cmd->getFlags() & ConCommand::CHEAT) != 0 && !sv_cheats) {
-			result = cmd::error("{} cannot be used because cheats are disabled.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
-			result = cmd::error("{} requires admin privileges.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::NO_RCON) != 0 && (m_userFlags & Process::REMOTE) != 0) {
-			result = cmd::error("{} cannot be used remotely.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::SERVER) != 0 && !server) {
-			result = cmd::error("{}: Not running a server.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::CLIENT) != 0 && !client) {
-			result = cmd::error("{}: Not connected to a server.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::META_SERVER) != 0 && !metaServer) {
-			result = cmd::error("{}: Not running a meta server.", cmd->getName());
-		} else if ((cmd->getFlags() & ConCommand::META_CLIENT) != 0 && !metaClient) {
-			result = cmd::error("{}: Not running a meta client.", cmd->getName());
-		} else {
-			result = cmd->execute(cmd::CommandView{arguments}, data, CallFrameHandle{this->shared_from_this(), frameIndex}, game, server, client, metaServer, metaClient, m_vm);
-		}
+		result = this->callCommand(*cmd, arguments, data, frameIndex, game, server, client, metaServer, metaClient);
 	} else if (auto&& cvar = ConVar::find(arguments.front().value)) /* Check cvars. */ {
-		if (arguments.size() == 1) {
-			if ((cvar->getFlags() & ConVar::READ_ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
-				result = cmd::error("{} can only be read by admin processes.", cvar->getName());
-			} else if ((cvar->getFlags() & ConVar::NO_RCON_READ) != 0 && (m_userFlags & Process::REMOTE) != 0) {
-				result = cmd::error("{} cannot be read remotely.", cvar->getName());
-			} else {
-				result = cmd::done(cvar->getString());
-			}
-		} else if ((cvar->getFlags() & ConVar::READ_ONLY) != 0) {
-			result = cmd::error("{} is read-only.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::INIT) != 0 && m_vm->started()) {
-			result = cmd::error("{} cannot be changed after startup.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::CHEAT) != 0 && !sv_cheats) {
-			result = cmd::error("{} cannot be changed because cheats are disabled.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::REPLICATED) != 0 && client && !server) {
-			result = cmd::error("{} cannot be changed because you are not the server.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::NOT_RUNNING_GAME_SERVER) != 0 && server) {
-			result = cmd::error("{} cannot be changed while running a game server.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::NOT_RUNNING_GAME_CLIENT) != 0 && client) {
-			result = cmd::error("{} cannot be changed while running a game client.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::NOT_RUNNING_META_SERVER) != 0 && metaServer) {
-			result = cmd::error("{} cannot be changed while running a meta server.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::NOT_RUNNING_META_CLIENT) != 0 && metaClient) {
-			result = cmd::error("{} cannot be changed while running a meta client.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::WRITE_ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
-			result = cmd::error("{} can only be changed by admin processes.", cvar->getName());
-		} else if ((cvar->getFlags() & ConVar::NO_RCON_WRITE) != 0 && (m_userFlags & Process::REMOTE) != 0) {
-			result = cmd::error("{} cannot be changed remotely.", cvar->getName());
-		} else {
-			result = cvar->set(util::subview(arguments, 1) | util::transform([](const auto& arg) { return arg.value; }) | util::join(' '),
-			                   game,
-			                   server,
-			                   client,
-			                   metaServer,
-			                   metaClient);
-		}
+		result = this->callCvar(*cvar, arguments, game, server, client, metaServer, metaClient);
 	} else if (!arguments.front().value.empty() && arguments.front().value.front() == '+') /* Check input manager press. */ {
 		if ((m_userFlags & Process::ADMIN) == 0) {
 			result = cmd::error("{} requires admin privileges.", arguments.front().value);
@@ -878,3 +1149,86 @@ auto Process::checkGlobals(cmd::Result& result, cmd::CommandArguments& arguments
 	}
 	return true;
 }
+
+auto Process::callCommand(ConCommand& cmd, cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, Game& game, GameServer* server,
+                          GameClient* client, MetaServer* metaServer, MetaClient* metaClient) -> cmd::Result {
+	if ((cmd.getFlags() & ConCommand::CHEAT) != 0 && !sv_cheats) {
+		return cmd::error("{} cannot be used because cheats are disabled.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
+		return cmd::error("{} requires admin privileges.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::NO_RCON) != 0 && (m_userFlags & Process::REMOTE) != 0) {
+		return cmd::error("{} cannot be used remotely.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::SERVER) != 0 && !server) {
+		return cmd::error("{}: Not running a server.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::CLIENT) != 0 && !client) {
+		return cmd::error("{}: Not connected to a server.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::META_SERVER) != 0 && !metaServer) {
+		return cmd::error("{}: Not running a meta server.", cmd.getName());
+	}
+	if ((cmd.getFlags() & ConCommand::META_CLIENT) != 0 && !metaClient) {
+		return cmd::error("{}: Not running a meta client.", cmd.getName());
+	}
+	return cmd.execute(cmd::CommandView{arguments},
+	                   data,
+	                   CallFrameHandle{this->shared_from_this(), frameIndex},
+	                   game,
+	                   server,
+	                   client,
+	                   metaServer,
+	                   metaClient,
+	                   m_vm);
+}
+
+auto Process::callCvar(ConVar& cvar, cmd::CommandArguments& arguments, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer,
+                       MetaClient* metaClient) -> cmd::Result {
+	if (arguments.size() == 1) {
+		if ((cvar.getFlags() & ConVar::READ_ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
+			return cmd::error("{} can only be read by admin processes.", cvar.getName());
+		}
+		if ((cvar.getFlags() & ConVar::NO_RCON_READ) != 0 && (m_userFlags & Process::REMOTE) != 0) {
+			return cmd::error("{} cannot be read remotely.", cvar.getName());
+		}
+		return cmd::done(cvar.getString());
+	}
+	if ((cvar.getFlags() & ConVar::READ_ONLY) != 0) {
+		return cmd::error("{} is read-only.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::INIT) != 0 && m_vm->started()) {
+		return cmd::error("{} cannot be changed after startup.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::CHEAT) != 0 && !sv_cheats) {
+		return cmd::error("{} cannot be changed because cheats are disabled.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::REPLICATED) != 0 && client && !server) {
+		return cmd::error("{} cannot be changed because you are not the server.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::NOT_RUNNING_GAME_SERVER) != 0 && server) {
+		return cmd::error("{} cannot be changed while running a game server.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::NOT_RUNNING_GAME_CLIENT) != 0 && client) {
+		return cmd::error("{} cannot be changed while running a game client.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::NOT_RUNNING_META_SERVER) != 0 && metaServer) {
+		return cmd::error("{} cannot be changed while running a meta server.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::NOT_RUNNING_META_CLIENT) != 0 && metaClient) {
+		return cmd::error("{} cannot be changed while running a meta client.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::WRITE_ADMIN_ONLY) != 0 && (m_userFlags & Process::ADMIN) == 0) {
+		return cmd::error("{} can only be changed by admin processes.", cvar.getName());
+	}
+	if ((cvar.getFlags() & ConVar::NO_RCON_WRITE) != 0 && (m_userFlags & Process::REMOTE) != 0) {
+		return cmd::error("{} cannot be changed remotely.", cvar.getName());
+	}
+	return cvar.set(util::subview(arguments, 1) | util::transform([](auto& arg) { return arg.text(); }) | util::join(' '),
+	                game,
+	                server,
+	                client,
+	                metaServer,
+	                metaClient);
+}
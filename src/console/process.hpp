@@ -5,20 +5,23 @@
 #include "../utilities/span.hpp"      // util::Span
 #include "call_frame_handle.hpp"      // CallFrameHandle
 #include "command.hpp"                // cmd::...
+#include "compiled_script.hpp"        // CompiledScript
 #include "environment.hpp"            // Environment
 #include "io_buffer.hpp"              // IOBuffer
 #include "script.hpp"                 // Script
-
-#include <any>         // std::any
-#include <chrono>      // std::chrono::..., std::milli
-#include <cstddef>     // std::size_t, std::ptrdiff_t
-#include <cstdint>     // std::uint32_t
-#include <functional>  // std::function
-#include <limits>      // std::numeric_limits
-#include <memory>      // std::unique_ptr, std::make_unique, std::shared_ptr, std::make_shared, std::weak_ptr, std::enable_shared_from_this
-#include <optional>    // std::optional, std::nullopt
-#include <string>      // std::string
-#include <string_view> // std::string_view
+#include "symbol.hpp"                 // Symbol, SymbolRef
+
+#include <any>           // std::any
+#include <chrono>        // std::chrono::..., std::milli
+#include <cstddef>       // std::size_t, std::ptrdiff_t
+#include <cstdint>       // std::uint8_t, std::uint64_t
+#include <deque>         // std::deque
+#include <functional>    // std::function
+#include <limits>        // std::numeric_limits
+#include <memory>        // std::unique_ptr, std::make_unique, std::shared_ptr, std::make_shared, std::weak_ptr, std::enable_shared_from_this
+#include <optional>      // std::optional, std::nullopt
+#include <string>        // std::string
+#include <string_view>   // std::string_view
 #include <unordered_map> // std::unordered_map
 #include <utility>       // std::move, std::forward
 #include <vector>        // std::vector
@@ -44,12 +47,22 @@ public:
 		ADMIN = 1 << 4,   // Has administrative privileges.
 	};
 
+	// What the process is waiting for before it has anything left to do.
+	enum class WaitState : std::uint8_t {
+		READY,    // Runs every frame.
+		SLEEPING, // Waits until the virtual machine time reaches the wake time.
+		INPUT,    // Waits until something is written to its input buffer.
+	};
+
 	using Id = std::uint64_t;
 	using ErrorHandler = std::function<bool(cmd::Result)>;
+	using Clock = std::chrono::steady_clock;
 
 	static constexpr auto MAX_STACK_SIZE = std::size_t{1000};
 	static constexpr auto MAX_ALIAS_DEPTH = std::size_t{100};
 	static constexpr auto NO_FRAME = std::numeric_limits<std::size_t>::max();
+	static constexpr auto MAX_ENVIRONMENT_POOL_SIZE = std::size_t{32};
+	static constexpr auto DEADLINE_CHECK_INTERVAL = 16; // Number of commands to execute between each check of the time budget.
 
 	Process(VirtualMachine& vm, Id id, float startTime, UserFlags userFlags);
 
@@ -66,6 +79,13 @@ public:
 	[[nodiscard]] auto running() const noexcept -> bool;
 	[[nodiscard]] auto done() const noexcept -> bool;
 	[[nodiscard]] auto getProgress() const -> float;
+	[[nodiscard]] auto getWaitState() const noexcept -> WaitState;
+	[[nodiscard]] auto getCpuTime() const noexcept -> std::chrono::microseconds;
+	[[nodiscard]] auto getLastCpuTime() const noexcept -> std::chrono::microseconds;
+	[[nodiscard]] auto getThrottleCount() const noexcept -> std::size_t;
+
+	// Check if there is no point in running the process at the given virtual machine time.
+	[[nodiscard]] auto blocked(float currentTime) const noexcept -> bool;
 
 	[[nodiscard]] auto defined(const std::shared_ptr<Environment>& env, const std::string& name) const -> bool;
 	[[nodiscard]] auto findObject(const std::shared_ptr<Environment>& env, const std::string& name) const -> Environment::Object*;
@@ -86,6 +106,19 @@ public:
 	[[nodiscard]] auto release() noexcept -> bool;
 	auto end() noexcept -> void;
 
+	// Don't run the process again until the virtual machine time has reached a certain point.
+	// Cleared as soon as the process runs again.
+	auto sleepUntil(float time) noexcept -> void;
+
+	// Don't run the process again until something has been written to its input buffer.
+	// Cleared as soon as the process runs again.
+	auto waitForInput() noexcept -> void;
+
+	// Run the process, deferring its remaining commands to the next frame once it has used up the given amount of time.
+	// A budget of 0 means that the process may run until it is done or deferred by itself.
+	[[nodiscard]] auto runFor(std::chrono::microseconds budget, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer,
+	                          MetaClient* metaClient) -> cmd::Result;
+
 	[[nodiscard]] auto run(Game& game, GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient,
 	                       std::size_t targetFrameIndex = 0) -> cmd::Result;
 	[[nodiscard]] auto await(Game& game, GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient,
@@ -107,12 +140,18 @@ public:
 	[[nodiscard]] auto call(std::shared_ptr<Environment> env, Script commands, std::size_t returnFrameIndex = NO_FRAME,
 	                        std::size_t returnArgumentIndex = 0, const std::shared_ptr<Environment>& exportTarget = nullptr)
 		-> std::optional<CallFrameHandle>;
+	[[nodiscard]] auto call(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script, std::size_t returnFrameIndex = NO_FRAME,
+	                        std::size_t returnArgumentIndex = 0, const std::shared_ptr<Environment>& exportTarget = nullptr)
+		-> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::shared_ptr<Environment> env, const Environment::Function& function, std::size_t returnFrameIndex = NO_FRAME,
 	                        std::size_t returnArgumentIndex = 0, const std::shared_ptr<Environment>& exportTarget = nullptr)
 		-> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::shared_ptr<Environment> env, const Environment::Function& function, util::Span<const cmd::Value> args,
 	                        std::size_t returnFrameIndex = NO_FRAME, std::size_t returnArgumentIndex = 0,
 	                        const std::shared_ptr<Environment>& exportTarget = nullptr) -> std::optional<CallFrameHandle>;
+	[[nodiscard]] auto call(std::shared_ptr<Environment> env, const Environment::Function& function, cmd::CommandArguments args,
+	                        std::size_t returnFrameIndex = NO_FRAME, std::size_t returnArgumentIndex = 0,
+	                        const std::shared_ptr<Environment>& exportTarget = nullptr) -> std::optional<CallFrameHandle>;
 	[[nodiscard]] auto call(std::shared_ptr<Environment> env, ConCommand& cmd, std::size_t returnFrameIndex = NO_FRAME,
 	                        std::size_t returnArgumentIndex = 0, const std::shared_ptr<Environment>& exportTarget = nullptr)
 		-> std::optional<CallFrameHandle>;
@@ -131,48 +170,68 @@ public:
 
 private:
 	friend CallFrameHandle;
+	struct CommandState final {
+		cmd::CommandArguments arguments;
+		cmd::Progress progress = 0;
+		std::any data;
+		bool argsExpanded = false;
+	};
+
 	struct CallFrame final {
-		CallFrame(std::shared_ptr<Environment> env, Script commands, std::size_t returnFrameIndex, std::size_t returnArgumentIndex,
-		          const std::shared_ptr<Environment>& exportTarget)
-			: commands(std::move(commands))
-			, commandStates(this->commands.size())
+		CallFrame(std::shared_ptr<Environment> env, std::shared_ptr<const CompiledScript> script, std::size_t firstCommandState,
+		          std::size_t returnFrameIndex, std::size_t returnArgumentIndex, const std::shared_ptr<Environment>& exportTarget)
+			: script(std::move(script))
+			, firstCommandState(firstCommandState)
 			, env(std::move(env))
 			, returnFrameIndex(returnFrameIndex)
 			, returnArgumentIndex(returnArgumentIndex)
 			, exportTarget(exportTarget) {}
 
-		struct CommandState final {
-			cmd::CommandArguments arguments;
-			cmd::Progress progress = 0;
-			std::any data;
-			bool argsExpanded = false;
-		};
-
-		Script commands;                         // Commands to be executed.
-		std::vector<CommandState> commandStates; // State of each command.
-		std::shared_ptr<Environment> env;        // Local environment.
-		std::size_t returnFrameIndex;            // Which call frame to return to.
-		std::size_t returnArgumentIndex;         // Which argument in the return frame to return to.
+		std::shared_ptr<const CompiledScript> script; // Commands to be executed. Shared by all frames that run the same script.
+		std::size_t firstCommandState;                // Index of the state of the first command in the command state arena.
+		std::shared_ptr<Environment> env;             // Local environment.
+		std::size_t returnFrameIndex;                 // Which call frame to return to.
+		std::size_t returnArgumentIndex;              // Which argument in the return frame to return to.
 		std::weak_ptr<Environment> exportTarget;
 		std::size_t programCounter = 0;         // Current command.
 		cmd::Status status = cmd::Status::NONE; // Current status.
+		SymbolRef label{};                      // Name of the command that pushed this frame, if the profiler was running.
 		bool firstInTryBlock = false;
 		bool firstInSection = false;
 		bool executing = false;
 	};
 
+	[[nodiscard]] auto commandState(const CallFrame& frame, std::size_t i) noexcept -> CommandState&;
+	[[nodiscard]] auto makeEnvironment(std::shared_ptr<Environment> parent) -> std::shared_ptr<Environment>;
+	auto popFrame() -> void;
 	[[nodiscard]] auto handleError(cmd::Result error) -> bool;
+	auto labelFrames(std::size_t stackSize, const SymbolRef& label) noexcept -> void;
+	auto profile(std::size_t frameIndex, const SymbolRef& symbol, std::size_t stackSize, Clock::duration time) -> void;
 	auto setupPipeline(cmd::Result& result, CallFrame& frame) -> void;
 	[[nodiscard]] auto expandArgs(std::size_t frameIndex) -> bool;
+	[[nodiscard]] auto bind(const CompiledScript::Command& command, const std::shared_ptr<Environment>& env) -> const CompiledScript::Binding::Target&;
+	[[nodiscard]] auto checkBinding(cmd::Result& result, const CompiledScript::Command& command, const std::shared_ptr<Environment>& env,
+	                                cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, std::size_t returnFrameIndex,
+	                                std::size_t returnArgumentIndex, Game& game, GameServer* server, GameClient* client, MetaServer* metaServer,
+	                                MetaClient* metaClient) -> bool;
 	[[nodiscard]] auto checkAliases(cmd::Result& result, const std::shared_ptr<Environment>& env, cmd::CommandArguments& arguments,
 	                                std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> bool;
 	[[nodiscard]] auto checkObjects(cmd::Result& result, const std::shared_ptr<Environment>& env, cmd::CommandArguments& arguments,
 	                                std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> bool;
 	[[nodiscard]] auto checkGlobals(cmd::Result& result, cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, Game& game,
 	                                GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient) -> bool;
+	[[nodiscard]] auto callObject(const std::shared_ptr<Environment>& env, Environment::Object& object, cmd::CommandArguments& arguments,
+	                              std::size_t returnFrameIndex, std::size_t returnArgumentIndex) -> cmd::Result;
+	[[nodiscard]] auto callCommand(ConCommand& cmd, cmd::CommandArguments& arguments, std::any& data, std::size_t frameIndex, Game& game,
+	                               GameServer* server, GameClient* client, MetaServer* metaServer, MetaClient* metaClient) -> cmd::Result;
+	[[nodiscard]] auto callCvar(ConVar& cvar, cmd::CommandArguments& arguments, Game& game, GameServer* server, GameClient* client,
+	                            MetaServer* metaServer, MetaClient* metaClient) -> cmd::Result;
 
 	util::Reference<VirtualMachine> m_vm;
 	std::vector<CallFrame> m_callStack{};                             // Current call stack.
+	std::deque<CommandState> m_commandStates{};                       // Arena of command states, used like a stack by the call frames.
+	std::size_t m_commandStateCount = 0;                              // Number of command states in use by the call stack.
+	std::vector<std::shared_ptr<Environment>> m_environmentPool{};    // Reset local environments of popped frames, ready to be reused.
 	std::shared_ptr<IOBuffer> m_input = std::make_shared<IOBuffer>(); // Received input.
 	std::optional<std::weak_ptr<IOBuffer>> m_output{};                // If nullopt, output to virtual machine.
 	float m_startTime;
@@ -182,6 +241,14 @@ private:
 	std::vector<std::shared_ptr<Process>> m_children{};
 	std::optional<std::string> m_latestError{};
 	ErrorHandler m_errorHandler{};
+	std::string m_profileStack{};                  // Reused buffer for building the stack of each command that is profiled.
+	std::optional<Clock::time_point> m_deadline{}; // When to stop running, if the process has a time budget.
+	std::chrono::microseconds m_cpuTime{0};        // Total time spent running the call stack.
+	std::chrono::microseconds m_lastCpuTime{0};    // Time spent running the call stack the last time the process was run.
+	std::size_t m_throttleCount = 0;               // Number of times the process has been deferred for running out of time.
+	float m_wakeTime = 0.0f;                       // Virtual machine time to wake up at if sleeping.
+	std::uint64_t m_inputRevision = 0;             // Revision of the input buffer to wait for a change from if waiting for input.
+	WaitState m_waitState = WaitState::READY;
 	bool m_running = false;
 };
 
@@ -104,8 +104,7 @@ private:
 			if (this->peek() == '\\') {
 				this->readEscapeSequence();
 			} else {
-				this->addCharacter(this->peek());
-				this->advance();
+				this->readSpan(ScriptParser::isQuoteSpecial);
 			}
 		}
 	}
@@ -123,8 +122,7 @@ private:
 			if (this->peek() == '\\') {
 				this->readEscapeSequenceVerbatim();
 			} else {
-				this->addCharacter(this->peek());
-				this->advance();
+				this->readSpan(ScriptParser::isQuoteSpecial);
 			}
 		}
 	}
@@ -162,10 +160,7 @@ private:
 					}
 					case '{': this->readCurlyBraces(); return;
 					case '\"': this->readQuote(); break;
-					default:
-						this->addCharacter(this->peek());
-						this->advance();
-						break;
+					default: this->readSpan(ScriptParser::isTokenSpecial); break;
 				}
 			}
 		}
@@ -190,6 +185,7 @@ private:
 						return;
 					}
 					break;
+				default: this->readSpan(ScriptParser::isBracketSpecial); continue;
 			}
 			this->addCharacter(this->peek());
 			this->advance();
@@ -243,6 +239,30 @@ private:
 		this->currentArgument().value.push_back(ch);
 	}
 
+	// Copy the current character and every following character that doesn't need any special treatment straight from the
+	// source in one go. Only escape sequences and brackets are handled one character at a time.
+	template <typename IsSpecial>
+	auto readSpan(IsSpecial isSpecial) -> void {
+		const auto begin = m_it;
+		do {
+			this->advance();
+		} while (!this->atEnd() && !isSpecial(this->peek()));
+		this->currentArgument().value.append(begin, m_it);
+	}
+
+	[[nodiscard]] static constexpr auto isTokenSpecial(char ch) noexcept -> bool {
+		return Script::isWhitespace(ch) || Script::isCommandSeparator(ch) || ch == '|' || ch == '/' || ch == '.' || ch == '\\' ||
+		       ch == '(' || ch == '{' || ch == '\"';
+	}
+
+	[[nodiscard]] static constexpr auto isQuoteSpecial(char ch) noexcept -> bool {
+		return ch == '\"' || ch == '\\';
+	}
+
+	[[nodiscard]] static constexpr auto isBracketSpecial(char ch) noexcept -> bool {
+		return ch == '\"' || ch == '(' || ch == ')' || ch == '{' || ch == '}';
+	}
+
 	auto makeExpression() noexcept -> void {
 		this->currentArgument().flags |= Script::Argument::EXEC;
 	}
@@ -0,0 +1,116 @@
+#include "script_profiler.hpp"
+
+#include <algorithm>     // std::sort, std::min
+#include <fmt/core.h>    // fmt::format
+#include <string_view>   // std::string_view
+#include <unordered_set> // std::unordered_set
+#include <utility>       // std::pair
+#include <vector>        // std::vector
+
+namespace {
+
+struct Totals final {
+	std::size_t calls = 0;
+	std::size_t frames = 0;
+	std::chrono::nanoseconds inclusiveTime{0};
+	std::chrono::nanoseconds exclusiveTime{0};
+};
+
+[[nodiscard]] auto milliseconds(std::chrono::nanoseconds time) -> double {
+	return std::chrono::duration<double, std::milli>{time}.count();
+}
+
+} // namespace
+
+auto ScriptProfiler::start() -> void {
+	if (!m_enabled) {
+		m_enabled = true;
+		m_startTime = Clock::now();
+	}
+}
+
+auto ScriptProfiler::stop() noexcept -> void {
+	if (m_enabled) {
+		m_enabled = false;
+		m_duration += Clock::now() - m_startTime;
+	}
+}
+
+auto ScriptProfiler::clear() noexcept -> void {
+	m_stacks.clear();
+	m_startTime = Clock::now();
+	m_duration = Clock::duration{};
+}
+
+auto ScriptProfiler::record(const std::string& stack, std::chrono::nanoseconds time, std::size_t frames) -> void {
+	auto it = m_stacks.find(stack);
+	if (it == m_stacks.end()) {
+		it = m_stacks.emplace(stack, Entry{}).first;
+	}
+	++it->second.calls;
+	it->second.time += time;
+	it->second.frames += frames;
+}
+
+auto ScriptProfiler::report(std::size_t maxEntries) const -> std::string {
+	auto totals = std::unordered_map<std::string_view, Totals>{};
+	auto namesInStack = std::unordered_set<std::string_view>{};
+	auto totalTime = std::chrono::nanoseconds{0};
+	for (const auto& [stack, entry] : m_stacks) {
+		totalTime += entry.time;
+
+		// Every name in the stack includes the time of the command, but only once per stack in case of recursion.
+		namesInStack.clear();
+		auto name = std::string_view{};
+		for (auto rest = std::string_view{stack}; !rest.empty();) {
+			const auto end = std::min(rest.find(';'), rest.size());
+			name = rest.substr(0, end);
+			if (namesInStack.insert(name).second) {
+				totals[name].inclusiveTime += entry.time;
+			}
+			rest.remove_prefix(std::min(end + 1, rest.size()));
+		}
+
+		auto& leaf = totals[name];
+		leaf.calls += entry.calls;
+		leaf.frames += entry.frames;
+		leaf.exclusiveTime += entry.time;
+	}
+
+	auto sorted = std::vector<std::pair<std::string_view, Totals>>{totals.begin(), totals.end()};
+	std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+		return lhs.second.inclusiveTime > rhs.second.inclusiveTime;
+	});
+	if (sorted.size() > maxEntries) {
+		sorted.resize(maxEntries);
+	}
+
+	const auto duration = m_duration + ((m_enabled) ? Clock::now() - m_startTime : Clock::duration{});
+	auto result = fmt::format("Script profile ({:.3f} ms in scripts over {:.3f} ms):\n{:<32} {:>10} {:>12} {:>12} {:>10}",
+	                          milliseconds(totalTime),
+	                          milliseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(duration)),
+	                          "Name",
+	                          "Calls",
+	                          "Incl. ms",
+	                          "Excl. ms",
+	                          "Frames");
+	for (const auto& [name, total] : sorted) {
+		result.append(fmt::format("\n{:<32} {:>10} {:>12.3f} {:>12.3f} {:>10}",
+		                          name,
+		                          total.calls,
+		                          milliseconds(total.inclusiveTime),
+		                          milliseconds(total.exclusiveTime),
+		                          total.frames));
+	}
+	return result;
+}
+
+auto ScriptProfiler::collapsedStacks() const -> std::string {
+	auto result = std::string{};
+	for (const auto& [stack, entry] : m_stacks) {
+		if (entry.time.count() > 0) {
+			result.append(fmt::format("{} {}\n", stack, entry.time.count()));
+		}
+	}
+	return result;
+}
@@ -0,0 +1,45 @@
+#ifndef AF2_CONSOLE_SCRIPT_PROFILER_HPP
+#define AF2_CONSOLE_SCRIPT_PROFILER_HPP
+
+#include <chrono>        // std::chrono::...
+#include <cstddef>       // std::size_t
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
+
+// Records where script processes spend their time while it is running.
+// Each executed command is recorded under its call stack, which is the names of the commands that pushed each call frame
+// followed by the name of the command itself, separated by semicolons.
+class ScriptProfiler final {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Entry final {
+		std::size_t calls = 0;            // Number of times the command was executed.
+		std::chrono::nanoseconds time{0}; // Time spent executing the command itself, not counting the frames that it pushed.
+		std::size_t frames = 0;           // Number of call frames that the command pushed.
+	};
+
+	auto start() -> void;
+	auto stop() noexcept -> void;
+	auto clear() noexcept -> void;
+
+	[[nodiscard]] auto enabled() const noexcept -> bool {
+		return m_enabled;
+	}
+
+	auto record(const std::string& stack, std::chrono::nanoseconds time, std::size_t frames) -> void;
+
+	// Get a table of the most expensive command names with their call counts, inclusive and exclusive times.
+	[[nodiscard]] auto report(std::size_t maxEntries) const -> std::string;
+
+	// Get the recorded stacks in the collapsed format used by flamegraph tools, with the time in nanoseconds as the sample count.
+	[[nodiscard]] auto collapsedStacks() const -> std::string;
+
+private:
+	std::unordered_map<std::string, Entry> m_stacks{};
+	Clock::time_point m_startTime{};
+	Clock::duration m_duration{};
+	bool m_enabled = false;
+};
+
+#endif
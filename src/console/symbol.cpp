@@ -0,0 +1,65 @@
+#include "symbol.hpp"
+
+#include <cassert>       // assert
+#include <memory>        // std::unique_ptr, std::make_unique
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move
+
+namespace {
+
+using SymbolTable = std::unordered_map<std::string_view, std::unique_ptr<Symbol>>;
+
+auto symbolTable() -> SymbolTable& {
+	static auto table = SymbolTable{};
+	return table;
+}
+
+} // namespace
+
+auto Symbol::get(std::string_view name) -> Symbol& {
+	auto& table = symbolTable();
+	if (const auto it = table.find(name); it != table.end()) {
+		return *it->second;
+	}
+
+	// The key views the name owned by the symbol itself.
+	auto symbol = std::make_unique<Symbol>(Symbol{std::string{name}});
+	auto& result = *symbol;
+	table.emplace(result.name, std::move(symbol));
+	return result;
+}
+
+auto Symbol::find(std::string_view name) noexcept -> Symbol* {
+	auto& table = symbolTable();
+	const auto it = table.find(name);
+	return (it == table.end()) ? nullptr : it->second.get();
+}
+
+auto Symbol::count() noexcept -> std::size_t {
+	return symbolTable().size();
+}
+
+auto Symbol::define() const noexcept -> void {
+	++definitions;
+	++version;
+}
+
+auto Symbol::undefine() const noexcept -> void {
+	assert(definitions > 0);
+	--definitions;
+	++version;
+	this->release();
+}
+
+auto Symbol::touch() const noexcept -> void {
+	++version;
+}
+
+auto Symbol::release() const noexcept -> void {
+	if (definitions == 0 && references == 0 && !command && !cvar) {
+		auto& table = symbolTable();
+		if (const auto it = table.find(name); it != table.end()) {
+			table.erase(it);
+		}
+	}
+}
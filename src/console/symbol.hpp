@@ -0,0 +1,281 @@
+#ifndef AF2_CONSOLE_SYMBOL_HPP
+#define AF2_CONSOLE_SYMBOL_HPP
+
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint64_t
+#include <initializer_list> // std::initializer_list
+#include <string>           // std::string
+#include <string_view>      // std::string_view
+#include <unordered_map>    // std::unordered_map
+#include <utility>          // std::move, std::forward, std::pair
+
+class ConCommand;
+class ConVar;
+
+// Interned name of a command, cvar, object or alias. There is exactly one symbol for each distinct name, and its address never
+// changes, so symbols can be compared and hashed as pointers instead of strings once a name has been looked up.
+// Also keeps track of what is defined under the name, which lets compiled commands that have already looked up a name tell
+// whether the lookup could now give a different result without walking the environment chain again.
+// A symbol is removed as soon as nothing is defined or registered under its name and no SymbolRef refers to it, so names that
+// scripts only use for a while, such as generated variable names, don't stay interned for the rest of the program.
+struct Symbol final {
+	std::string name;
+	ConCommand* command = nullptr;       // Command registered under this name, if any.
+	ConVar* cvar = nullptr;              // Cvar registered under this name, if any.
+	mutable std::size_t definitions = 0; // Number of objects and aliases with this name in all environments.
+	mutable std::size_t references = 0;  // Number of SymbolRefs to this symbol.
+	mutable std::uint64_t version = 1;   // Changed every time an object or alias with this name is defined or removed. Never 0.
+
+	// Get the symbol of a name, interning it if it doesn't exist yet. The returned reference stays valid until the symbol is
+	// released, so anything that keeps it beyond a single lookup must define something under it or hold a SymbolRef to it.
+	[[nodiscard]] static auto get(std::string_view name) -> Symbol&;
+
+	// Get the symbol of a name if it has been interned. Nothing can be defined under a name that has no symbol.
+	[[nodiscard]] static auto find(std::string_view name) noexcept -> Symbol*;
+
+	// Get the number of interned names.
+	[[nodiscard]] static auto count() noexcept -> std::size_t;
+
+	auto define() const noexcept -> void;
+	auto undefine() const noexcept -> void;
+	auto touch() const noexcept -> void;
+
+	// Remove the symbol if nothing refers to it anymore. This destroys the symbol, so it must not be used afterwards.
+	auto release() const noexcept -> void;
+};
+
+// Reference that keeps a symbol interned.
+class SymbolRef final {
+public:
+	SymbolRef() noexcept = default;
+
+	explicit SymbolRef(const Symbol& symbol) noexcept
+		: m_symbol(&symbol) {
+		++m_symbol->references;
+	}
+
+	~SymbolRef() {
+		this->reset();
+	}
+
+	SymbolRef(const SymbolRef& other) noexcept
+		: m_symbol(other.m_symbol) {
+		if (m_symbol) {
+			++m_symbol->references;
+		}
+	}
+
+	SymbolRef(SymbolRef&& other) noexcept
+		: m_symbol(other.m_symbol) {
+		other.m_symbol = nullptr;
+	}
+
+	auto operator=(const SymbolRef& other) noexcept -> SymbolRef& {
+		if (this != &other) {
+			*this = SymbolRef{other};
+		}
+		return *this;
+	}
+
+	auto operator=(SymbolRef&& other) noexcept -> SymbolRef& {
+		if (this != &other) {
+			this->reset();
+			m_symbol = other.m_symbol;
+			other.m_symbol = nullptr;
+		}
+		return *this;
+	}
+
+	auto reset() noexcept -> void {
+		if (m_symbol) {
+			--m_symbol->references;
+			m_symbol->release();
+			m_symbol = nullptr;
+		}
+	}
+
+	[[nodiscard]] auto get() const noexcept -> const Symbol* {
+		return m_symbol;
+	}
+
+	[[nodiscard]] auto operator*() const noexcept -> const Symbol& {
+		return *m_symbol;
+	}
+
+	[[nodiscard]] auto operator->() const noexcept -> const Symbol* {
+		return m_symbol;
+	}
+
+	[[nodiscard]] explicit operator bool() const noexcept {
+		return m_symbol != nullptr;
+	}
+
+private:
+	const Symbol* m_symbol = nullptr;
+};
+
+// Map from symbols to objects or aliases that keeps the bookkeeping of each symbol up to date.
+// Names are interned when something is inserted, and looking up a name that was never interned doesn't intern it.
+template <typename T>
+class SymbolMap final {
+private:
+	using Map = std::unordered_map<const Symbol*, T>;
+
+public:
+	using key_type = typename Map::key_type;
+	using mapped_type = typename Map::mapped_type;
+	using value_type = typename Map::value_type;
+	using size_type = typename Map::size_type;
+	using iterator = typename Map::iterator;
+	using const_iterator = typename Map::const_iterator;
+
+	SymbolMap() = default;
+
+	SymbolMap(std::initializer_list<std::pair<std::string_view, T>> init) {
+		for (const auto& [name, value] : init) {
+			this->try_emplace(name, value);
+		}
+	}
+
+	~SymbolMap() {
+		this->clear();
+	}
+
+	SymbolMap(const SymbolMap& other)
+		: m_map(other.m_map) {
+		for (const auto& kv : m_map) {
+			kv.first->define();
+		}
+	}
+
+	SymbolMap(SymbolMap&& other) noexcept
+		: m_map(std::move(other.m_map)) {
+		other.m_map.clear();
+		for (const auto& kv : m_map) {
+			kv.first->touch(); // The objects now belong to a different environment.
+		}
+	}
+
+	auto operator=(const SymbolMap& other) -> SymbolMap& {
+		if (this != &other) {
+			*this = SymbolMap{other};
+		}
+		return *this;
+	}
+
+	auto operator=(SymbolMap&& other) noexcept -> SymbolMap& {
+		if (this != &other) {
+			this->clear();
+			m_map = std::move(other.m_map);
+			other.m_map.clear();
+			for (const auto& kv : m_map) {
+				kv.first->touch();
+			}
+		}
+		return *this;
+	}
+
+	[[nodiscard]] auto begin() noexcept -> iterator {
+		return m_map.begin();
+	}
+
+	[[nodiscard]] auto begin() const noexcept -> const_iterator {
+		return m_map.begin();
+	}
+
+	[[nodiscard]] auto end() noexcept -> iterator {
+		return m_map.end();
+	}
+
+	[[nodiscard]] auto end() const noexcept -> const_iterator {
+		return m_map.end();
+	}
+
+	[[nodiscard]] auto size() const noexcept -> size_type {
+		return m_map.size();
+	}
+
+	[[nodiscard]] auto empty() const noexcept -> bool {
+		return m_map.empty();
+	}
+
+	[[nodiscard]] auto find(const Symbol& symbol) -> iterator {
+		return m_map.find(&symbol);
+	}
+
+	[[nodiscard]] auto find(const Symbol& symbol) const -> const_iterator {
+		return m_map.find(&symbol);
+	}
+
+	[[nodiscard]] auto find(std::string_view name) -> iterator {
+		const auto* const symbol = Symbol::find(name);
+		return (symbol) ? m_map.find(symbol) : m_map.end();
+	}
+
+	[[nodiscard]] auto find(std::string_view name) const -> const_iterator {
+		const auto* const symbol = Symbol::find(name);
+		return (symbol) ? m_map.find(symbol) : m_map.end();
+	}
+
+	[[nodiscard]] auto count(const Symbol& symbol) const -> size_type {
+		return m_map.count(&symbol);
+	}
+
+	[[nodiscard]] auto count(std::string_view name) const -> size_type {
+		const auto* const symbol = Symbol::find(name);
+		return (symbol) ? m_map.count(symbol) : 0;
+	}
+
+	template <typename... Args>
+	auto try_emplace(const Symbol& symbol, Args&&... args) -> std::pair<iterator, bool> { // NOLINT(readability-identifier-naming)
+		auto result = m_map.try_emplace(&symbol, std::forward<Args>(args)...);
+		if (result.second) {
+			symbol.define();
+		}
+		return result;
+	}
+
+	template <typename... Args>
+	auto try_emplace(std::string_view name, Args&&... args) -> std::pair<iterator, bool> { // NOLINT(readability-identifier-naming)
+		return this->try_emplace(Symbol::get(name), std::forward<Args>(args)...);
+	}
+
+	template <typename M>
+	auto insert_or_assign(std::string_view name, M&& obj) -> std::pair<iterator, bool> { // NOLINT(readability-identifier-naming)
+		auto& symbol = Symbol::get(name);
+		auto result = m_map.insert_or_assign(&symbol, std::forward<M>(obj));
+		if (result.second) {
+			symbol.define();
+		}
+		return result;
+	}
+
+	auto operator[](std::string_view name) -> mapped_type& {
+		return this->try_emplace(name).first->second;
+	}
+
+	auto erase(const Symbol& symbol) -> size_type {
+		if (m_map.erase(&symbol) != 0) {
+			symbol.undefine();
+			return 1;
+		}
+		return 0;
+	}
+
+	auto erase(std::string_view name) -> size_type {
+		const auto* const symbol = Symbol::find(name);
+		return (symbol) ? this->erase(*symbol) : 0;
+	}
+
+	auto clear() noexcept -> void {
+		for (const auto& kv : m_map) {
+			kv.first->undefine();
+		}
+		m_map.clear();
+	}
+
+private:
+	Map m_map{};
+};
+
+#endif
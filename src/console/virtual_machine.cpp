@@ -4,8 +4,10 @@
 #include "../utilities/algorithm.hpp"       // util::collect, util::transform, util::erase, util::contains, util::collect
 #include "../utilities/reference.hpp"       // util::Reference
 #include "../utilities/string.hpp"          // util::join, util::toString
+#include "commands/process_commands.hpp"    // process_budget
 
 #include <cassert>    // assert
+#include <chrono>     // std::chrono::microseconds
 #include <cmath>      // std::nextafter
 #include <fmt/core.h> // fmt::format
 #include <limits>     // std::numeric_limits
@@ -39,6 +41,14 @@ auto VirtualMachine::rng() const noexcept -> const std::mt19937& {
 	return m_rng;
 }
 
+auto VirtualMachine::profiler() noexcept -> ScriptProfiler& {
+	return m_profiler;
+}
+
+auto VirtualMachine::profiler() const noexcept -> const ScriptProfiler& {
+	return m_profiler;
+}
+
 auto VirtualMachine::started() const noexcept -> bool {
 	return m_started;
 }
@@ -106,11 +116,15 @@ auto VirtualMachine::run(float deltaTime, Game& game, GameServer* server, GameCl
 
 auto VirtualMachine::runProcesses(std::vector<std::shared_ptr<Process>>& processes, Game& game, GameServer* server, GameClient* client,
                                   MetaServer* metaServer, MetaClient* metaClient) -> void {
+	const auto budget = std::chrono::microseconds{process_budget};
 	const auto end = processes.size();
 	for (auto i = std::size_t{0}; i < end; ++i) {
 		auto& process = processes[i];
 		assert(process);
-		this->output(process->run(game, server, client, metaServer, metaClient));
+		if (process->blocked(m_time)) {
+			continue;
+		}
+		this->output(process->runFor(budget, game, server, client, metaServer, metaClient));
 		assert(processes.size() >= end);
 		assert(process);
 		if (process->done()) {
@@ -6,6 +6,7 @@
 #include "command.hpp"               // cmd::...
 #include "environment.hpp"           // Environment
 #include "process.hpp"               // Process
+#include "script_profiler.hpp"       // ScriptProfiler
 #include "suggestions.hpp"           // Suggestions, SUGGESTIONS
 
 #include <cstddef>     // std::size_t, std::ptrdiff_t
@@ -45,6 +46,8 @@ public:
 	[[nodiscard]] auto getProcessCount() const noexcept -> std::size_t;
 	[[nodiscard]] auto rng() noexcept -> std::mt19937&;
 	[[nodiscard]] auto rng() const noexcept -> const std::mt19937&;
+	[[nodiscard]] auto profiler() noexcept -> ScriptProfiler&;
+	[[nodiscard]] auto profiler() const noexcept -> const ScriptProfiler&;
 	[[nodiscard]] auto started() const noexcept -> bool;
 	[[nodiscard]] auto getAllProcessIds() const -> std::vector<Process::Id>;
 
@@ -82,6 +85,7 @@ private:
 	std::mt19937 m_rng{std::random_device{}()};
 	std::uniform_int_distribution<int> m_intDistribution{};
 	std::uniform_real_distribution<float> m_floatDistribution{};
+	ScriptProfiler m_profiler{};
 	float m_time = 0.0f;
 	bool m_started = false;
 };
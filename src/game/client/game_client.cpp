@@ -1,6 +1,6 @@
 #include "game_client.hpp"
 
-#include "../../console/commands/file_commands.hpp"             // data_dir, data_subdir_maps, data_subdir_sounds, data_subdir_screens
+#include "../../console/commands/file_commands.hpp"             // data_dir, data_subdir_maps, data_subdir_sounds, data_subdir_screens, data_subdir_cache
 #include "../../console/commands/game_client_commands.hpp"      // address, port, username, password, cl_...
 #include "../../console/commands/game_commands.hpp"             // game_version
 #include "../../console/commands/inventory_client_commands.hpp" // cvar_hat
@@ -28,6 +28,8 @@
 #include <cassert>      // assert
 #include <chrono>       // std::chrono::..
 #include <cmath>        // std::ceil, std::round, std::sqrt
+#include <cstdint>      // std::uint32_t
+#include <filesystem>   // std::filesystem::exists, std::filesystem::remove
 #include <fmt/core.h>   // fmt::format
 #include <ios>          // std::ios
 #include <ratio>        // std::milli
@@ -39,6 +41,29 @@ constexpr auto CLIENT_COLOR_BORDER = Color::white();
 constexpr auto CLIENT_COLOR_EVENT_MESSAGE = Color::gray();
 constexpr auto CLIENT_COLOR_EVENT_MESSAGE_PERSONAL = Color::white();
 
+// Cached files are named after their contents, so that a file is only ever downloaded once no matter which name or server it came from.
+[[nodiscard]] auto getResourceCacheFilepath(util::CRC32 fileHash, std::size_t size) -> std::string {
+	return fmt::format("{}/{}/{:08x}-{}", data_dir, data_subdir_cache, static_cast<std::uint32_t>(fileHash), size);
+}
+
+// Incomplete downloads are kept next to the cache so that they can be resumed after a dropped connection.
+[[nodiscard]] auto getResourcePartialFilepath(util::CRC32 fileHash, std::size_t size) -> std::string {
+	return fmt::format("{}.part", getResourceCacheFilepath(fileHash, size));
+}
+
+[[nodiscard]] auto getResourceWriteMode(bool isText) -> std::ios::openmode {
+	return (isText) ? std::ios::trunc : std::ios::trunc | std::ios::binary;
+}
+
+auto cacheResource(util::CRC32 fileHash, std::string_view data, bool isText) -> void {
+	const auto filepath = getResourceCacheFilepath(fileHash, data.size());
+	if (auto ec = std::error_code{}; !std::filesystem::exists(filepath, ec)) {
+		if (!util::dumpFile(filepath, data, getResourceWriteMode(isText))) {
+			DEBUG_MSG(Msg::CLIENT, "Game client: Failed to write resource cache file \"{}\".", filepath);
+		}
+	}
+}
+
 } // namespace
 
 auto GameClient::getConfigHeader() -> std::string {
@@ -814,40 +839,29 @@ auto GameClient::handleMessage(msg::cl::in::ServerInfo&& msg) -> void {
 
 	// Check resources.
 	for (const auto& resource : msg.resources) {
-		const auto filepath = fmt::format("{}/{}", data_dir, resource.name);
-		if (!util::pathIsBelowDirectory(filepath, data_dir)) {
+		const auto status = this->findResource(resource);
+		if (status == ResourceStatus::INVALID_PATH) {
 			m_connection.disconnect("Server tried to access a resource outside of the game directory.");
 			return;
 		}
 
-		const auto openmode = (resource.isText) ? std::ios::in : std::ios::in | std::ios::binary;
-
-		auto buf = util::readFile(filepath, openmode);
-		if (!buf) {
-			const auto filepathInDownloads = fmt::format("{}/{}/{}", data_dir, data_subdir_downloads, resource.name);
-			if (!util::pathIsBelowDirectory(filepathInDownloads, fmt::format("{}/{}", data_dir, data_subdir_downloads))) {
-				m_connection.disconnect("Server tried to access a resource outside of the game directory.");
-				return;
-			}
-			buf = util::readFile(filepathInDownloads, openmode);
-		}
-		if (buf) {
-			if (util::CRC32{util::asBytes(util::Span{*buf})} != resource.fileHash) {
-				const auto resourceName = net::sanitizeMessage(resource.name);
-				if (cl_allow_resource_download) {
-					if (resource.canDownload) {
-						m_connection.disconnect(
-							fmt::format("Your version of {} differs from the server's. Remove the file to download the server's version.", resourceName));
-					} else {
-						m_connection.disconnect(
-							fmt::format("Your version of {} differs from the server's. The server does not provide the file for download.", resourceName));
-					}
+		if (status == ResourceStatus::MISMATCH) {
+			const auto resourceName = net::sanitizeMessage(resource.name);
+			if (cl_allow_resource_download) {
+				if (resource.canDownload) {
+					m_connection.disconnect(
+						fmt::format("Your version of {} differs from the server's. Remove the file to download the server's version.", resourceName));
 				} else {
-					m_connection.disconnect(fmt::format("Your version of {} differs from the server's. Resource downloads are disabled.", resourceName));
+					m_connection.disconnect(
+						fmt::format("Your version of {} differs from the server's. The server does not provide the file for download.", resourceName));
 				}
-				return;
+			} else {
+				m_connection.disconnect(fmt::format("Your version of {} differs from the server's. Resource downloads are disabled.", resourceName));
 			}
-		} else {
+			return;
+		}
+
+		if (status == ResourceStatus::MISSING) {
 			const auto resourceName = net::sanitizeMessage(resource.name);
 			if (cl_allow_resource_download) {
 				if (resource.canDownload) {
@@ -857,7 +871,7 @@ auto GameClient::handleMessage(msg::cl::in::ServerInfo&& msg) -> void {
 						return;
 					}
 
-					m_resourceDownloadQueue.emplace_back(resource.name, resource.nameHash, resource.fileHash, resource.size, resource.isText);
+					m_resourceDownloadQueue.emplace_back(resource.name, resource.nameHash, resource.fileHash, resource.size, resource.isText, false);
 				} else {
 					m_connection.disconnect(fmt::format("Missing resource {}. The server does not provide the file for download.", resourceName));
 					return;
@@ -1001,8 +1015,11 @@ auto GameClient::handleMessage(msg::cl::in::PlaySoundPositionalReliable&& msg) -
 }
 
 auto GameClient::handleMessage(msg::cl::in::ResourceDownloadPart&& msg) -> void {
-	if (m_resourceDownloadQueue.empty() || m_resourceDownloadQueue.front().nameHash != msg.nameHash) {
-		m_connection.disconnect("Server tried to send an unknown resource.");
+	// Parts that don't continue the current download are left over from a request that was replaced by a newer one, such as when the map
+	// changes in the middle of a prefetch.
+	if (m_resourceDownloadQueue.empty() || m_resourceDownloadQueue.front().nameHash != msg.nameHash ||
+	    m_resourceDownloadQueue.front().data.size() != msg.offset) {
+		DEBUG_MSG(Msg::CLIENT, "Game client: Ignoring stale resource part at offset {}.", msg.offset);
 		return;
 	}
 
@@ -1015,21 +1032,33 @@ auto GameClient::handleMessage(msg::cl::in::ResourceDownloadPart&& msg) -> void
 		return;
 	}
 	resourceDownload.data.insert(resourceDownload.data.end(), msg.part.begin(), msg.part.end());
+
+	// Losing the partial file only means that the download can't be resumed, so it is not an error.
+	if (!util::dumpFile(getResourcePartialFilepath(resourceDownload.fileHash, resourceDownload.size), msg.part, std::ios::app | std::ios::binary)) {
+		DEBUG_MSG(Msg::CLIENT, "Game client: Failed to save partial download of \"{}\".", resourceName);
+	}
+
 	auto message = fmt::format("Downloading {} ({}/{})...", resourceName, newSize, resourceDownload.size);
 	INFO_MSG(Msg::CLIENT, "{}", message);
-	m_game.println(std::move(message));
+	if (!resourceDownload.prefetch) {
+		m_game.println(std::move(message));
+	}
 }
 
 auto GameClient::handleMessage(msg::cl::in::ResourceDownloadLast&& msg) -> void {
-	if (m_resourceDownloadQueue.empty() || m_resourceDownloadQueue.front().nameHash != msg.nameHash) {
-		m_connection.disconnect("Server tried to send an unknown resource.");
+	if (m_resourceDownloadQueue.empty() || m_resourceDownloadQueue.front().nameHash != msg.nameHash ||
+	    m_resourceDownloadQueue.front().data.size() != msg.offset) {
+		DEBUG_MSG(Msg::CLIENT, "Game client: Ignoring stale resource part at offset {}.", msg.offset);
 		return;
 	}
 
 	auto& resourceDownload = m_resourceDownloadQueue.front();
 	const auto resourceName = net::sanitizeMessage(resourceDownload.name);
+	const auto partialFilepath = getResourcePartialFilepath(resourceDownload.fileHash, resourceDownload.size);
 	const auto newSize = resourceDownload.data.size() + msg.part.size();
 	if (cl_max_resource_download_size != 0 && newSize != resourceDownload.size) {
+		auto ec = std::error_code{};
+		std::filesystem::remove(partialFilepath, ec);
 		m_connection.disconnect(
 			fmt::format("Resource \"{}\" did not match the expected download size ({}/{}).", resourceName, newSize, resourceDownload.size));
 		return;
@@ -1038,22 +1067,65 @@ auto GameClient::handleMessage(msg::cl::in::ResourceDownloadLast&& msg) -> void
 
 	auto message = fmt::format("Downloaded {} ({} bytes).", resourceName, newSize);
 	INFO_MSG(Msg::CLIENT, "{}", message);
-	m_game.println(std::move(message));
+	if (!resourceDownload.prefetch) {
+		m_game.println(std::move(message));
+	}
+
+	auto ec = std::error_code{};
+	std::filesystem::remove(partialFilepath, ec);
 	if (util::CRC32{util::asBytes(util::Span{resourceDownload.data})} != resourceDownload.fileHash) {
 		m_connection.disconnect(fmt::format("Resource \"{}\" did not match the expected hash.", resourceName));
 		return;
 	}
 
-	const auto openmode = (resourceDownload.isText) ? std::ios::trunc : std::ios::trunc | std::ios::binary;
-	if (!util::dumpFile(fmt::format("{}/{}/{}", data_dir, data_subdir_downloads, resourceDownload.name), resourceDownload.data, openmode)) {
+	cacheResource(resourceDownload.fileHash, resourceDownload.data, resourceDownload.isText);
+	if (!util::dumpFile(fmt::format("{}/{}/{}", data_dir, data_subdir_downloads, resourceDownload.name),
+	                    resourceDownload.data,
+	                    getResourceWriteMode(resourceDownload.isText))) {
 		m_connection.disconnect(fmt::format("Failed to write file for resource \"{}\"!", resourceName));
 		return;
 	}
 
+	const auto prefetch = resourceDownload.prefetch;
 	m_resourceDownloadQueue.pop_front();
-	if (m_resourceDownloadQueue.empty()) {
-		this->joinGame();
+	if (!m_resourceDownloadQueue.empty()) {
+		this->downloadNextResourceInQueue();
+	} else if (prefetch) {
+		INFO_MSG(Msg::CLIENT, "Game client: Finished prefetching resources for the next map.");
 	} else {
+		this->joinGame();
+	}
+}
+
+auto GameClient::handleMessage(msg::cl::in::ResourcePrefetch&& msg) -> void {
+	if (!cl_allow_resource_download || !cl_resource_prefetch || !m_resourceDownloadQueue.empty()) {
+		return;
+	}
+
+	auto totalDownloadSize = std::size_t{0};
+	for (const auto& resource : msg.resources) {
+		if (!resource.canDownload) {
+			continue;
+		}
+
+		if (cl_max_resource_download_size != 0 && resource.size > static_cast<std::size_t>(cl_max_resource_download_size)) {
+			continue;
+		}
+
+		if (cl_max_resource_total_download_size != 0 &&
+		    totalDownloadSize + resource.size > static_cast<std::size_t>(cl_max_resource_total_download_size)) {
+			continue;
+		}
+
+		// Anything we can't download now will be dealt with as usual when the map actually changes.
+		if (this->findResource(resource) == ResourceStatus::MISSING) {
+			m_resourceDownloadQueue.emplace_back(resource.name, resource.nameHash, resource.fileHash, resource.size, resource.isText, true);
+			totalDownloadSize += resource.size;
+		}
+	}
+
+	if (!m_resourceDownloadQueue.empty()) {
+		INFO_MSG(Msg::CLIENT, "Game client: Prefetching resources for the next map ({} bytes total).", totalDownloadSize);
 		this->downloadNextResourceInQueue();
 	}
 }
@@ -1116,10 +1188,61 @@ auto GameClient::write(msg::sv::out::RemoteConsoleLogout&& msg) -> bool {
 	return this->writeToGameServer(msg);
 }
 
+auto GameClient::findResource(const ResourceInfo& resource) -> ResourceStatus {
+	const auto filepath = fmt::format("{}/{}", data_dir, resource.name);
+	const auto downloadsDirectory = fmt::format("{}/{}", data_dir, data_subdir_downloads);
+	const auto filepathInDownloads = fmt::format("{}/{}", downloadsDirectory, resource.name);
+	if (!util::pathIsBelowDirectory(filepath, data_dir) || !util::pathIsBelowDirectory(filepathInDownloads, downloadsDirectory)) {
+		return ResourceStatus::INVALID_PATH;
+	}
+
+	const auto openmode = (resource.isText) ? std::ios::in : std::ios::in | std::ios::binary;
+	if (const auto buf = util::readFile(filepath, openmode)) {
+		return (util::CRC32{util::asBytes(util::Span{*buf})} == resource.fileHash) ? ResourceStatus::AVAILABLE : ResourceStatus::MISMATCH;
+	}
+
+	if (const auto buf = util::readFile(filepathInDownloads, openmode)) {
+		const auto fileHash = util::CRC32{util::asBytes(util::Span{*buf})};
+		if (fileHash == resource.fileHash) {
+			return ResourceStatus::AVAILABLE;
+		}
+
+		// Some other server uses a different version of this file. Keep it in the cache in case we go back there.
+		cacheResource(fileHash, *buf, resource.isText);
+	}
+
+	if (const auto buf = util::readFile(getResourceCacheFilepath(resource.fileHash, resource.size), openmode)) {
+		if (util::CRC32{util::asBytes(util::Span{*buf})} == resource.fileHash &&
+		    util::dumpFile(filepathInDownloads, *buf, getResourceWriteMode(resource.isText))) {
+			INFO_MSG(Msg::CLIENT, "Game client: Found resource \"{}\" in the cache.", net::sanitizeMessage(resource.name));
+			return ResourceStatus::AVAILABLE;
+		}
+	}
+	return ResourceStatus::MISSING;
+}
+
 auto GameClient::downloadNextResourceInQueue() -> void {
 	assert(!m_resourceDownloadQueue.empty());
-	INFO_MSG(Msg::CLIENT, "Game client: Acquiring resource \"{}\" from server.", net::sanitizeMessage(m_resourceDownloadQueue.front().name));
-	if (!this->writeToGameServer(msg::sv::out::ResourceDownloadRequest{{}, m_resourceDownloadQueue.front().nameHash})) {
+	auto& resourceDownload = m_resourceDownloadQueue.front();
+
+	// Pick up where an earlier attempt left off, if any.
+	resourceDownload.data.clear();
+	const auto partialFilepath = getResourcePartialFilepath(resourceDownload.fileHash, resourceDownload.size);
+	if (auto partial = util::readFile(partialFilepath, std::ios::in | std::ios::binary)) {
+		if (partial->size() < resourceDownload.size) {
+			resourceDownload.data = std::move(*partial);
+		} else {
+			auto ec = std::error_code{};
+			std::filesystem::remove(partialFilepath, ec);
+		}
+	}
+
+	INFO_MSG(Msg::CLIENT,
+	         "Game client: Acquiring resource \"{}\" from server, starting at {}/{} bytes.",
+	         net::sanitizeMessage(resourceDownload.name),
+	         resourceDownload.data.size(),
+	         resourceDownload.size);
+	if (!this->writeToGameServer(msg::sv::out::ResourceDownloadRequest{{}, resourceDownload.nameHash, resourceDownload.data.size()})) {
 		m_connection.disconnect("Failed to write resource download request.");
 	}
 }
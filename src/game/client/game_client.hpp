@@ -24,12 +24,14 @@
 #include "../data/vector.hpp"                 // Vec2, Vector2
 #include "../shared/game_client_messages.hpp" // GameClientInputMessages, msg::cl::in::...
 #include "../shared/game_server_messages.hpp" // GameServerOutputMessages, msg::sv::out::...
+#include "../shared/resource_info.hpp"        // ResourceInfo
 #include "../shared/snapshot.hpp"             // Snapshot
 #include "inventory_client.hpp"               // InventoryClient
 #include "remote_console_client.hpp"          // RemoteConsoleClient
 
 #include <SDL.h>       // SDL_...
 #include <cstddef>     // std::byte, std::size_t
+#include <cstdint>     // std::uint8_t
 #include <deque>       // std::deque
 #include <string>      // std::string
 #include <string_view> // std::string_view
@@ -110,12 +112,13 @@ private:
 
 	struct ResourceDownload final {
 		ResourceDownload() noexcept = default;
-		ResourceDownload(std::string name, util::CRC32 nameHash, util::CRC32 fileHash, std::size_t size, bool isText)
+		ResourceDownload(std::string name, util::CRC32 nameHash, util::CRC32 fileHash, std::size_t size, bool isText, bool prefetch)
 			: name(std::move(name))
 			, nameHash(nameHash)
 			, fileHash(fileHash)
 			, size(size)
-			, isText(isText) {}
+			, isText(isText)
+			, prefetch(prefetch) {}
 
 		std::string data;
 		std::string name;
@@ -123,9 +126,17 @@ private:
 		util::CRC32 fileHash;
 		std::size_t size = 0;
 		bool isText = false;
+		bool prefetch = false; // Downloaded in the background for the next map, rather than needed to join.
 	};
 	using ResourceDownloadQueue = std::deque<ResourceDownload>;
 
+	enum class ResourceStatus : std::uint8_t {
+		AVAILABLE,    // Found locally with the right contents.
+		MISSING,      // Has to be downloaded.
+		MISMATCH,     // A game data file with different contents is in the way.
+		INVALID_PATH, // The resource name points outside of the data directory.
+	};
+
 	template <typename Message>
 	[[nodiscard]] auto writeToGameServer(const Message& msg) -> bool {
 		return m_connection.write<GameServerOutputMessages>(msg);
@@ -149,6 +160,7 @@ private:
 	auto handleMessage(msg::cl::in::PlaySoundPositionalReliable&& msg) -> void;
 	auto handleMessage(msg::cl::in::ResourceDownloadPart&& msg) -> void;
 	auto handleMessage(msg::cl::in::ResourceDownloadLast&& msg) -> void;
+	auto handleMessage(msg::cl::in::ResourcePrefetch&& msg) -> void;
 	auto handleMessage(msg::cl::in::PlayerTeamSelected&& msg) -> void;
 	auto handleMessage(msg::cl::in::PlayerClassSelected&& msg) -> void;
 	auto handleMessage(msg::cl::in::CommandOutput&& msg) -> void;
@@ -167,6 +179,7 @@ private:
 	auto write(msg::sv::out::RemoteConsoleAbortCommand&& msg) -> bool override;
 	auto write(msg::sv::out::RemoteConsoleLogout&& msg) -> bool override;
 
+	[[nodiscard]] auto findResource(const ResourceInfo& resource) -> ResourceStatus;
 	auto downloadNextResourceInQueue() -> void;
 	auto joinGame() -> void;
 	auto receivePackets() -> void;
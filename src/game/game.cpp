@@ -3,6 +3,7 @@
 #include "../console/command.hpp"                // cmd::...
 #include "../console/commands/file_commands.hpp" // data_dir, data_subdir_images, data_subdir_fonts, data_subdir_shaders
 #include "../console/commands/game_commands.hpp" // console_max_rows, host_..., r_..., fps_max, cvar_main, cvar_game, cmd_host_writeconfig, cmd_quit, cmd_say, cmd_say_team, headless
+#include "../console/commands/game_server_commands.hpp"   // sv_sleep_until_tick
 #include "../console/commands/process_commands.hpp"       // cmd_import, cmd_file, cmd_script
 #include "../console/commands/sound_manager_commands.hpp" // volume, snd_rolloff, snd_max_simultaneous
 #include "../console/con_command.hpp"                     // ConCommand, GET_COMMAND
@@ -772,7 +773,8 @@ auto Game::autoComplete(gui::TextInput& textInput) -> void {
 			auto candidates = Suggestions{};
 
 			// Check aliases.
-			for (const auto& [name, alias] : m_vm.getGlobalEnv().aliases) {
+			for (const auto& [symbol, alias] : m_vm.getGlobalEnv().aliases) {
+				const auto& name = symbol->name;
 				if (name == command.front().value) {
 					this->println(fmt::format("alias {} {{{}}}", name, Script::commandString(alias)), Color::gray());
 					m_console.resetScroll();
@@ -784,11 +786,12 @@ auto Game::autoComplete(gui::TextInput& textInput) -> void {
 			}
 
 			// Check local objects.
-			for (const auto& [name, obj] : m_vm.getGlobalEnv().objects) {
+			for (const auto& [symbol, obj] : m_vm.getGlobalEnv().objects) {
+				const auto& name = symbol->name;
 				if (name == command.front().value) {
 					this->println(util::match(obj)(
 									  [&, &name = name](const Environment::Variable& var) {
-										  return fmt::format("var {} {}", name, Script::escapedString(var.value));
+										  return fmt::format("var {} {}", name, Script::escapedString(var.text()));
 									  },
 									  [&, &name = name](const Environment::Constant& constant) {
 										  return fmt::format("const {} {}", name, Script::escapedString(constant.value));
@@ -1214,12 +1217,25 @@ auto Game::runHeadless() -> void {
 	try {
 		auto lastFrameTime = Clock::now();
 		while (m_running) {
+			// A dedicated server runs a frame as soon as its next tick is due or a packet arrives, whichever comes first.
+			// fps_max then only limits how long it may sleep, so that queued commands and other subsystems still get to run.
+			const auto scheduled = m_server && sv_sleep_until_tick;
+			if (scheduled) {
+				auto timeout = std::chrono::ceil<Duration>(std::chrono::duration<float>{m_server->getTimeUntilNextTick() / host_timescale});
+				if (m_frameInterval > Duration::zero()) {
+					timeout = std::min(timeout, m_frameInterval);
+				}
+				if (timeout > Duration::zero()) {
+					m_server->waitForPackets(timeout);
+				}
+			}
+
 			// Get time delta since last "real" frame.
 			const auto thisTime = Clock::now();
 			const auto clockDeltaTime = thisTime - lastFrameTime;
 
 			// Check if we're under the framerate limit.
-			if (clockDeltaTime < m_frameInterval) {
+			if (!scheduled && clockDeltaTime < m_frameInterval) {
 				// Sleep until next frame. Headless mode is not as timing critical as graphical mode.
 				if (const auto timeUntilNextFrame = m_frameInterval - clockDeltaTime; timeUntilNextFrame > 1ms) {
 					std::this_thread::sleep_for(timeUntilNextFrame);
@@ -184,16 +184,16 @@ auto MetaClient::getStatusString() const -> std::string {
 
 auto MetaClient::refresh() noexcept -> bool {
 	m_pendingGameServerEndpoints.clear();
-	m_gameServerEndpoints.clear();
-	m_metaInfo.clear();
-	m_hasReceivedGameServerEndpoints = false;
 	if (m_stopping || m_metaServerConnection.disconnecting()) {
 		return false;
 	}
 
 	if (m_metaServerConnection.connected()) {
-		if (!this->writeToMetaServer(msg::meta::sv::out::GameServerAddressListRequest{{}})) {
-			INFO_MSG(Msg::CLIENT | Msg::CONNECTION_EVENT, "Meta client: Failed to write game server address list request.");
+		if (m_receivingServerList) {
+			return true;
+		}
+		if (!this->writeServerListRequest()) {
+			INFO_MSG(Msg::CLIENT | Msg::CONNECTION_EVENT, "Meta client: Failed to write game server list request.");
 			return false;
 		}
 	} else if (m_metaServerConnection.disconnected()) {
@@ -232,8 +232,13 @@ auto MetaClient::gameServerEndpoints() const noexcept -> util::Span<const net::I
 auto MetaClient::handleMessage(net::msg::in::Connect&&) -> void {
 	if (m_currentGameServer == m_gameServerConnections.end()) {
 		INFO_MSG(Msg::CLIENT, "Meta client: Meta server \"{}\" connected.", std::string{m_metaServerConnection.getRemoteEndpoint()});
-		if (!this->writeToMetaServer(msg::meta::sv::out::GameServerAddressListRequest{{}})) {
-			m_metaServerConnection.disconnect("Failed to write game server address list request.");
+
+		// The versions of a previous connection mean nothing to this one.
+		m_serverListCursor.reset();
+		m_serverListVersion = 0;
+		m_receivingServerList = false;
+		if (!this->writeServerListRequest()) {
+			m_metaServerConnection.disconnect("Failed to write game server list request.");
 		}
 	} else {
 		INFO_MSG(Msg::CLIENT, "Meta client: Game server \"{}\" connected.", std::string{m_currentGameServer->connection.getRemoteEndpoint()});
@@ -245,16 +250,62 @@ auto MetaClient::handleMessage(net::msg::in::Connect&&) -> void {
 	}
 }
 
-auto MetaClient::handleMessage(msg::meta::cl::in::GameServerAddressList&& msg) -> void {
-	if (m_currentGameServer == m_gameServerConnections.end()) {
-		m_gameServerEndpoints = std::move(msg.endpoints);
-		m_pendingGameServerEndpoints = m_gameServerEndpoints;
-		m_hasReceivedGameServerEndpoints = true;
-	} else {
+auto MetaClient::handleMessage(msg::meta::cl::in::GameServerList&& msg) -> void {
+	if (m_currentGameServer != m_gameServerConnections.end()) {
 		INFO_MSG(Msg::CLIENT | Msg::CONNECTION_EVENT,
-		         "Meta client: Received unrequested game server address list from bad game server \"{}\".",
+		         "Meta client: Received unrequested game server list from bad game server \"{}\".",
 		         std::string{m_currentGameServer->connection.getRemoteEndpoint()});
 		m_currentGameServer->connection.disconnect("Invalid message.");
+		return;
+	}
+
+	if (!m_receivingServerList) {
+		INFO_MSG(Msg::CLIENT | Msg::CONNECTION_EVENT, "Meta client: Ignoring unrequested game server list from meta server.");
+		return;
+	}
+
+	if (!m_serverListCursor) {
+		// Changes that happen while we are fetching the remaining pages will be included in the next refresh.
+		m_receivingServerListVersion = msg.version;
+		if (msg.full) {
+			m_metaInfo.clear();
+		}
+	}
+
+	for (const auto& endpoint : msg.removed) {
+		util::eraseIf(m_metaInfo, [&](const auto& metaInfo) { return metaInfo.info.endpoint == endpoint; });
+	}
+
+	for (auto& server : msg.servers) {
+		if (const auto it = this->findMetaInfo(server.endpoint); it != m_metaInfo.end()) {
+			it->info = std::move(server);
+		} else {
+			m_metaInfo.emplace_back(std::move(server));
+		}
+	}
+
+	if (msg.more && !msg.servers.empty()) {
+		m_serverListCursor = msg.servers.back().endpoint;
+		if (!this->writeServerListRequest()) {
+			m_metaServerConnection.disconnect("Failed to write game server list request.");
+		}
+		return;
+	}
+
+	INFO_MSG(Msg::CLIENT, "Meta client: Received game server list (version {}).", m_receivingServerListVersion);
+	m_serverListCursor.reset();
+	m_serverListVersion = m_receivingServerListVersion;
+	m_receivingServerList = false;
+
+	m_gameServerEndpoints.clear();
+	for (const auto& metaInfo : m_metaInfo) {
+		m_gameServerEndpoints.push_back(metaInfo.info.endpoint);
+	}
+	m_hasReceivedGameServerEndpoints = true;
+
+	// Only contact the game servers directly if we need to know our ping to them.
+	if (meta_cl_ping_servers) {
+		m_pendingGameServerEndpoints = m_gameServerEndpoints;
 	}
 }
 
@@ -270,7 +321,18 @@ auto MetaClient::handleMessage(msg::meta::cl::in::MetaInfo&& msg) -> void {
 			const auto ping = now - m_currentGameServer->metaInfoRequestSendTime;
 			const auto endpoint = m_currentGameServer->connection.getRemoteEndpoint();
 			INFO_MSG(Msg::CLIENT, "Meta client: Received meta info from game server \"{}\".", std::string{endpoint});
-			m_metaInfo.emplace_back(std::move(msg), endpoint, ping);
+			if (const auto it = this->findMetaInfo(endpoint); it != m_metaInfo.end()) {
+				it->info = ServerListEntry{{},
+				                           endpoint,
+				                           msg.tickrate,
+				                           msg.playerCount,
+				                           msg.botCount,
+				                           msg.maxPlayerCount,
+				                           std::move(msg.mapName),
+				                           std::move(msg.hostName),
+				                           std::move(msg.gameVersion)};
+				it->ping = ping;
+			}
 			util::erase(m_pendingGameServerEndpoints, endpoint);
 			m_currentGameServer->connection.disconnect("Meta info fetch finished.");
 		}
@@ -342,11 +404,41 @@ auto MetaClient::sendPackets() -> void {
 	}
 }
 
+auto MetaClient::writeServerListRequest() -> bool {
+	if (!m_serverListCursor) {
+		auto filter = ServerListFilterFlags{SERVER_LIST_FILTER_NONE};
+		if (meta_cl_filter_not_empty) {
+			filter |= SERVER_LIST_FILTER_NOT_EMPTY;
+		}
+		if (meta_cl_filter_not_full) {
+			filter |= SERVER_LIST_FILTER_NOT_FULL;
+		}
+		if (!meta_cl_filter_map.empty()) {
+			filter |= SERVER_LIST_FILTER_MAP;
+		}
+
+		// The changes since our version are relative to the old filter, so start over if it has changed.
+		if (filter != m_serverListFilter || m_serverListMapName != std::string_view{meta_cl_filter_map}) {
+			m_serverListFilter = filter;
+			m_serverListMapName = std::string{meta_cl_filter_map};
+			m_serverListVersion = 0;
+		}
+	}
+
+	m_receivingServerList = true;
+	return this->writeToMetaServer(
+		msg::meta::sv::out::GameServerListRequest{{}, m_serverListVersion, m_serverListCursor, m_serverListFilter, m_serverListMapName});
+}
+
 auto MetaClient::findGameServer(net::IpEndpoint endpoint) noexcept -> GameServers::iterator {
 	return util::findIf(m_gameServerConnections,
 	                    [endpoint](const auto& gameServer) { return gameServer.connection.getRemoteEndpoint() == endpoint; });
 }
 
+auto MetaClient::findMetaInfo(net::IpEndpoint endpoint) noexcept -> std::vector<ReceivedMetaInfo>::iterator {
+	return util::findIf(m_metaInfo, [endpoint](const auto& metaInfo) { return metaInfo.info.endpoint == endpoint; });
+}
+
 auto MetaClient::connectPending(net::IpEndpoint endpoint) -> bool {
 	if (m_gameServerCooldowns.count(endpoint) != 0) {
 		return false;
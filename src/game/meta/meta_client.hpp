@@ -11,8 +11,11 @@
 #include "../shared/game_server_messages.hpp" // GameServerOutputMessages, msg::sv::out::...
 #include "meta_client_messages.hpp"           // MetaClientInputMessages, msg::meta::cl::in::...
 #include "meta_server_messages.hpp"           // MetaServerOutputMessages, msg::meta::sv::out::...
+#include "server_list_entry.hpp"              // ServerListEntry, ServerListFilterFlags
 
-#include <cstdint>       // std::uint8_t
+#include <cstdint>       // std::uint8_t, std::uint32_t
+#include <optional>      // std::optional
+#include <string>        // std::string
 #include <unordered_map> // std::unordered_map
 #include <utility>       // std::move, std::forward
 #include <vector>        // std::vector
@@ -22,15 +25,12 @@ class Game;
 class MetaClient final {
 public:
 	struct ReceivedMetaInfo final {
-		msg::meta::cl::in::MetaInfo info{};
-		net::IpEndpoint endpoint{};
-		net::Duration ping = net::Duration::zero();
+		ServerListEntry info{};
+		std::optional<net::Duration> ping{}; // Only measured if the meta client is set to ping game servers.
 
 		ReceivedMetaInfo() noexcept = default;
-		ReceivedMetaInfo(msg::meta::cl::in::MetaInfo&& info, net::IpEndpoint endpoint, net::Duration ping)
-			: info(std::move(info))
-			, endpoint(endpoint)
-			, ping(ping) {}
+		explicit ReceivedMetaInfo(ServerListEntry&& info)
+			: info(std::move(info)) {}
 	};
 
 	explicit MetaClient(Game& game);
@@ -98,14 +98,17 @@ private:
 	}
 
 	auto handleMessage(net::msg::in::Connect&& msg) -> void;
-	auto handleMessage(msg::meta::cl::in::GameServerAddressList&& msg) -> void;
+	auto handleMessage(msg::meta::cl::in::GameServerList&& msg) -> void;
 	auto handleMessage(msg::meta::cl::in::MetaInfo&& msg) -> void;
 
 	auto receivePackets() -> void;
 	auto updateConnections() -> void;
 	auto sendPackets() -> void;
 
+	[[nodiscard]] auto writeServerListRequest() -> bool;
+
 	[[nodiscard]] auto findGameServer(net::IpEndpoint endpoint) noexcept -> GameServers::iterator;
+	[[nodiscard]] auto findMetaInfo(net::IpEndpoint endpoint) noexcept -> std::vector<ReceivedMetaInfo>::iterator;
 
 	[[nodiscard]] auto connectPending(net::IpEndpoint endpoint) -> bool;
 
@@ -118,6 +121,12 @@ private:
 	std::vector<net::IpEndpoint> m_pendingGameServerEndpoints{};
 	std::vector<ReceivedMetaInfo> m_metaInfo{};
 	GameServerCooldowns m_gameServerCooldowns{};
+	std::string m_serverListMapName{};
+	std::optional<net::IpEndpoint> m_serverListCursor{}; // Last endpoint of the latest page while receiving the server list.
+	std::uint32_t m_serverListVersion = 0;                // Version of the server list that we have.
+	std::uint32_t m_receivingServerListVersion = 0;       // Version of the server list that we are currently receiving.
+	ServerListFilterFlags m_serverListFilter = SERVER_LIST_FILTER_NONE;
+	bool m_receivingServerList = false;
 	float m_sendInterval = 0.0f;
 	util::CountupLoop<float> m_sendTimer{};
 	bool m_stopping = false;
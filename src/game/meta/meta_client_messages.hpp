@@ -6,6 +6,7 @@
 #include "../../network/message_layout.hpp" // net::List, net::String
 #include "../../utilities/type_list.hpp"    // util::TypeList
 #include "../data/tickrate.hpp"             // Tickrate
+#include "server_list_entry.hpp"            // ServerListEntry
 
 #include <cstdint> // std::uint32_t
 #include <tuple>   // std::tie
@@ -15,15 +16,19 @@ namespace meta {
 namespace cl {
 
 template <net::MessageDirection DIR>
-struct GameServerAddressList final : net::SecretMessage<GameServerAddressList<DIR>, DIR> {
-	net::List<net::IpEndpoint, DIR> endpoints{};
+struct GameServerList final : net::SecretMessage<GameServerList<DIR>, DIR> {
+	std::uint32_t version = 0;                 // Current version of the list.
+	bool full = false;                         // The list is complete instead of only containing changes since the requested version.
+	bool more = false;                         // There are more servers left to fetch after this page.
+	net::List<ServerListEntry, DIR> servers{}; // Servers that were added or changed, sorted by endpoint.
+	net::List<net::IpEndpoint, DIR> removed{}; // Servers that were removed or no longer match the filter.
 
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie(endpoints);
+		return std::tie(version, full, more, servers, removed);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie(endpoints);
+		return std::tie(version, full, more, servers, removed);
 	}
 };
 
@@ -48,14 +53,14 @@ struct MetaInfo final : net::SecretMessage<MetaInfo<DIR>, DIR> {
 
 namespace in {
 
-using GameServerAddressList = msg::meta::cl::GameServerAddressList<net::MessageDirection::INPUT>;
+using GameServerList = msg::meta::cl::GameServerList<net::MessageDirection::INPUT>;
 using MetaInfo = msg::meta::cl::MetaInfo<net::MessageDirection::INPUT>;
 
 } // namespace in
 
 namespace out {
 
-using GameServerAddressList = msg::meta::cl::GameServerAddressList<net::MessageDirection::OUTPUT>;
+using GameServerList = msg::meta::cl::GameServerList<net::MessageDirection::OUTPUT>;
 using MetaInfo = msg::meta::cl::MetaInfo<net::MessageDirection::OUTPUT>;
 
 } // namespace out
@@ -65,9 +70,9 @@ using MetaInfo = msg::meta::cl::MetaInfo<net::MessageDirection::OUTPUT>;
 } // namespace msg
 
 template <net::MessageDirection DIR>
-using MetaClientMessages = util::TypeList<     //
-	msg::meta::cl::GameServerAddressList<DIR>, // 0
-	msg::meta::cl::MetaInfo<DIR>               // 1
+using MetaClientMessages = util::TypeList< //
+	msg::meta::cl::GameServerList<DIR>,    // 0
+	msg::meta::cl::MetaInfo<DIR>           // 1
 	>;
 
 using MetaClientInputMessages = MetaClientMessages<net::MessageDirection::INPUT>;
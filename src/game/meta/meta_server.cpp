@@ -6,11 +6,13 @@
 #include "../../console/commands/process_commands.hpp"     // cmd_import, cmd_file
 #include "../../console/con_command.hpp"                   // GET_COMMAND
 #include "../../debug.hpp"                                 // Msg, INFO_MSG, INFO_MSG_INDENT, DEBUG_MSG_INDENT
-#include "../../utilities/algorithm.hpp"                   // util::erase, util::findIf, util::countIf
+#include "../../network/byte_stream.hpp"                   // net::ByteOutputStream
+#include "../../utilities/algorithm.hpp"                   // util::eraseIf, util::findIf, util::countIf
 #include "../../utilities/time.hpp"                        // util::getLocalTimeStr
 #include "../game.hpp"                                     // Game
 
 #include <algorithm>    // std::max
+#include <cassert>      // assert
 #include <chrono>       // std::chrono::...
 #include <fmt/core.h>   // fmt::format
 #include <system_error> // std::error_code
@@ -26,7 +28,8 @@ auto MetaServer::getConfigHeader() -> std::string {
 
 MetaServer::MetaServer(Game& game)
 	: m_game(game)
-	, m_currentClient(m_clients.end()) {
+	, m_currentClient(m_clients.end())
+	, m_cookieEpoch(net::Clock::now()) {
 	this->updateTimeout();
 	this->updateThrottle();
 	this->updateSpamLimit();
@@ -38,6 +41,13 @@ MetaServer::MetaServer(Game& game)
 auto MetaServer::init() -> bool {
 	INFO_MSG(Msg::SERVER, "Meta server: Initializing...");
 
+	// Generate the key that handshake cookies are signed with.
+	if (!crypto::init()) {
+		m_game.error("Failed to initialize crypto library.");
+		return false;
+	}
+	crypto::generateFastHashKey(m_cookieKey);
+
 	auto ec = std::error_code{};
 
 	// Bind socket.
@@ -241,22 +251,66 @@ auto MetaServer::handleMessage(net::msg::in::Connect&&) -> void {
 	m_currentClient->connecting = false;
 }
 
-auto MetaServer::handleMessage(msg::meta::sv::in::GameServerAddressListRequest&&) -> void {
-	if (this->testSpam()) {
+auto MetaServer::handleMessage(msg::meta::sv::in::GameServerListRequest&& msg) -> void {
+	// A request for the next page of a list that we just sent to this client doesn't count as potential spam, so that long lists can be fetched
+	// quickly. Any other request does, including ones with a cursor that we never handed out.
+	const auto nextPage = msg.after && msg.after == m_currentClient->nextPageCursor;
+	m_currentClient->nextPageCursor.reset();
+	if (!nextPage && this->testSpam()) {
 		return;
 	}
 
 	INFO_MSG(Msg::SERVER,
-	         "Meta server: Received game server address list request from client \"{}\".",
+	         "Meta server: Received game server list request (version {}) from client \"{}\".",
+	         msg.version,
 	         std::string{m_currentClient->connection.getRemoteEndpoint()});
 
 	m_currentClient->afkTimer.reset();
-	if (!m_currentClient->connection.write<MetaClientOutputMessages>(msg::meta::cl::out::GameServerAddressList{{}, m_gameServerAddressList})) {
-		this->disconnectClient(m_currentClient, "Failed to write game server address list.");
+
+	// Send the full list if the client doesn't have a version that we can send changes relative to.
+	const auto full = msg.version == 0 || msg.version < m_removedGameServersVersion || msg.version > m_gameServerListVersion;
+	const auto pageSize = static_cast<std::size_t>(meta_sv_server_list_page_size);
+
+	auto servers = std::vector<ServerListEntry>{};
+	auto removed = std::vector<net::IpEndpoint>{};
+	if (!full && !msg.after) {
+		for (const auto& server : m_removedGameServers) {
+			if (server.version > msg.version) {
+				removed.push_back(server.endpoint);
+			}
+		}
+	}
+
+	auto more = false;
+	for (auto it = (msg.after) ? m_gameServerList.upper_bound(*msg.after) : m_gameServerList.begin(); it != m_gameServerList.end(); ++it) {
+		const auto& [endpoint, server] = *it;
+		if (!full && server.version <= msg.version) {
+			continue;
+		}
+		if (!server.entry.matches(msg.filter, msg.mapName)) {
+			if (!full) {
+				removed.push_back(endpoint);
+			}
+			continue;
+		}
+		if (servers.size() >= pageSize) {
+			more = true;
+			break;
+		}
+		servers.push_back(server.entry);
+	}
+
+	if (more) {
+		m_currentClient->nextPageCursor = servers.back().endpoint;
+	}
+
+	if (!m_currentClient->connection.write<MetaClientOutputMessages>(
+			msg::meta::cl::out::GameServerList{{}, m_gameServerListVersion, full, more, servers, removed})) {
+		this->disconnectClient(m_currentClient, "Failed to write game server list.");
 	}
 }
 
-auto MetaServer::handleMessage(msg::meta::sv::in::Heartbeat&&) -> void {
+auto MetaServer::handleMessage(msg::meta::sv::in::Heartbeat&& msg) -> void {
 	if (this->testSpam()) {
 		return;
 	}
@@ -269,8 +323,16 @@ auto MetaServer::handleMessage(msg::meta::sv::in::Heartbeat&&) -> void {
 			endpoint = net::IpEndpoint{m_privateAddressOverride, endpoint.getPort()};
 		}
 		m_currentClient->listedEndpoint = endpoint;
-		m_gameServerAddressList.push_back(endpoint);
 	}
+	this->listGameServer(ServerListEntry{{},
+	                                     m_currentClient->listedEndpoint,
+	                                     msg.tickrate,
+	                                     msg.playerCount,
+	                                     msg.botCount,
+	                                     msg.maxPlayerCount,
+	                                     std::move(msg.mapName),
+	                                     std::move(msg.hostName),
+	                                     std::move(msg.gameVersion)});
 }
 
 auto MetaServer::testSpam() -> bool {
@@ -302,7 +364,9 @@ auto MetaServer::updateConfigAutoSave(float deltaTime) -> void {
 }
 
 auto MetaServer::receivePackets() -> void {
-	auto buffer = std::vector<std::byte>(net::MAX_PACKET_SIZE);
+	static constexpr auto BUFFER_SIZE = net::MAX_PACKET_SIZE + net::HandshakeCookie::SIZE;
+
+	auto buffer = std::vector<std::byte>(BUFFER_SIZE);
 	while (true) {
 		auto ec = std::error_code{};
 		auto remoteEndpoint = net::IpEndpoint{};
@@ -314,10 +378,20 @@ auto MetaServer::receivePackets() -> void {
 			break;
 		}
 
-		if (const auto it = this->findClient(remoteEndpoint); it != m_clients.end()) {
+		// Packets sent during the first part of the handshake are wrapped in an echo of the cookie that we sent.
+		auto cookie = net::HandshakeCookie{};
+		const auto hasCookie = cookie.read(util::Span{buffer}.first(receivedBytes), net::HandshakeCookie::ECHO_PROTOCOL_ID);
+		const auto receivePacket = [&](ClientInfo& client) {
 			buffer.resize(receivedBytes);
-			it->connection.receivePacket(std::move(buffer));
-			buffer.resize(net::MAX_PACKET_SIZE);
+			if (hasCookie) {
+				buffer.erase(buffer.begin(), buffer.begin() + net::HandshakeCookie::SIZE);
+			}
+			client.connection.receivePacket(std::move(buffer));
+			buffer.resize(BUFFER_SIZE);
+		};
+
+		if (const auto it = this->findClient(remoteEndpoint); it != m_clients.end()) {
+			receivePacket(*it);
 		} else if (m_connectingClients >= static_cast<std::size_t>(meta_sv_max_connecting_clients)) {
 			DEBUG_MSG(
 				Msg::CONNECTION_DETAILED,
@@ -336,6 +410,20 @@ auto MetaServer::receivePackets() -> void {
 			          "Meta server: Ignoring {} bytes from unconnected ip \"{}\" because the server is stopping!",
 			          receivedBytes,
 			          std::string{remoteEndpoint});
+		} else if (meta_sv_cookie_lifetime != 0.0f && !(hasCookie && this->verifyCookie(cookie, remoteEndpoint))) {
+			// Never answer with more bytes than we received, so that spoofed packets can't use us for amplification.
+			if (receivedBytes < net::HandshakeCookie::SIZE) {
+				DEBUG_MSG(Msg::CONNECTION_DETAILED,
+				          "Meta server: Ignoring {} bytes from unconnected ip \"{}\" because the packet is smaller than a handshake cookie!",
+				          receivedBytes,
+				          std::string{remoteEndpoint});
+			} else {
+				DEBUG_MSG(Msg::CONNECTION_DETAILED,
+				          "Meta server: Sending handshake cookie in response to {} bytes from unconnected ip \"{}\".",
+				          receivedBytes,
+				          std::string{remoteEndpoint});
+				this->sendCookie(remoteEndpoint);
+			}
 		} else {
 			const auto timeout = std::chrono::duration_cast<net::Duration>(std::chrono::duration<float>{static_cast<float>(meta_sv_timeout)});
 			auto& client = m_clients.emplace_back(m_socket, timeout, meta_sv_throttle_limit, meta_sv_throttle_max_period, *this);
@@ -347,11 +435,10 @@ auto MetaServer::receivePackets() -> void {
 					         client.connection.getDisconnectMessage());
 					m_clients.pop_back();
 				} else {
+					m_clientIndices.insert_or_assign(remoteEndpoint, m_clients.size() - 1);
 					++m_connectingClients;
 					client.connecting = true;
-					buffer.resize(receivedBytes);
-					client.connection.receivePacket(std::move(buffer));
-					buffer.resize(net::MAX_PACKET_SIZE);
+					receivePacket(client);
 					if (m_bannedClients.count(remoteEndpoint.getAddress()) != 0) {
 						INFO_MSG(Msg::SERVER, "Meta server: This ip address is banned from the server. Kicking.");
 						this->disconnectClient(std::prev(m_clients.end()), "You are banned from this meta server.");
@@ -372,16 +459,21 @@ auto MetaServer::receivePackets() -> void {
 }
 
 auto MetaServer::updateConnections() -> void {
+	auto dropped = false;
 	for (auto it = m_clients.begin(); it != m_clients.end();) {
 		m_currentClient = it;
 		if (!it->connection.update()) {
 			this->dropClient(it);
 			it = m_clients.erase(it);
+			dropped = true;
 		} else {
 			++it;
 		}
 	}
 	m_currentClient = m_clients.end();
+	if (dropped) {
+		this->updateClientIndices();
+	}
 }
 
 auto MetaServer::updateTicks(float deltaTime) -> void {
@@ -423,7 +515,67 @@ auto MetaServer::findClient(net::IpAddress ip) noexcept -> Clients::iterator {
 }
 
 auto MetaServer::findClient(net::IpEndpoint endpoint) noexcept -> Clients::iterator {
-	return util::findIf(m_clients, [endpoint](const auto& client) { return client.connection.getRemoteEndpoint() == endpoint; });
+	const auto it = m_clientIndices.find(endpoint);
+	if (it == m_clientIndices.end()) {
+		return m_clients.end();
+	}
+	assert(it->second < m_clients.size());
+	assert(m_clients[it->second].connection.getRemoteEndpoint() == endpoint);
+	return m_clients.begin() + static_cast<Clients::difference_type>(it->second);
+}
+
+auto MetaServer::updateClientIndices() -> void {
+	m_clientIndices.clear();
+	for (auto i = std::size_t{0}; i < m_clients.size(); ++i) {
+		m_clientIndices.emplace(m_clients[i].connection.getRemoteEndpoint(), i);
+	}
+}
+
+auto MetaServer::getCookieTime() const noexcept -> std::uint32_t {
+	return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(net::Clock::now() - m_cookieEpoch).count());
+}
+
+auto MetaServer::makeCookieTag(crypto::FastHashRef result, net::IpEndpoint endpoint, std::uint32_t timestamp) const -> bool {
+	auto data = std::vector<std::byte>{};
+	auto dataStream = net::ByteOutputStream{data};
+	dataStream << endpoint << timestamp;
+	return crypto::fastHash(result, data, m_cookieKey);
+}
+
+auto MetaServer::verifyCookie(const net::HandshakeCookie& cookie, net::IpEndpoint endpoint) const -> bool {
+	const auto lifetime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::duration<float>{static_cast<float>(meta_sv_cookie_lifetime)});
+	const auto age = static_cast<std::uint32_t>(this->getCookieTime() - cookie.timestamp); // Note: Expected to overflow.
+	if (age > static_cast<std::uint32_t>(lifetime.count())) {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Meta server: Handshake cookie from \"{}\" has expired.", std::string{endpoint});
+		return false;
+	}
+
+	auto tag = crypto::FastHash{};
+	if (!this->makeCookieTag(tag, endpoint, cookie.timestamp) || tag != cookie.tag) {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Meta server: Handshake cookie from \"{}\" is invalid.", std::string{endpoint});
+		return false;
+	}
+	return true;
+}
+
+auto MetaServer::sendCookie(net::IpEndpoint endpoint) -> void {
+	auto cookie = net::HandshakeCookie{};
+	cookie.timestamp = this->getCookieTime();
+	if (!this->makeCookieTag(cookie.tag, endpoint, cookie.timestamp)) {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Meta server: Failed to create handshake cookie for \"{}\".", std::string{endpoint});
+		return;
+	}
+
+	auto packet = std::vector<std::byte>{};
+	packet.reserve(net::HandshakeCookie::SIZE);
+	auto packetStream = net::ByteOutputStream{packet};
+	cookie.write(packetStream, net::HandshakeCookie::CHALLENGE_PROTOCOL_ID);
+
+	auto ec = std::error_code{};
+	m_socket.sendTo(endpoint, packet, ec);
+	if (ec) {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Meta server: Failed to send handshake cookie to \"{}\": {}", std::string{endpoint}, ec.message());
+	}
 }
 
 auto MetaServer::updateClient(Clients::iterator it, float deltaTime, int spamUpdates) -> void {
@@ -447,10 +599,34 @@ auto MetaServer::updateClientAfkTimer(Clients::iterator it, float deltaTime) ->
 	}
 }
 
+auto MetaServer::listGameServer(ServerListEntry entry) -> void {
+	const auto [it, inserted] = m_gameServerList.try_emplace(entry.endpoint);
+	if (inserted) {
+		util::eraseIf(m_removedGameServers, [&](const auto& server) { return server.endpoint == entry.endpoint; });
+	} else if (it->second.entry.tie() == entry.tie()) {
+		return;
+	}
+	it->second.entry = std::move(entry);
+	it->second.version = ++m_gameServerListVersion;
+}
+
+auto MetaServer::unlistGameServer(net::IpEndpoint endpoint) -> void {
+	if (const auto it = m_gameServerList.find(endpoint); it != m_gameServerList.end()) {
+		m_gameServerList.erase(it);
+		m_removedGameServers.push_back(RemovedGameServer{endpoint, ++m_gameServerListVersion});
+		if (m_removedGameServers.size() > MAX_REMOVED_GAME_SERVERS) {
+			m_removedGameServersVersion = m_removedGameServers.front().version;
+			m_removedGameServers.pop_front();
+		}
+	}
+}
+
 auto MetaServer::disconnectClient(Clients::iterator it, std::string_view reason) -> void {
 	assert(it != m_clients.end());
 
-	util::erase(m_gameServerAddressList, it->listedEndpoint);
+	if (it->heartbeatReceived) {
+		this->unlistGameServer(it->listedEndpoint);
+	}
 
 	const auto delay = std::chrono::duration_cast<net::Duration>(std::chrono::duration<float>{static_cast<float>(meta_sv_disconnect_cooldown)});
 	it->connection.disconnect(reason, delay);
@@ -463,7 +639,9 @@ auto MetaServer::dropClient(Clients::iterator it) -> void {
 		--m_connectingClients;
 	}
 
-	util::erase(m_gameServerAddressList, it->listedEndpoint);
+	if (it->heartbeatReceived) {
+		this->unlistGameServer(it->listedEndpoint);
+	}
 
 	INFO_MSG(Msg::SERVER,
 	         "Meta server: Client \"{}\" was dropped. Reason: \"{}\".",
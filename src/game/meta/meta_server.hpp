@@ -1,18 +1,25 @@
 #ifndef AF2_META_META_SERVER_HPP
 #define AF2_META_META_SERVER_HPP
 
-#include "../../network/config.hpp"           // net::Duration, net::MAX_PACKET_SIZE
-#include "../../network/connection.hpp"       // net::Connection, net::msg::in::Connect, net::sanitizeMessage
-#include "../../network/endpoint.hpp"         // net::IpAddress
+#include "../../network/config.hpp"           // net::Duration, net::TimePoint, net::MAX_PACKET_SIZE
+#include "../../network/connection.hpp"       // net::Connection, net::HandshakeCookie, net::msg::in::Connect, net::sanitizeMessage
+#include "../../network/crypto.hpp"           // crypto::FastHashKey, crypto::FastHashRef
+#include "../../network/endpoint.hpp"         // net::IpAddress, net::IpEndpoint
 #include "../../network/socket.hpp"           // net::UDPSocket
 #include "../../utilities/countdown.hpp"      // util::CountupLoop, util::Countup
 #include "../../utilities/reference.hpp"      // util::Reference
 #include "../shared/game_server_messages.hpp" // GameServerOutputMessages, msg::sv::out::...
 #include "meta_client_messages.hpp"           // MetaClientOutputMessages, msg::meta::cl::out::...
 #include "meta_server_messages.hpp"           // MetaServerInputMessages, msg::meta::sv::in::...
+#include "server_list_entry.hpp"              // ServerListEntry
 
 #include <cstddef>       // std::size_t, std::byte
+#include <cstdint>       // std::uint32_t
+#include <deque>         // std::deque
+#include <map>           // std::map
+#include <optional>      // std::optional
 #include <string>        // std::string
+#include <unordered_map> // std::unordered_map
 #include <unordered_set> // std::unordered_set
 #include <vector>        // std::vector
 
@@ -67,6 +74,7 @@ private:
 		int spamCounter = 0;
 		util::Countup<float> afkTimer{};
 		net::IpEndpoint listedEndpoint{};
+		std::optional<net::IpEndpoint> nextPageCursor{}; // Where the last server list page sent to this client ended, if there were more servers.
 		bool heartbeatReceived = false;
 
 		ClientInfo(net::UDPSocket& socket, net::Duration timeout, int throttleMaxSendBufferSize, int throttleMaxPeriod, MetaServer& server)
@@ -74,10 +82,26 @@ private:
 	};
 
 	using Clients = std::vector<ClientInfo>;
+	using ClientIndices = std::unordered_map<net::IpEndpoint, std::size_t>;
+
+	struct ListedGameServer final {
+		ServerListEntry entry{};
+		std::uint32_t version = 0; // Version of the server list when this entry last changed.
+	};
+
+	struct RemovedGameServer final {
+		net::IpEndpoint endpoint{};
+		std::uint32_t version = 0; // Version of the server list when this entry was removed.
+	};
+
+	using GameServerList = std::map<net::IpEndpoint, ListedGameServer>;
+	using RemovedGameServers = std::deque<RemovedGameServer>;
+
+	static constexpr auto MAX_REMOVED_GAME_SERVERS = std::size_t{256};
 
 	auto handleMessage(net::msg::in::Connect&& msg) -> void;
 	auto handleMessage(msg::meta::sv::in::Heartbeat&& msg) -> void;
-	auto handleMessage(msg::meta::sv::in::GameServerAddressListRequest&& msg) -> void;
+	auto handleMessage(msg::meta::sv::in::GameServerListRequest&& msg) -> void;
 
 	[[nodiscard]] auto testSpam() -> bool;
 
@@ -93,10 +117,20 @@ private:
 	auto findClient(net::IpAddress ip) noexcept -> Clients::iterator;
 	auto findClient(net::IpEndpoint endpoint) noexcept -> Clients::iterator;
 
+	auto updateClientIndices() -> void;
+
+	[[nodiscard]] auto getCookieTime() const noexcept -> std::uint32_t;
+	[[nodiscard]] auto makeCookieTag(crypto::FastHashRef result, net::IpEndpoint endpoint, std::uint32_t timestamp) const -> bool;
+	[[nodiscard]] auto verifyCookie(const net::HandshakeCookie& cookie, net::IpEndpoint endpoint) const -> bool;
+	auto sendCookie(net::IpEndpoint endpoint) -> void;
+
 	auto updateClient(Clients::iterator it, float deltaTime, int spamUpdates) -> void;
 	auto updateClientSpamCounter(Clients::iterator it, int spamUpdates) -> void;
 	auto updateClientAfkTimer(Clients::iterator it, float deltaTime) -> void;
 
+	auto listGameServer(ServerListEntry entry) -> void;
+	auto unlistGameServer(net::IpEndpoint endpoint) -> void;
+
 	auto disconnectClient(Clients::iterator it, std::string_view reason) -> void;
 
 	auto dropClient(Clients::iterator it) -> void;
@@ -106,7 +140,10 @@ private:
 	Game& m_game;
 	net::UDPSocket m_socket{};
 	Clients m_clients{};
+	ClientIndices m_clientIndices{};
 	Clients::iterator m_currentClient;
+	crypto::FastHashKey m_cookieKey{};
+	net::TimePoint m_cookieEpoch{};
 	float m_spamInterval = 0.0f;
 	float m_tickInterval = 0.0f;
 	float m_configAutoSaveInterval = 0.0f;
@@ -115,7 +152,10 @@ private:
 	util::CountupLoop<float> m_heartbeatRequestTimer{};
 	util::CountupLoop<float> m_configAutoSaveTimer{};
 	BannedClients m_bannedClients{};
-	std::vector<net::IpEndpoint> m_gameServerAddressList{};
+	GameServerList m_gameServerList{};
+	RemovedGameServers m_removedGameServers{};
+	std::uint32_t m_gameServerListVersion = 0;
+	std::uint32_t m_removedGameServersVersion = 0; // Removals up to and including this version may have been forgotten.
 	net::IpAddress m_privateAddressOverride{};
 	std::size_t m_connectingClients = 0;
 	bool m_stopping = false;
@@ -1,10 +1,16 @@
 #ifndef AF2_META_META_SERVER_MESSAGES_HPP
 #define AF2_META_META_SERVER_MESSAGES_HPP
 
-#include "../../network/message.hpp"     // net::MessageDirection, net::...Message
-#include "../../utilities/type_list.hpp" // util::TypeList
+#include "../../network/endpoint.hpp"       // net::IpEndpoint
+#include "../../network/message.hpp"        // net::MessageDirection, net::...Message
+#include "../../network/message_layout.hpp" // net::String
+#include "../../utilities/type_list.hpp"    // util::TypeList
+#include "../data/tickrate.hpp"             // Tickrate
+#include "server_list_entry.hpp"            // ServerListFilterFlags, SERVER_LIST_FILTER_...
 
-#include <tuple> // std::tie
+#include <cstdint>  // std::uint32_t
+#include <optional> // std::optional
+#include <tuple>    // std::tie
 
 namespace msg {
 namespace meta {
@@ -12,37 +18,50 @@ namespace sv {
 
 template <net::MessageDirection DIR>
 struct Heartbeat final : net::SecretMessage<Heartbeat<DIR>, DIR> {
+	Tickrate tickrate = 0;
+	std::uint32_t playerCount = 0;
+	std::uint32_t botCount = 0;
+	std::uint32_t maxPlayerCount = 0;
+	net::String<DIR> mapName{};
+	net::String<DIR> hostName{};
+	net::String<DIR> gameVersion{};
+
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie();
+		return std::tie(tickrate, playerCount, botCount, maxPlayerCount, mapName, hostName, gameVersion);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie();
+		return std::tie(tickrate, playerCount, botCount, maxPlayerCount, mapName, hostName, gameVersion);
 	}
 };
 
 template <net::MessageDirection DIR>
-struct GameServerAddressListRequest final : net::SecretMessage<GameServerAddressListRequest<DIR>, DIR> {
+struct GameServerListRequest final : net::SecretMessage<GameServerListRequest<DIR>, DIR> {
+	std::uint32_t version = 0;                              // Version of the list that the client already has. 0 = request the full list.
+	std::optional<net::IpEndpoint> after{};                 // Only list servers after this endpoint. Used to fetch the next page.
+	ServerListFilterFlags filter = SERVER_LIST_FILTER_NONE; // Conditions that listed servers have to fulfill.
+	net::String<DIR> mapName{};                             // Map to list servers for if filtering by map.
+
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie();
+		return std::tie(version, after, filter, mapName);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie();
+		return std::tie(version, after, filter, mapName);
 	}
 };
 
 namespace in {
 
 using Heartbeat = msg::meta::sv::Heartbeat<net::MessageDirection::INPUT>;
-using GameServerAddressListRequest = msg::meta::sv::GameServerAddressListRequest<net::MessageDirection::INPUT>;
+using GameServerListRequest = msg::meta::sv::GameServerListRequest<net::MessageDirection::INPUT>;
 
 } // namespace in
 
 namespace out {
 
 using Heartbeat = msg::meta::sv::Heartbeat<net::MessageDirection::OUTPUT>;
-using GameServerAddressListRequest = msg::meta::sv::GameServerAddressListRequest<net::MessageDirection::OUTPUT>;
+using GameServerListRequest = msg::meta::sv::GameServerListRequest<net::MessageDirection::OUTPUT>;
 
 } // namespace out
 
@@ -51,9 +70,9 @@ using GameServerAddressListRequest = msg::meta::sv::GameServerAddressListRequest
 } // namespace msg
 
 template <net::MessageDirection DIR>
-using MetaServerMessages = util::TypeList<           //
-	msg::meta::sv::Heartbeat<DIR>,                   // 0
-	msg::meta::sv::GameServerAddressListRequest<DIR> // 1
+using MetaServerMessages = util::TypeList<    //
+	msg::meta::sv::Heartbeat<DIR>,            // 0
+	msg::meta::sv::GameServerListRequest<DIR> // 1
 	>;
 
 using MetaServerInputMessages = MetaServerMessages<net::MessageDirection::INPUT>;
@@ -0,0 +1,54 @@
+#ifndef AF2_META_SERVER_LIST_ENTRY_HPP
+#define AF2_META_SERVER_LIST_ENTRY_HPP
+
+#include "../../network/endpoint.hpp" // net::IpEndpoint
+#include "../../network/message.hpp"  // net::TieInputOutputStreamableBase
+#include "../data/tickrate.hpp"       // Tickrate
+
+#include <cstdint>     // std::uint32_t, std::uint8_t
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <tuple>       // std::tie
+
+using ServerListFilterFlags = std::uint8_t;
+enum ServerListFilter : ServerListFilterFlags {
+	SERVER_LIST_FILTER_NONE = 0,
+	SERVER_LIST_FILTER_NOT_EMPTY = 1 << 0, // Only list servers with at least one player.
+	SERVER_LIST_FILTER_NOT_FULL = 1 << 1,  // Only list servers that have room for more players.
+	SERVER_LIST_FILTER_MAP = 1 << 2,       // Only list servers running a specific map.
+};
+
+// Game server as listed by the meta server. The meta server keeps this up to date from the heartbeats that game servers send it.
+struct ServerListEntry final : net::TieInputOutputStreamableBase<ServerListEntry> {
+	net::IpEndpoint endpoint{};
+	Tickrate tickrate = 0;
+	std::uint32_t playerCount = 0;
+	std::uint32_t botCount = 0;
+	std::uint32_t maxPlayerCount = 0;
+	std::string mapName{};
+	std::string hostName{};
+	std::string gameVersion{};
+
+	[[nodiscard]] auto matches(ServerListFilterFlags filter, std::string_view filterMapName) const noexcept -> bool {
+		if ((filter & SERVER_LIST_FILTER_NOT_EMPTY) != 0 && playerCount == 0) {
+			return false;
+		}
+		if ((filter & SERVER_LIST_FILTER_NOT_FULL) != 0 && playerCount >= maxPlayerCount) {
+			return false;
+		}
+		if ((filter & SERVER_LIST_FILTER_MAP) != 0 && mapName != filterMapName) {
+			return false;
+		}
+		return true;
+	}
+
+	[[nodiscard]] constexpr auto tie() noexcept {
+		return std::tie(endpoint, tickrate, playerCount, botCount, maxPlayerCount, mapName, hostName, gameVersion);
+	}
+
+	[[nodiscard]] constexpr auto tie() const noexcept {
+		return std::tie(endpoint, tickrate, playerCount, botCount, maxPlayerCount, mapName, hostName, gameVersion);
+	}
+};
+
+#endif
@@ -2,50 +2,78 @@
 
 #include "../../console/commands/bot_commands.hpp" // bot_...
 #include "../../utilities/algorithm.hpp"           // util::findClosestDistanceSquared, util::filter, util::anyOf
+#include "../../utilities/span.hpp"                // util::Span
 #include "../data/direction.hpp"                   // Direction
 #include "../data/rectangle.hpp"                   // Rect
-#include "../shared/entities.hpp"                  // ent::sh::Player, ent::sh::SentryGun, ent::findClosestDistanceSquared
+#include "../shared/entities.hpp"                  // ent::findClosestDistanceSquared
 #include "../shared/map.hpp"                       // Map
+#include "visibility_cache.hpp"                    // VisibilityCache
 
-#include <cmath> // std::sqrt
+#include <algorithm> // std::max
+#include <cmath>     // std::sqrt
+#include <utility>   // std::move, std::exchange
 
-Bot::Bot(const Map& map, std::mt19937& rng, CoordinateDistributionX& xCoordinateDistribution,
-         CoordinateDistributionY& yCoordinateDistribution, PlayerId id, std::string name)
+namespace {
+
+[[nodiscard]] auto getHealRange() -> Vec2::Length {
+	const auto speed = 1.0f / ProjectileType::heal_beam().getMoveInterval();
+	const auto time = ProjectileType::heal_beam().getDisappearTime();
+	return static_cast<Vec2::Length>(speed * time);
+}
+
+} // namespace
+
+Bot::Bot(const Map& map, const World& world, Seed seed, CoordinateDistributionX xCoordinateDistribution,
+         CoordinateDistributionY yCoordinateDistribution, PlayerId id, std::string name)
 	: m_map(map)
-	, m_rng(rng)
+	, m_world(world)
+	, m_visibilityCache(world.getVisibilityCache())
+	, m_rng(seed)
+	, m_distributions(Bot::sharedDistributions())
 	, m_xCoordinateDistribution(xCoordinateDistribution)
 	, m_yCoordinateDistribution(yCoordinateDistribution)
 	, m_id(id)
 	, m_name(std::move(name)) {}
 
 auto Bot::updateHealthProbability() -> void {
-	Bot::healthDistribution() = HealthDistribution{static_cast<double>(bot_probability_get_health)};
+	auto& shared = Bot::sharedDistributions();
+	shared.health = HealthDistribution{static_cast<double>(bot_probability_get_health)};
+	++shared.version;
 }
 
 auto Bot::updateClassWeights() -> void {
-	Bot::classDistribution() = ClassDistribution{static_cast<double>(bot_class_weight_scout),
-	                                             static_cast<double>(bot_class_weight_soldier),
-	                                             static_cast<double>(bot_class_weight_pyro),
-	                                             static_cast<double>(bot_class_weight_demoman),
-	                                             static_cast<double>(bot_class_weight_heavy),
-	                                             static_cast<double>(bot_class_weight_engineer),
-	                                             static_cast<double>(bot_class_weight_medic),
-	                                             static_cast<double>(bot_class_weight_sniper),
-	                                             static_cast<double>(bot_class_weight_spy)};
+	auto& shared = Bot::sharedDistributions();
+	shared.playerClass = ClassDistribution{static_cast<double>(bot_class_weight_scout),
+	                                       static_cast<double>(bot_class_weight_soldier),
+	                                       static_cast<double>(bot_class_weight_pyro),
+	                                       static_cast<double>(bot_class_weight_demoman),
+	                                       static_cast<double>(bot_class_weight_heavy),
+	                                       static_cast<double>(bot_class_weight_engineer),
+	                                       static_cast<double>(bot_class_weight_medic),
+	                                       static_cast<double>(bot_class_weight_sniper),
+	                                       static_cast<double>(bot_class_weight_spy)};
+	++shared.version;
 }
 
 auto Bot::updateGoalWeights() -> void {
-	Bot::goalDistribution() = GoalDistribution{static_cast<double>(bot_decision_weight_do_objective),
-	                                           static_cast<double>(bot_decision_weight_roam),
-	                                           static_cast<double>(bot_decision_weight_defend)};
+	auto& shared = Bot::sharedDistributions();
+	shared.goal = GoalDistribution{static_cast<double>(bot_decision_weight_do_objective),
+	                               static_cast<double>(bot_decision_weight_roam),
+	                               static_cast<double>(bot_decision_weight_defend)};
+	++shared.version;
 }
 
 auto Bot::updateSpyCheckProbability() -> void {
-	Bot::spyCheckDistribution() = SpyCheckDistribution{static_cast<double>(bot_probability_spycheck)};
+	auto& shared = Bot::sharedDistributions();
+	shared.spyCheck = SpyCheckDistribution{static_cast<double>(bot_probability_spycheck)};
+	++shared.version;
 }
 
 auto Bot::think(float deltaTime) -> void {
-	if (!m_snapshot.selfPlayer.alive) {
+	m_timeSinceThink = 0.0f;
+	this->updateDistributions();
+	this->updatePerception();
+	if (!m_self.alive) {
 		if (m_currentState != State::DEAD) {
 			m_currentState = State::DEAD;
 			this->onDeath();
@@ -63,17 +91,20 @@ auto Bot::think(float deltaTime) -> void {
 				if (this->tryFight(deltaTime)) {
 					return;
 				} else {
+					if (m_currentState == State::PLANNING) {
+						break;
+					}
 					if (m_currentNode > 0) {
 						if (m_currentGoal == Goal::GET_OBJECTIVE) {
-							const auto area = Rect{static_cast<Rect::Length>(m_snapshot.selfPlayer.position.x - 1),
-							                       static_cast<Rect::Length>(m_snapshot.selfPlayer.position.y - 1),
+							const auto area = Rect{static_cast<Rect::Length>(m_self.position.x - 1),
+							                       static_cast<Rect::Length>(m_self.position.y - 1),
 							                       3,
 							                       3};
-							for (const auto& cart : m_snapshot.carts) {
+							for (const auto& cart : m_carts) {
 								if (area.contains(cart.position)) {
 									m_actions = Action::NONE;
 									m_currentNode = 0;
-									if (cart.team != m_snapshot.selfPlayer.team) {
+									if (cart.team != m_self.team) {
 										this->setRandomGoal();
 									}
 									return;
@@ -82,7 +113,7 @@ auto Bot::think(float deltaTime) -> void {
 						}
 
 						auto currentDestination = m_currentPath[m_currentNode - 1];
-						if (m_snapshot.selfPlayer.position == currentDestination) {
+						if (m_self.position == currentDestination) {
 							--m_currentNode;
 							if (m_currentNode > 0) {
 								currentDestination = m_currentPath[m_currentNode - 1];
@@ -90,8 +121,7 @@ auto Bot::think(float deltaTime) -> void {
 						}
 
 						m_actions = Action::NONE;
-						if (m_snapshot.selfPlayer.playerClass == PlayerClass::spy() &&
-						    m_snapshot.selfPlayer.skinTeam == m_snapshot.selfPlayer.team) {
+						if (m_self.playerClass == PlayerClass::spy() && m_self.skinTeam == m_self.team) {
 							m_actions |= Action::ATTACK2;
 						}
 						this->moveTowards(currentDestination);
@@ -105,7 +135,7 @@ auto Bot::think(float deltaTime) -> void {
 						case Goal::ROAM: this->setRandomGoal(); break;
 						case Goal::DEFEND: this->setRandomGoal(); break;
 						case Goal::GET_HEALTH:
-							if (m_snapshot.selfPlayer.health >= m_snapshot.selfPlayer.playerClass.getHealth()) {
+							if (m_self.health >= m_self.playerClass.getHealth()) {
 								this->setRandomGoal();
 							} else {
 								this->setGoalToGetHealth();
@@ -119,6 +149,9 @@ auto Bot::think(float deltaTime) -> void {
 					m_currentState = State::FIGHTING;
 					return;
 				} else {
+					if (m_currentState == State::PLANNING) {
+						break;
+					}
 					if (m_waitTimer.advance(deltaTime).first) {
 						this->setRandomGoal();
 					} else {
@@ -133,10 +166,58 @@ auto Bot::think(float deltaTime) -> void {
 				}
 				this->onStopFighting();
 				break;
+			case State::PLANNING:
+				if (m_waitingForPath) {
+					if (!this->tryFight(deltaTime)) {
+						m_actions = Action::NONE;
+					}
+					return;
+				}
+				if (m_currentPath.empty()) {
+					switch (m_planFallback) {
+						case PlanFallback::ROAM: this->setGoalToRoam(); break;
+						case PlanFallback::RANDOM_GOAL: this->setRandomGoal(); break;
+					}
+				} else {
+					m_currentState = State::GOING;
+				}
+				break;
 		}
 	}
 }
 
+auto Bot::advanceThinkTimer(float deltaTime) -> void {
+	m_timeSinceThink += deltaTime;
+}
+
+auto Bot::setTimeSinceThink(float time) -> void {
+	m_timeSinceThink = time;
+}
+
+auto Bot::getTimeSinceThink() const -> float {
+	return m_timeSinceThink;
+}
+
+auto Bot::takePathRequest() -> std::optional<Bot::PathRequest> {
+	return std::exchange(m_pathRequest, std::nullopt);
+}
+
+auto Bot::isWaitingForPath(PathRequestId id) const -> bool {
+	return m_waitingForPath && id == m_pathRequestId;
+}
+
+auto Bot::onPathFound(PathRequestId id, std::vector<Vec2> path) -> void {
+	if (this->isWaitingForPath(id)) {
+		m_waitingForPath = false;
+		m_currentPath = std::move(path);
+		m_currentNode = m_currentPath.size();
+	}
+}
+
+auto Bot::takePlanStats() -> PlanStats {
+	return std::exchange(m_planStats, PlanStats{});
+}
+
 auto Bot::getActions() const -> Actions {
 	return m_actions;
 }
@@ -146,7 +227,8 @@ auto Bot::getId() const -> PlayerId {
 }
 
 auto Bot::getRandomClass() const -> PlayerClass {
-	switch (Bot::classDistribution()(*m_rng)) {
+	this->updateDistributions();
+	switch (m_distributions.playerClass(m_rng)) {
 		case 0: return PlayerClass::scout();
 		case 1: return PlayerClass::soldier();
 		case 2: return PlayerClass::pyro();
@@ -164,19 +246,24 @@ auto Bot::getName() const -> std::string_view {
 	return m_name;
 }
 
-auto Bot::setSnapshot(Snapshot&& snapshot) -> void {
-	m_snapshot = std::move(snapshot);
-}
-
-auto Bot::setSnapshot(const Snapshot& snapshot) -> void {
-	m_snapshot = snapshot;
-}
-
 auto Bot::getRangeSquared() const -> Vec2::Length { // NOLINT(readability-convert-member-functions-to-static)
 	const auto range = static_cast<int>(bot_range);
 	return static_cast<Vec2::Length>(range * range);
 }
 
+auto Bot::updatePerception() -> void {
+	m_self = m_world->perceiveSelf(m_id);
+	if (m_self.alive) {
+		m_world->perceivePlayersInRange(m_id, m_self.position, std::max(static_cast<Vec2::Length>(bot_range), getHealRange()), m_players);
+		m_world->perceiveFlags(m_flags);
+		m_world->perceivePayloadCarts(m_carts);
+	} else {
+		m_players.clear();
+		m_flags.clear();
+		m_carts.clear();
+	}
+}
+
 auto Bot::onSpawn() -> void {
 	m_spyCheckState = SpyCheckState::COOLDOWN;
 	m_spyCheckCountdown.start(bot_spycheck_cooldown_spawn);
@@ -186,6 +273,8 @@ auto Bot::onDeath() -> void {
 	m_actions = Action::NONE;
 	m_currentPath.clear();
 	m_currentNode = 0;
+	m_pathRequest.reset();
+	m_waitingForPath = false;
 	m_waitTimer.reset();
 	m_healingState = HealingState::NONE;
 	m_spyCheckState = SpyCheckState::NONE;
@@ -195,10 +284,10 @@ auto Bot::onDeath() -> void {
 auto Bot::setRandomGoal() -> void {
 	// If an enemy flag is in range, prioritize that above all else.
 	const auto isEnemyFlag = [&](const auto& flag) {
-		return flag.team != m_snapshot.selfPlayer.team;
+		return flag.team != m_self.team;
 	};
-	const auto otherTeamFlags = m_snapshot.flags | util::filter(isEnemyFlag);
-	if (const auto closestFlag = ent::findClosestDistanceSquared(otherTeamFlags, m_snapshot.selfPlayer.position);
+	const auto otherTeamFlags = m_flags | util::filter(isEnemyFlag);
+	if (const auto closestFlag = ent::findClosestDistanceSquared(otherTeamFlags, m_self.position);
 	    closestFlag.first != otherTeamFlags.end()) {
 		if (const auto range = static_cast<int>(bot_range); closestFlag.second < range * range && this->findPath(closestFlag.first->position)) {
 			m_currentGoal = Goal::GET_OBJECTIVE;
@@ -207,7 +296,7 @@ auto Bot::setRandomGoal() -> void {
 		}
 	}
 
-	switch (Bot::goalDistribution()(*m_rng)) {
+	switch (m_distributions.goal(m_rng)) {
 		case 0: this->setGoalToGetObjective(); break;
 		case 1: this->setGoalToRoam(); break;
 		case 2: this->setGoalToDefend(); break;
@@ -215,16 +304,16 @@ auto Bot::setRandomGoal() -> void {
 }
 
 auto Bot::setGoalToGetObjective() -> void {
-	for (const auto& cart : m_snapshot.carts) {
-		if (cart.team == m_snapshot.selfPlayer.team && this->findPath(cart.position)) {
+	for (const auto& cart : m_carts) {
+		if (cart.team == m_self.team && this->findPath(cart.position)) {
 			m_currentGoal = Goal::GET_OBJECTIVE;
 			m_currentState = State::GOING;
 			return;
 		}
 	}
 
-	for (const auto& cart : m_snapshot.carts) {
-		if (cart.team != m_snapshot.selfPlayer.team && this->findPath(cart.position)) {
+	for (const auto& cart : m_carts) {
+		if (cart.team != m_self.team && this->findPath(cart.position)) {
 			m_currentGoal = Goal::GET_OBJECTIVE;
 			m_currentState = State::GOING;
 			return;
@@ -232,10 +321,10 @@ auto Bot::setGoalToGetObjective() -> void {
 	}
 
 	const auto isEnemyFlag = [&](const auto& flag) {
-		return flag.team != m_snapshot.selfPlayer.team;
+		return flag.team != m_self.team;
 	};
-	const auto otherTeamFlags = m_snapshot.flags | util::filter(isEnemyFlag);
-	if (const auto closestFlag = ent::findClosestDistanceSquared(otherTeamFlags, m_snapshot.selfPlayer.position);
+	const auto otherTeamFlags = m_flags | util::filter(isEnemyFlag);
+	if (const auto closestFlag = ent::findClosestDistanceSquared(otherTeamFlags, m_self.position);
 	    closestFlag.first != otherTeamFlags.end() && this->findPath(closestFlag.first->position)) {
 		m_currentGoal = Goal::GET_OBJECTIVE;
 		m_currentState = State::GOING;
@@ -245,18 +334,16 @@ auto Bot::setGoalToGetObjective() -> void {
 }
 
 auto Bot::setGoalToRoam() -> void {
-	const auto isRed = m_snapshot.selfPlayer.team == Team::red();
-	const auto isBlue = m_snapshot.selfPlayer.team == Team::blue();
+	const auto isRed = m_self.team == Team::red();
+	const auto isBlue = m_self.team == Team::blue();
 	auto destination = Vec2{};
 	do {
-		do {
-			destination.x = (*m_xCoordinateDistribution)(*m_rng);
-			destination.y = (*m_yCoordinateDistribution)(*m_rng);
-		} while (m_map->isSolid(destination, isRed, isBlue));
-	} while (!this->findPath(destination));
-
-	m_currentGoal = Goal::ROAM;
-	m_currentState = State::GOING;
+		destination.x = m_xCoordinateDistribution(m_rng);
+		destination.y = m_yCoordinateDistribution(m_rng);
+	} while (m_map->isSolid(destination, isRed, isBlue));
+
+	// If the destination turns out to be unreachable, a new one is picked once the path request fails.
+	this->requestPath(destination, Goal::ROAM, PlanFallback::ROAM);
 	m_healingState = HealingState::NONE;
 }
 
@@ -268,20 +355,20 @@ auto Bot::setGoalToDefend() -> void {
 }
 
 auto Bot::setGoalToCaptureObjective() -> void {
-	if (m_snapshot.selfPlayer.playerClass != PlayerClass::spy()) {
-		for (const auto& cart : m_snapshot.carts) {
-			if (cart.team == m_snapshot.selfPlayer.team) {
+	if (m_self.playerClass != PlayerClass::spy()) {
+		for (const auto& cart : m_carts) {
+			if (cart.team == m_self.team) {
 				this->setGoalToGetObjective();
 				return;
 			}
 		}
 	}
 
-	const auto& flagSpawns = (m_snapshot.selfPlayer.team == Team::red())  ? m_map->getRedFlagSpawns() :
-	                         (m_snapshot.selfPlayer.team == Team::blue()) ? m_map->getBlueFlagSpawns() :
+	const auto& flagSpawns = (m_self.team == Team::red())  ? m_map->getRedFlagSpawns() :
+	                         (m_self.team == Team::blue()) ? m_map->getBlueFlagSpawns() :
                                                                             decltype(m_map->getBlueFlagSpawns()){};
 
-	if (const auto it = util::findClosestDistanceSquared(flagSpawns, m_snapshot.selfPlayer.position).first;
+	if (const auto it = util::findClosestDistanceSquared(flagSpawns, m_self.position).first;
 	    it != flagSpawns.end() && this->findPath(*it)) {
 		m_currentGoal = Goal::CAPTURE_OBJECTIVE;
 		m_currentState = State::GOING;
@@ -291,9 +378,8 @@ auto Bot::setGoalToCaptureObjective() -> void {
 }
 
 auto Bot::setGoalToGetHealth() -> void {
-	if (const auto closestMedkit = ent::findClosestDistanceSquared(m_snapshot.medkits, m_snapshot.selfPlayer.position);
-	    closestMedkit.first != m_snapshot.medkits.end()) {
-		if (this->findPath(closestMedkit.first->position)) {
+	if (const auto closestMedkit = m_world->perceiveClosestMedkit(m_self.position)) {
+		if (this->findPath(*closestMedkit)) {
 			m_currentGoal = Goal::GET_HEALTH;
 			m_currentState = State::GOING;
 		} else {
@@ -317,7 +403,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 		}
 	}
 
-	if (m_snapshot.selfPlayer.playerClass == PlayerClass::demoman()) {
+	if (m_self.playerClass == PlayerClass::demoman()) {
 		if (const auto enemy = this->findEnemyPlayer(false)) {
 			if (this->isNearbySticky(enemy->player.position)) {
 				m_actions = Action::NONE;
@@ -335,7 +421,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 		return true;
 	}
 
-	if (m_snapshot.selfPlayer.playerClass == PlayerClass::spy() && m_snapshot.selfPlayer.skinTeam == m_snapshot.selfPlayer.team) {
+	if (m_self.playerClass == PlayerClass::spy() && m_self.skinTeam == m_self.team) {
 		if (m_currentGoal == Goal::DEFEND && this->findEnemyPlayer(true)) {
 			this->setGoalToRoam();
 		}
@@ -343,7 +429,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 	}
 
 	if (const auto* const spy = this->findSpy()) {
-		if (spy->team == m_snapshot.selfPlayer.team) {
+		if (spy->team == m_self.team) {
 			if (m_spyCheckState == SpyCheckState::NONE) {
 				m_spyCheckState = SpyCheckState::SUSPICIOUS;
 				m_spyCheckCountdown.start(bot_spycheck_reaction_time);
@@ -351,7 +437,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 
 			if (m_spyCheckState == SpyCheckState::SUSPICIOUS) {
 				if (m_spyCheckCountdown.advance(deltaTime).first) {
-					if (Bot::spyCheckDistribution()(*m_rng)) {
+					if (m_distributions.spyCheck(m_rng)) {
 						m_spyCheckState = SpyCheckState::ALERT;
 						m_spyCheckCountdown.start(bot_spycheck_time);
 					} else {
@@ -367,7 +453,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 	}
 
 	const auto enemy = this->findEnemyPlayer(true);
-	if (m_snapshot.selfPlayer.playerClass == PlayerClass::medic()) {
+	if (m_self.playerClass == PlayerClass::medic()) {
 		if (const auto* const teammate = this->findHealablePlayer()) {
 			if (m_healingState == HealingState::NONE) {
 				m_healingState = HealingState::HEALING;
@@ -394,7 +480,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 	if (enemy) {
 		this->fight(enemy->player.position,
 		            enemy->distance,
-		            m_currentGoal != Goal::DEFEND && enemy->player.team != m_snapshot.selfPlayer.team,
+		            m_currentGoal != Goal::DEFEND && enemy->player.team != m_self.team,
 		            enemy->player.playerClass,
 		            false);
 		m_currentState = State::FIGHTING;
@@ -407,7 +493,7 @@ auto Bot::tryFight(float deltaTime) -> bool {
 auto Bot::fight(Vec2 target, float distance, bool aggressive, PlayerClass enemyClass, bool isSentry) -> void {
 	m_actions = Action::NONE;
 	this->aimAt(target);
-	switch (m_snapshot.selfPlayer.playerClass) {
+	switch (m_self.playerClass) {
 		case PlayerClass::scout():
 			if (this->shouldReload()) {
 				this->moveRandomlyAwayFrom(target);
@@ -548,13 +634,13 @@ auto Bot::fight(Vec2 target, float distance, bool aggressive, PlayerClass enemyC
 
 auto Bot::shouldReload() -> bool {
 	if (m_reloading) {
-		if (m_snapshot.selfPlayer.primaryAmmo < m_snapshot.selfPlayer.playerClass.getPrimaryWeapon().getAmmoPerClip() / 2) {
+		if (m_self.primaryAmmo < m_self.playerClass.getPrimaryWeapon().getAmmoPerClip() / 2) {
 			return true;
 		}
 		m_reloading = false;
 	}
 
-	if (!m_reloading && m_snapshot.selfPlayer.primaryAmmo == 0) {
+	if (!m_reloading && m_self.primaryAmmo == 0) {
 		m_reloading = true;
 		return true;
 	}
@@ -562,14 +648,13 @@ auto Bot::shouldReload() -> bool {
 }
 
 auto Bot::shouldGetHealth() -> bool {
-	return m_currentGoal != Goal::CAPTURE_OBJECTIVE && m_snapshot.selfPlayer.health < m_snapshot.selfPlayer.playerClass.getHealth() &&
-	       Bot::healthDistribution()(*m_rng);
+	return m_currentGoal != Goal::CAPTURE_OBJECTIVE && m_self.health < m_self.playerClass.getHealth() && m_distributions.health(m_rng);
 }
 
 auto Bot::shouldFlee() -> bool {
 	return m_currentGoal != Goal::CAPTURE_OBJECTIVE &&
-	       (m_snapshot.selfPlayer.playerClass == PlayerClass::medic() || m_snapshot.selfPlayer.playerClass == PlayerClass::spy() ||
-	        m_snapshot.selfPlayer.playerClass == PlayerClass::demoman() || this->shouldReload());
+	       (m_self.playerClass == PlayerClass::medic() || m_self.playerClass == PlayerClass::spy() ||
+	        m_self.playerClass == PlayerClass::demoman() || this->shouldReload());
 }
 
 auto Bot::onStopFighting() -> void {
@@ -579,30 +664,28 @@ auto Bot::onStopFighting() -> void {
 		this->setRandomGoal();
 	} else {
 		m_currentState = State::GOING;
-		if (!m_currentPath.empty()) {
-			if (!this->findPath(m_currentPath.front())) {
-				this->setRandomGoal();
-			}
+		if (!m_currentPath.empty() && !this->repairPath()) {
+			this->requestPath(m_currentPath.front(), m_currentGoal, PlanFallback::RANDOM_GOAL);
 		}
 	}
 }
 
 auto Bot::aimTowards(Vec2 position) -> void {
-	if (position.y < m_snapshot.selfPlayer.position.y) {
+	if (position.y < m_self.position.y) {
 		m_actions |= Action::AIM_UP;
-	} else if (position.y > m_snapshot.selfPlayer.position.y) {
+	} else if (position.y > m_self.position.y) {
 		m_actions |= Action::AIM_DOWN;
 	}
 
-	if (position.x < m_snapshot.selfPlayer.position.x) {
+	if (position.x < m_self.position.x) {
 		m_actions |= Action::AIM_LEFT;
-	} else if (position.x > m_snapshot.selfPlayer.position.x) {
+	} else if (position.x > m_self.position.x) {
 		m_actions |= Action::AIM_RIGHT;
 	}
 }
 
 auto Bot::aimAt(Vec2 position) -> void {
-	const auto aimVector = position - m_snapshot.selfPlayer.position;
+	const auto aimVector = position - m_self.position;
 	const auto direction = Direction{aimVector};
 	if (direction.hasLeft()) {
 		m_actions |= Action::AIM_LEFT;
@@ -628,15 +711,15 @@ auto Bot::attack2() -> void {
 
 auto Bot::getMovementTowards(Vec2 position) const -> Actions {
 	auto actions = Actions{Action::NONE};
-	if (position.y < m_snapshot.selfPlayer.position.y) {
+	if (position.y < m_self.position.y) {
 		actions |= Action::MOVE_UP;
-	} else if (position.y > m_snapshot.selfPlayer.position.y) {
+	} else if (position.y > m_self.position.y) {
 		actions |= Action::MOVE_DOWN;
 	}
 
-	if (position.x < m_snapshot.selfPlayer.position.x) {
+	if (position.x < m_self.position.x) {
 		actions |= Action::MOVE_LEFT;
-	} else if (position.x > m_snapshot.selfPlayer.position.x) {
+	} else if (position.x > m_self.position.x) {
 		actions |= Action::MOVE_RIGHT;
 	}
 	return actions;
@@ -644,22 +727,22 @@ auto Bot::getMovementTowards(Vec2 position) const -> Actions {
 
 auto Bot::getMovementAwayFrom(Vec2 position) const -> Actions {
 	auto actions = Actions{Action::NONE};
-	if (position.y < m_snapshot.selfPlayer.position.y) {
+	if (position.y < m_self.position.y) {
 		actions |= Action::MOVE_DOWN;
-	} else if (position.y > m_snapshot.selfPlayer.position.y) {
+	} else if (position.y > m_self.position.y) {
 		actions |= Action::MOVE_UP;
 	}
 
-	if (position.x < m_snapshot.selfPlayer.position.x) {
+	if (position.x < m_self.position.x) {
 		actions |= Action::MOVE_RIGHT;
-	} else if (position.x > m_snapshot.selfPlayer.position.x) {
+	} else if (position.x > m_self.position.x) {
 		actions |= Action::MOVE_LEFT;
 	}
 	return actions;
 }
 
 auto Bot::getRandomMovement() const -> Actions {
-	switch (Bot::directionDistribution()(*m_rng)) {
+	switch (m_distributions.direction(m_rng)) {
 		case 1: return Action::MOVE_UP;
 		case 2: return Action::MOVE_DOWN;
 		case 3: return Action::MOVE_LEFT;
@@ -677,7 +760,7 @@ auto Bot::moveTowards(Vec2 position) -> void {
 }
 
 auto Bot::moveRandomlyTowards(Vec2 position) -> void {
-	if (position != m_snapshot.selfPlayer.position) {
+	if (position != m_self.position) {
 		m_actions |= this->getMovementTowards(position) | this->getRandomMovement();
 	} else {
 		this->moveRandomly();
@@ -685,7 +768,7 @@ auto Bot::moveRandomlyTowards(Vec2 position) -> void {
 }
 
 auto Bot::moveAt(Vec2 position) -> void {
-	if (position != m_snapshot.selfPlayer.position) {
+	if (position != m_self.position) {
 		this->moveTowards(position);
 	} else {
 		this->moveRandomly();
@@ -693,7 +776,7 @@ auto Bot::moveAt(Vec2 position) -> void {
 }
 
 auto Bot::moveRandomlyAt(Vec2 position) -> void {
-	if (position != m_snapshot.selfPlayer.position) {
+	if (position != m_self.position) {
 		m_actions |= this->getMovementTowards(position) | (this->getRandomMovement() & ~this->getMovementAwayFrom(position));
 	} else {
 		this->moveRandomly();
@@ -713,83 +796,85 @@ auto Bot::moveRandomlyAwayFrom(Vec2 position) -> void {
 	this->moveRandomly();
 }
 
-auto Bot::isPotentialEnemy(const ent::sh::Player& player, bool requireLineOfSight) const -> bool {
-	if (player.team != m_snapshot.selfPlayer.team ||
-	    (player.playerClass == PlayerClass::spy() && m_snapshot.selfPlayer.playerClass != PlayerClass::spy() && m_spyCheckState == SpyCheckState::ALERT)) {
-		return !requireLineOfSight || m_map->lineOfSight(m_snapshot.selfPlayer.position, player.position);
+auto Bot::isPotentialEnemy(const World::PerceivedPlayer& player, bool requireLineOfSight) const -> bool {
+	if (player.team != m_self.team ||
+	    (player.playerClass == PlayerClass::spy() && m_self.playerClass != PlayerClass::spy() && m_spyCheckState == SpyCheckState::ALERT)) {
+		return !requireLineOfSight || m_visibilityCache->lineOfSight(m_self.position, player.position);
 	}
 	return false;
 }
 
-auto Bot::isPotentiallyHealable(const ent::sh::Player& player) const -> bool {
-	return player.team == m_snapshot.selfPlayer.team && (player.playerClass != PlayerClass::spy() || m_spyCheckState != SpyCheckState::ALERT) &&
-	       m_map->lineOfSight(m_snapshot.selfPlayer.position, player.position);
+auto Bot::isPotentiallyHealable(const World::PerceivedPlayer& player) const -> bool {
+	return player.team == m_self.team && (player.playerClass != PlayerClass::spy() || m_spyCheckState != SpyCheckState::ALERT) &&
+	       m_visibilityCache->lineOfSight(m_self.position, player.position);
 }
 
 auto Bot::findEnemyPlayer(bool requireLineOfSight) const -> std::optional<Bot::FoundPlayer> {
+	// Reject players that are out of range before doing the more expensive line of sight check.
+	const auto range = static_cast<int>(bot_range);
 	const auto isPotentialEnemy = [&](const auto& player) {
-		return this->isPotentialEnemy(player, requireLineOfSight);
+		return Vec2::distanceSquared(player.position, m_self.position) <= range * range && this->isPotentialEnemy(player, requireLineOfSight);
 	};
-	const auto potentialEnemies = m_snapshot.players | util::filter(isPotentialEnemy);
-	if (const auto closestEnemy = ent::findClosestDistanceSquared(potentialEnemies, m_snapshot.selfPlayer.position);
+	const auto potentialEnemies = m_players | util::filter(isPotentialEnemy);
+	if (const auto closestEnemy = ent::findClosestDistanceSquared(potentialEnemies, m_self.position);
 	    closestEnemy.first != potentialEnemies.end()) {
-		if (const auto range = static_cast<int>(bot_range); closestEnemy.second <= range * range) {
-			return FoundPlayer{*closestEnemy.first, std::sqrt(static_cast<float>(closestEnemy.second)) / static_cast<float>(range)};
-		}
+		return FoundPlayer{*closestEnemy.first, std::sqrt(static_cast<float>(closestEnemy.second)) / static_cast<float>(range)};
 	}
 	return std::nullopt;
 }
 
-auto Bot::findHealablePlayer() const -> const ent::sh::Player* {
+auto Bot::findHealablePlayer() const -> const World::PerceivedPlayer* {
 	const auto isPotentiallyHealable = [&](const auto& player) {
 		return this->isPotentiallyHealable(player);
 	};
-	const auto healableTeammates = util::filter(m_snapshot.players, isPotentiallyHealable);
-	if (const auto closestTeammate = ent::findClosestDistanceSquared(healableTeammates, m_snapshot.selfPlayer.position);
+	const auto healableTeammates = util::filter(m_players, isPotentiallyHealable);
+	if (const auto closestTeammate = ent::findClosestDistanceSquared(healableTeammates, m_self.position);
 	    closestTeammate.first != healableTeammates.end()) {
-		const auto speed = 1.0f / ProjectileType::heal_beam().getMoveInterval();
-		const auto time = ProjectileType::heal_beam().getDisappearTime();
-		if (const auto range = static_cast<int>(speed * time); closestTeammate.second <= range * range) {
+		if (const auto range = static_cast<int>(getHealRange()); closestTeammate.second <= range * range) {
 			return &*closestTeammate.first;
 		}
 	}
 	return nullptr;
 }
 
-auto Bot::findSpy() const -> const ent::sh::Player* {
+auto Bot::findSpy() const -> const World::PerceivedPlayer* {
 	const auto visibleSpies =
-		m_snapshot.players | util::filter([&](const auto& player) {
+		m_players | util::filter([&](const auto& player) {
 			if (player.playerClass != PlayerClass::spy()) {
 				return false;
 			}
 
-			if (const auto inFrontX = (player.position.x <= m_snapshot.selfPlayer.position.x && m_snapshot.selfPlayer.aimDirection.hasLeft()) ||
-		                              (player.position.x >= m_snapshot.selfPlayer.position.x && m_snapshot.selfPlayer.aimDirection.hasRight());
+			if (const auto inFrontX = (player.position.x <= m_self.position.x && m_self.aimDirection.hasLeft()) ||
+		                              (player.position.x >= m_self.position.x && m_self.aimDirection.hasRight());
 		        !inFrontX) {
 				return false;
 			}
-			if (const auto inFrontY = (player.position.y <= m_snapshot.selfPlayer.position.y && m_snapshot.selfPlayer.aimDirection.hasUp()) ||
-		                              (player.position.y >= m_snapshot.selfPlayer.position.y && m_snapshot.selfPlayer.aimDirection.hasDown());
+			if (const auto inFrontY = (player.position.y <= m_self.position.y && m_self.aimDirection.hasUp()) ||
+		                              (player.position.y >= m_self.position.y && m_self.aimDirection.hasDown());
 		        !inFrontY) {
 				return false;
 			}
-			return m_map->lineOfSight(m_snapshot.selfPlayer.position, player.position);
+			if (Vec2::distanceSquared(player.position, m_self.position) > this->getRangeSquared()) {
+				return false;
+			}
+			return m_visibilityCache->lineOfSight(m_self.position, player.position);
 		});
 
-	if (const auto closestSpy = ent::findClosestDistanceSquared(visibleSpies, m_snapshot.selfPlayer.position);
+	if (const auto closestSpy = ent::findClosestDistanceSquared(visibleSpies, m_self.position);
 	    closestSpy.first != visibleSpies.end() && closestSpy.second <= this->getRangeSquared()) {
 		return &*closestSpy.first;
 	}
 	return nullptr;
 }
 
-auto Bot::findEnemySentryGun() const -> const ent::sh::SentryGun* {
-	const auto visibleSentryGuns = m_snapshot.sentryGuns | util::filter([&](const auto& sentryGun) {
-									   return sentryGun.team != m_snapshot.selfPlayer.team &&
-		                                      m_map->lineOfSight(m_snapshot.selfPlayer.position, sentryGun.position);
+auto Bot::findEnemySentryGun() -> const World::PerceivedObject* {
+	m_world->perceiveSentryGunsInRange(m_self.position, static_cast<Vec2::Length>(bot_range), m_sentryGuns);
+	const auto visibleSentryGuns = m_sentryGuns | util::filter([&](const auto& sentryGun) {
+									   return sentryGun.team != m_self.team &&
+		                                      m_visibilityCache->lineOfSight(m_self.position, sentryGun.position);
 								   });
 
-	if (const auto& closestSentry = ent::findClosestDistanceSquared(visibleSentryGuns, m_snapshot.selfPlayer.position);
+	if (const auto& closestSentry = ent::findClosestDistanceSquared(visibleSentryGuns, m_self.position);
 	    closestSentry.first != visibleSentryGuns.end() && closestSentry.second <= this->getRangeSquared()) {
 		return &*closestSentry.first;
 	}
@@ -797,46 +882,56 @@ auto Bot::findEnemySentryGun() const -> const ent::sh::SentryGun* {
 }
 
 auto Bot::hasBuiltSentry() const -> bool {
-	return util::anyOf(m_snapshot.sentryGuns, [&](const auto& sentryGun) { return sentryGun.owner == m_id; });
+	return m_world->perceiveOwnedSentryGun(m_id);
 }
 
 auto Bot::isNearbySticky(Vec2 position) const -> bool {
 	const auto area = Rect{static_cast<Rect::Length>(position.x - 2), static_cast<Rect::Length>(position.y - 2), 5, 5};
-	return util::anyOf(m_snapshot.projectiles, [&](const auto& projectile) {
-		return projectile.owner == m_id && projectile.type == ProjectileType::sticky() && area.contains(projectile.position);
-	});
+	return m_world->perceiveOwnedSticky(m_id, area);
+}
+
+auto Bot::requestPath(Vec2 destination, Goal goal, PlanFallback fallback) -> void {
+	m_currentPath.clear();
+	m_currentNode = 0;
+	m_pathRequest = PathRequest{++m_pathRequestId, m_self.position, destination, m_self.team == Team::red(), m_self.team == Team::blue()};
+	m_waitingForPath = true;
+	m_planFallback = fallback;
+	++m_planStats.fullPlans;
+	m_currentGoal = goal;
+	m_currentState = State::PLANNING;
 }
 
 auto Bot::findPath(Vec2 destination) -> bool {
-	m_currentPath = m_map->findPath(m_snapshot.selfPlayer.position,
-	                                destination,
-	                                m_snapshot.selfPlayer.team == Team::red(),
-	                                m_snapshot.selfPlayer.team == Team::blue());
+	m_currentPath = m_map->findPath(m_self.position, destination, m_self.team == Team::red(), m_self.team == Team::blue());
 	m_currentNode = m_currentPath.size();
+	++m_planStats.fullPlans;
 	return !m_currentPath.empty();
 }
 
-auto Bot::directionDistribution() -> Bot::DirectionDistribution& {
-	static auto directionDistribution = DirectionDistribution{0, 8};
-	return directionDistribution;
-}
-
-auto Bot::healthDistribution() -> Bot::HealthDistribution& {
-	static auto healthDistribution = HealthDistribution{};
-	return healthDistribution;
-}
-
-auto Bot::classDistribution() -> Bot::ClassDistribution& {
-	static auto classDistribution = ClassDistribution{};
-	return classDistribution;
+auto Bot::repairPath() -> bool {
+	// Try to get back onto the part of the current path that is left instead of planning a new one from scratch.
+	const auto maxExpansions = static_cast<std::size_t>(static_cast<int>(bot_path_repair_limit));
+	const auto remainingPath = util::Span<const Vec2>{m_currentPath.data(), std::max(m_currentNode, std::size_t{1})};
+	auto path = m_map->repairPath(m_self.position, remainingPath, m_self.team == Team::red(), m_self.team == Team::blue(), maxExpansions);
+	if (path.empty()) {
+		if (maxExpansions != 0) {
+			++m_planStats.failedRepairs;
+		}
+		return false;
+	}
+	m_currentPath = std::move(path);
+	m_currentNode = m_currentPath.size();
+	++m_planStats.repairedPlans;
+	return true;
 }
 
-auto Bot::goalDistribution() -> Bot::GoalDistribution& {
-	static auto goalDistribution = GoalDistribution{};
-	return goalDistribution;
+auto Bot::sharedDistributions() -> Bot::Distributions& {
+	static auto sharedDistributions = Distributions{};
+	return sharedDistributions;
 }
 
-auto Bot::spyCheckDistribution() -> Bot::SpyCheckDistribution& {
-	static auto spyCheckDistribution = SpyCheckDistribution{};
-	return spyCheckDistribution;
+auto Bot::updateDistributions() const -> void {
+	if (const auto& shared = Bot::sharedDistributions(); m_distributions.version != shared.version) {
+		m_distributions = shared;
+	}
 }
@@ -9,9 +9,11 @@
 #include "../data/player_id.hpp"         // PlayerId
 #include "../data/team.hpp"              // Team
 #include "../data/vector.hpp"            // Vec2
-#include "../shared/snapshot.hpp"        // Snapshot
+#include "../shared/entities.hpp"        // ent::sh::SelfPlayer
+#include "world.hpp"                     // World
 
 #include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint32_t
 #include <optional>    // std::optional, std::nullopt
 #include <random>      // std::mt19937, std::uniform_int_distribution, std::bernoulli_distribution, std::discrete_distribution
 #include <string>      // std::string
@@ -20,20 +22,32 @@
 #include <vector>      // std::vector
 
 class Map;
-namespace ent {
-namespace sh {
-struct Player;
-struct SentryGun;
-} // namespace sh
-} // namespace ent
+class VisibilityCache;
 
 class Bot final {
 public:
 	using CoordinateDistributionX = std::uniform_int_distribution<decltype(Vec2::x)>;
 	using CoordinateDistributionY = std::uniform_int_distribution<decltype(Vec2::y)>;
 
-	Bot(const Map& map, std::mt19937& rng, CoordinateDistributionX& xCoordinateDistribution,
-	    CoordinateDistributionY& yCoordinateDistribution, PlayerId id, std::string name);
+	using Seed = std::mt19937::result_type;
+	using PathRequestId = std::uint32_t;
+
+	struct PathRequest final {
+		PathRequestId id;
+		Vec2 start;
+		Vec2 destination;
+		bool red;
+		bool blue;
+	};
+
+	struct PlanStats final {
+		std::size_t fullPlans = 0;
+		std::size_t repairedPlans = 0;
+		std::size_t failedRepairs = 0;
+	};
+
+	Bot(const Map& map, const World& world, Seed seed, CoordinateDistributionX xCoordinateDistribution,
+	    CoordinateDistributionY yCoordinateDistribution, PlayerId id, std::string name);
 
 	static auto updateHealthProbability() -> void;
 	static auto updateClassWeights() -> void;
@@ -42,20 +56,32 @@ public:
 
 	auto think(float deltaTime) -> void;
 
+	auto advanceThinkTimer(float deltaTime) -> void;
+	auto setTimeSinceThink(float time) -> void;
+	[[nodiscard]] auto getTimeSinceThink() const -> float;
+
+	// Some paths are solved by the server outside of think, under its bot AI time budget.
+	// The bot waits in the planning state until the result is handed back through onPathFound.
+	[[nodiscard]] auto takePathRequest() -> std::optional<PathRequest>;
+	[[nodiscard]] auto isWaitingForPath(PathRequestId id) const -> bool;
+	auto onPathFound(PathRequestId id, std::vector<Vec2> path) -> void;
+
+	// Get the number of paths planned since the last call.
+	[[nodiscard]] auto takePlanStats() -> PlanStats;
+
 	[[nodiscard]] auto getActions() const -> Actions;
 	[[nodiscard]] auto getId() const -> PlayerId;
 	[[nodiscard]] auto getRandomClass() const -> PlayerClass;
 	[[nodiscard]] auto getName() const -> std::string_view;
 
-	auto setSnapshot(Snapshot&& snapshot) -> void;
-	auto setSnapshot(const Snapshot& snapshot) -> void;
-
 private:
 	struct FoundPlayer final {
-		const ent::sh::Player& player;
+		const World::PerceivedPlayer& player;
 		float distance;
 	};
 
+	auto updatePerception() -> void;
+
 	auto onSpawn() -> void;
 	auto onDeath() -> void;
 
@@ -96,17 +122,18 @@ private:
 
 	[[nodiscard]] auto getRangeSquared() const -> Vec2::Length;
 
-	[[nodiscard]] auto isPotentialEnemy(const ent::sh::Player& player, bool requireLineOfSight) const -> bool;
-	[[nodiscard]] auto isPotentiallyHealable(const ent::sh::Player& player) const -> bool;
+	[[nodiscard]] auto isPotentialEnemy(const World::PerceivedPlayer& player, bool requireLineOfSight) const -> bool;
+	[[nodiscard]] auto isPotentiallyHealable(const World::PerceivedPlayer& player) const -> bool;
 
 	[[nodiscard]] auto findEnemyPlayer(bool requireLineOfSight) const -> std::optional<FoundPlayer>;
-	[[nodiscard]] auto findHealablePlayer() const -> const ent::sh::Player*;
-	[[nodiscard]] auto findSpy() const -> const ent::sh::Player*;
-	[[nodiscard]] auto findEnemySentryGun() const -> const ent::sh::SentryGun*;
+	[[nodiscard]] auto findHealablePlayer() const -> const World::PerceivedPlayer*;
+	[[nodiscard]] auto findSpy() const -> const World::PerceivedPlayer*;
+	[[nodiscard]] auto findEnemySentryGun() -> const World::PerceivedObject*;
 
 	[[nodiscard]] auto hasBuiltSentry() const -> bool;
 	[[nodiscard]] auto isNearbySticky(Vec2 position) const -> bool;
 	[[nodiscard]] auto findPath(Vec2 destination) -> bool;
+	[[nodiscard]] auto repairPath() -> bool;
 
 	enum class Goal {
 		GET_OBJECTIVE,
@@ -121,8 +148,16 @@ private:
 		GOING,
 		WAITING,
 		FIGHTING,
+		PLANNING,
+	};
+
+	enum class PlanFallback {
+		ROAM,
+		RANDOM_GOAL,
 	};
 
+	auto requestPath(Vec2 destination, Goal goal, PlanFallback fallback) -> void;
+
 	enum class HealingState {
 		NONE,
 		HEALING,
@@ -142,24 +177,45 @@ private:
 	using GoalDistribution = std::discrete_distribution<unsigned short>;
 	using SpyCheckDistribution = std::bernoulli_distribution;
 
-	static auto directionDistribution() -> DirectionDistribution&;
-	static auto healthDistribution() -> HealthDistribution&;
-	static auto classDistribution() -> ClassDistribution&;
-	static auto goalDistribution() -> GoalDistribution&;
-	static auto spyCheckDistribution() -> SpyCheckDistribution&;
+	struct Distributions final {
+		DirectionDistribution direction{0, 8};
+		HealthDistribution health{};
+		ClassDistribution playerClass{};
+		GoalDistribution goal{};
+		SpyCheckDistribution spyCheck{};
+		unsigned version = 0;
+	};
+
+	// Shared settings, updated from the bot cvars. Each bot works on its own copy so that bots can think in parallel.
+	static auto sharedDistributions() -> Distributions&;
+
+	auto updateDistributions() const -> void;
 
 	util::Reference<const Map> m_map;
-	util::Reference<std::mt19937> m_rng;
-	util::Reference<CoordinateDistributionX> m_xCoordinateDistribution;
-	util::Reference<CoordinateDistributionY> m_yCoordinateDistribution;
+	util::Reference<const World> m_world;
+	util::Reference<const VisibilityCache> m_visibilityCache;
+	mutable std::mt19937 m_rng;
+	mutable Distributions m_distributions;
+	mutable CoordinateDistributionX m_xCoordinateDistribution;
+	mutable CoordinateDistributionY m_yCoordinateDistribution;
 	PlayerId m_id;
 	std::string m_name;
-	Snapshot m_snapshot{};
+	ent::sh::SelfPlayer m_self{};
+	std::vector<World::PerceivedPlayer> m_players{};
+	std::vector<World::PerceivedObject> m_sentryGuns{};
+	std::vector<World::PerceivedObject> m_flags{};
+	std::vector<World::PerceivedObject> m_carts{};
 	Actions m_actions = Action::NONE;
 	Goal m_currentGoal = Goal::GET_OBJECTIVE;
 	State m_currentState = State::DEAD;
 	std::vector<Vec2> m_currentPath{};
 	std::size_t m_currentNode = 0;
+	std::optional<PathRequest> m_pathRequest{};
+	PathRequestId m_pathRequestId = 0;
+	bool m_waitingForPath = false;
+	PlanFallback m_planFallback = PlanFallback::ROAM;
+	float m_timeSinceThink = 0.0f;
+	PlanStats m_planStats{};
 	util::Countdown<float> m_waitTimer{};
 	HealingState m_healingState = HealingState::NONE;
 	util::Countdown<float> m_healingTimer{};
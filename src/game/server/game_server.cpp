@@ -2,18 +2,18 @@
 
 #include "../../console/command.hpp"                       // cmd::...
 #include "../../console/command_utilities.hpp"             // cmd::...
-#include "../../console/commands/file_commands.hpp"        // data_dir, data_subdir_cfg, data_subdir_maps
+#include "../../console/commands/file_commands.hpp"        // data_dir, data_subdir_cfg, data_subdir_maps, data_subdir_downloads
 #include "../../console/commands/game_commands.hpp"        // game_version, game_url, cmd_disconnect, cmd_quit
 #include "../../console/commands/game_server_commands.hpp" // sv_...
 #include "../../console/commands/meta_client_commands.hpp" // meta_address, meta_port
-#include "../../console/commands/process_commands.hpp"     // cmd_import, cmd_file
+#include "../../console/commands/process_commands.hpp"     // cmd_import, cmd_file, process_budget
 #include "../../console/con_command.hpp"                   // GET_COMMAND
 #include "../../console/process.hpp"                       // Process
 #include "../../debug.hpp"                                 // Msg, DEBUG_MSG, DEBUG_MSG_INDENT, INFO_MSG, INFO_MSG_INDENT
-#include "../../network/byte_stream.hpp"                   // net::ByteOutputStream
+#include "../../network/byte_stream.hpp"                   // net::ByteInputStream, net::ByteOutputStream
 #include "../../network/delta.hpp"                         // deltaCompress
 #include "../../utilities/algorithm.hpp" // util::erase, util::eraseIf, util::transform, util::collect, util::anyOf, util::enumerate, util::findIf, util::contains, util::copy, util::countIf, util::replace
-#include "../../utilities/file.hpp"      // util::readFile
+#include "../../utilities/file.hpp"      // util::readFile, util::replaceFile
 #include "../../utilities/string.hpp"    // util::join, util::icontains, util::iequals, util::contains, util::toString
 #include "../../utilities/time.hpp"      // util::getLocalTimeStr
 #include "../data/actions.hpp"           // Actions, Action
@@ -21,17 +21,23 @@
 #include "../game.hpp"                   // Game
 #include "../meta/meta_client_messages.hpp" // MetaClientOutputMessages, msg::meta::cl::out::...
 #include "../meta/meta_server_messages.hpp" // MetaServerOutputMessages, msg::meta::sv::out::...
+#include "../shared/map.hpp"             // Map
 
-#include <algorithm>    // std::max
+#include <algorithm>    // std::max, std::sort, std::find, std::find_if
 #include <array>        // std::array
 #include <chrono>       // std::chrono::...
-#include <cmath>        // std::ceil
+#include <cmath>        // std::ceil, std::lround
+#include <cstddef>      // std::ptrdiff_t
+#include <exception>    // std::exception
 #include <filesystem>   // std::filesystem::...
 #include <fmt/core.h>   // fmt::format
+#include <future>       // std::async, std::launch, std::future_status
 #include <iterator>     // std::prev
 #include <ratio>        // std::milli
+#include <string_view>  // std::string_view
 #include <system_error> // std::error_code
 #include <tuple>        // std::tie
+#include <variant>      // std::get_if
 
 auto GameServer::getConfigHeader() -> std::string {
 	return fmt::format(
@@ -70,6 +76,7 @@ GameServer::GameServer(Game& game, VirtualMachine& vm, std::shared_ptr<Environme
 	this->updateSpamLimit();
 	this->updateTickrate();
 	this->updateBotTickrate();
+	this->updateBotThreads();
 	this->updateConfigAutoSaveInterval();
 	this->updateResourceUploadInterval();
 	this->updateAllowResourceDownload();
@@ -80,6 +87,9 @@ GameServer::GameServer(Game& game, VirtualMachine& vm, std::shared_ptr<Environme
 }
 
 GameServer::~GameServer() {
+	if (m_pendingConfigSave.valid()) {
+		m_pendingConfigSave.wait();
+	}
 	GameServer::modifiedCvars().clear();
 }
 
@@ -127,6 +137,14 @@ auto GameServer::init() -> bool {
 		return false;
 	}
 
+	// Load inventory database. Inventories from configs written before the database was enabled are kept and saved to it.
+	if (!sv_inventory_file.empty()) {
+		if (!this->loadInventoryDatabase(fmt::format("{}/{}/{}", data_dir, data_subdir_cfg, sv_inventory_file))) {
+			m_game.error(fmt::format("Failed to load inventory database \"{}\"!", sv_inventory_file));
+			return false;
+		}
+	}
+
 	// Load map.
 	if (!this->loadMap()) {
 		return false;
@@ -189,13 +207,26 @@ auto GameServer::update(float deltaTime) -> bool {
 				return false;
 			}
 		}
-		this->updateConfigAutoSave(deltaTime);
-		this->receivePackets();
-		this->updateConnections();
-		this->updateMetaServerConnection(deltaTime);
-		this->updateRconServer(deltaTime);
-		this->updateTicks(deltaTime);
-		this->updateProcess();
+		{
+			const auto totalTimer = m_perf.measure(ServerPerfPhase::TOTAL);
+			this->updateConfigAutoSave(deltaTime);
+			{
+				const auto timer = m_perf.measure(ServerPerfPhase::RECEIVE);
+				this->receivePackets();
+			}
+			{
+				const auto timer = m_perf.measure(ServerPerfPhase::CONNECTIONS);
+				this->updateConnections();
+			}
+			this->updateMetaServerConnection(deltaTime);
+			this->updateRconServer(deltaTime);
+			this->updateTicks(deltaTime);
+			{
+				const auto timer = m_perf.measure(ServerPerfPhase::PROCESS);
+				this->updateProcess();
+			}
+		}
+		this->updatePerf(deltaTime);
 	}
 	return true;
 }
@@ -230,7 +261,10 @@ auto GameServer::updateTickrate() -> void {
 
 auto GameServer::updateBotTickrate() -> void {
 	m_botTickInterval = 1.0f / static_cast<float>(sv_bot_tickrate);
-	m_botTickTimer.reset();
+}
+
+auto GameServer::updateBotThreads() -> void {
+	m_botThreadPool.resize(static_cast<std::size_t>(static_cast<int>(sv_bot_threads)));
 }
 
 auto GameServer::updateConfigAutoSaveInterval() -> void {
@@ -252,6 +286,9 @@ auto GameServer::updateAllowResourceDownload() -> void {
 	for (auto& resource : m_resourceInfo) {
 		resource.canDownload = sv_allow_resource_download;
 	}
+	for (auto& resource : m_prefetchResourceInfo) {
+		resource.canDownload = sv_allow_resource_download;
+	}
 }
 
 auto GameServer::updateMetaSubmit() -> void {
@@ -343,6 +380,7 @@ auto GameServer::getStatusString() const -> std::string {
 		"Map: \"{}\"\n"
 		"Map time: {} s\n"
 		"Players: {}/{} ({} bots)\n"
+		"Script hooks:{}\n"
 		"Clients:\n"
 		"{}\n"
 		"=====================",
@@ -356,6 +394,7 @@ auto GameServer::getStatusString() const -> std::string {
 		m_world.getPlayerCount(),
 		sv_playerlimit,
 		m_bots.size(),
+		this->getHookStatusString(),
 		m_clients | util::transform(formatClient) | util::join("\n\n"));
 }
 
@@ -392,10 +431,15 @@ auto GameServer::addBot(std::string name, Team team, PlayerClass playerClass) ->
 
 	name = this->findValidUsername(fmt::format("BOT {}", name));
 	if (const auto playerId = m_world.createPlayer(Vec2{m_game.map().getWidth() / 2, m_game.map().getHeight() / 2}, name); playerId != PLAYER_ID_UNCONNECTED) {
-		const auto& bot = m_bots.emplace_back(m_game.map(), m_vm.rng(), m_xCoordinateDistribution, m_yCoordinateDistribution, playerId, std::move(name));
+		auto& bot = m_bots.emplace_back(m_game.map(), m_world, m_vm.rng()(), m_xCoordinateDistribution, m_yCoordinateDistribution, playerId, std::move(name));
+
+		// Spread the bots out over the ticks between bot thinks so that they don't all think on the same tick.
+		const auto ticksPerThink = std::max(std::size_t{1}, static_cast<std::size_t>(std::lround(m_botTickInterval / m_tickInterval)));
+		bot.setTimeSinceThink(static_cast<float>(m_bots.size() % ticksPerThink) * m_tickInterval);
+
 		const auto validTeam = (team != Team::none() && team != Team::spectators()) ? team : BOT_TEAMS[m_currentBotIndex++ % BOT_TEAMS.size()];
 		const auto validClass = (playerClass != PlayerClass::none() && playerClass != PlayerClass::spectator()) ? playerClass : bot.getRandomClass();
-		this->callIfDefined(Script::command({"on_player_join", cmd::formatPlayerId(playerId)}));
+		this->callHook(ScriptHook::on_player_join, playerId);
 		return m_world.playerTeamSelect(playerId, validTeam, validClass);
 	}
 	return false;
@@ -421,6 +465,7 @@ auto GameServer::kickAllBots() -> void {
 		m_world.deletePlayer(bot.getId());
 	}
 	m_bots.clear();
+	m_botPathRequests.clear();
 }
 
 auto GameServer::freezeBots() -> void {
@@ -431,6 +476,39 @@ auto GameServer::freezeBots() -> void {
 	}
 }
 
+auto GameServer::testBotDeterminism(int tickCount) -> std::optional<TickCount> {
+	const auto threadCount = m_botThreadPool.size();
+	const auto world = m_world.saveState();
+	const auto bots = m_bots;
+	const auto botPathRequests = m_botPathRequests;
+	const auto rng = m_vm.rng();
+
+	auto hashes = std::vector<util::CRC32>{};
+	hashes.reserve(static_cast<std::size_t>(tickCount));
+	m_botThreadPool.resize(0);
+	for (auto i = 0; i < tickCount; ++i) {
+		this->tick();
+		hashes.push_back(m_world.hashState());
+	}
+
+	m_world.restoreState(world);
+	m_bots = bots;
+	m_botPathRequests = botPathRequests;
+	m_vm.rng() = rng;
+
+	// Always use real worker threads for the second run, even if the server itself thinks on the main thread only.
+	m_botThreadPool.resize(std::max(threadCount, std::size_t{2}));
+	auto mismatch = std::optional<TickCount>{};
+	for (const auto& hash : hashes) {
+		this->tick();
+		if (!mismatch && m_world.hashState() != hash) {
+			mismatch = m_world.getTickCount();
+		}
+	}
+	m_botThreadPool.resize(threadCount);
+	return mismatch;
+}
+
 auto GameServer::getBannedPlayers() const -> const BannedPlayers& {
 	return m_bannedPlayers;
 }
@@ -546,6 +624,10 @@ auto GameServer::resetClients() -> void {
 	for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
 		this->resetClient(it);
 	}
+	for (auto& pooled : m_snapshotPool) {
+		pooled.tickCount = 0;
+		pooled.viewCount = 0;
+	}
 }
 
 auto GameServer::resetEnvironment() -> void {
@@ -571,7 +653,7 @@ auto GameServer::writeCommandError(net::IpEndpoint endpoint, std::string_view me
 
 auto GameServer::writeServerChatMessage(std::string_view message) -> void {
 	INFO_MSG(Msg::CHAT, "[SERVER]: {}", message);
-	const auto msg = msg::cl::out::ServerChatMessage{{}, message};
+	const auto msg = GameServer::shareMessage(msg::cl::out::ServerChatMessage{{}, message});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
 			if (!client.write(msg)) {
@@ -583,7 +665,7 @@ auto GameServer::writeServerChatMessage(std::string_view message) -> void {
 
 auto GameServer::writeServerChatMessage(std::string_view message, Team team) -> void {
 	INFO_MSG(Msg::CHAT, "[SERVER to team {}]: {}", team.getName(), message);
-	const auto msg = msg::cl::out::ServerChatMessage{{}, message};
+	const auto msg = GameServer::shareMessage(msg::cl::out::ServerChatMessage{{}, message});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (const auto& player = m_world.findPlayer(playerId)) {
 			if (player.getTeam() == team) {
@@ -616,7 +698,7 @@ auto GameServer::writeServerChatMessagePersonal(std::string_view message, Player
 
 auto GameServer::writeServerEventMessage(std::string_view message) -> void {
 	INFO_MSG(Msg::CHAT, "[SERVER Event]: {}", message);
-	const auto msg = msg::cl::out::ServerEventMessage{{}, message};
+	const auto msg = GameServer::shareMessage(msg::cl::out::ServerEventMessage{{}, message});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
 			if (!client.write(msg)) {
@@ -630,7 +712,7 @@ auto GameServer::writeServerEventMessage(std::string_view message) -> void {
 
 auto GameServer::writeServerEventMessage(std::string_view message, Team team) -> void {
 	INFO_MSG(Msg::CHAT, "[SERVER Event to team {}]: {}", team.getName(), message);
-	const auto msg = msg::cl::out::ServerEventMessage{{}, message};
+	const auto msg = GameServer::shareMessage(msg::cl::out::ServerEventMessage{{}, message});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (const auto& player = m_world.findPlayer(playerId)) {
 			if (player.getTeam() == team) {
@@ -646,11 +728,12 @@ auto GameServer::writeServerEventMessage(std::string_view message, Team team) ->
 
 auto GameServer::writeServerEventMessage(std::string_view message, util::Span<const PlayerId> relevantPlayerIds) -> void {
 	INFO_MSG(Msg::CHAT, "[SERVER Event]: {}", message);
-	const auto msg = msg::cl::out::ServerEventMessage{{}, message};
+	const auto msg = GameServer::shareMessage(msg::cl::out::ServerEventMessage{{}, message});
+	const auto personalMsg = GameServer::shareMessage(msg::cl::out::ServerEventMessagePersonal{{}, message});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
 			if (util::contains(relevantPlayerIds, playerId)) {
-				if (!client.write(msg::cl::out::ServerEventMessagePersonal{{}, msg.message})) {
+				if (!client.write(personalMsg)) {
 					INFO_MSG(Msg::CHAT | Msg::SERVER | Msg::CONNECTION_EVENT,
 					         "Game server: Failed to write team server event message to \"{}\".",
 					         std::string{endpoint});
@@ -718,9 +801,10 @@ auto GameServer::writeHitConfirmed(Health damage, PlayerId playerId) -> void {
 }
 
 auto GameServer::playWorldSound(SoundId soundId, Vec2 position) -> void {
+	const auto msg = GameServer::shareMessage(msg::cl::out::PlaySoundPositionalUnreliable{{}, soundId, position});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
-			if (!client.write(msg::cl::out::PlaySoundPositionalUnreliable{{}, soundId, position})) {
+			if (!client.write(msg)) {
 				INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write positional world sound message to \"{}\".", std::string{endpoint});
 			}
 		}
@@ -728,6 +812,7 @@ auto GameServer::playWorldSound(SoundId soundId, Vec2 position) -> void {
 }
 
 auto GameServer::playWorldSound(SoundId soundId, Vec2 position, PlayerId source) -> void {
+	const auto msg = GameServer::shareMessage(msg::cl::out::PlaySoundPositionalUnreliable{{}, soundId, position});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
 			if (playerId == source) {
@@ -735,7 +820,7 @@ auto GameServer::playWorldSound(SoundId soundId, Vec2 position, PlayerId source)
 					INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write world sound message to \"{}\".", std::string{endpoint});
 				}
 			} else {
-				if (!client.write(msg::cl::out::PlaySoundPositionalUnreliable{{}, soundId, position})) {
+				if (!client.write(msg)) {
 					INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT,
 					         "Game server: Failed to write positional world sound message to \"{}\".",
 					         std::string{endpoint});
@@ -746,10 +831,11 @@ auto GameServer::playWorldSound(SoundId soundId, Vec2 position, PlayerId source)
 }
 
 auto GameServer::playTeamSound(SoundId soundId, Team team) -> void {
+	const auto msg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, soundId});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (const auto& player = m_world.findPlayer(playerId)) {
 			if (player.getTeam() == team) {
-				if (!client.write(msg::cl::out::PlaySoundReliable{{}, soundId})) {
+				if (!client.write(msg)) {
 					INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write team sound message to \"{}\".", std::string{endpoint});
 				}
 			}
@@ -758,14 +844,16 @@ auto GameServer::playTeamSound(SoundId soundId, Team team) -> void {
 }
 
 auto GameServer::playTeamSound(SoundId correctTeamId, SoundId otherTeamId, Team team) -> void {
+	const auto correctTeamMsg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, correctTeamId});
+	const auto otherTeamMsg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, otherTeamId});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (const auto& player = m_world.findPlayer(playerId)) {
 			if (player.getTeam() == team) {
-				if (!client.write(msg::cl::out::PlaySoundReliable{{}, correctTeamId})) {
+				if (!client.write(correctTeamMsg)) {
 					INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write team sound message to \"{}\".", std::string{endpoint});
 				}
 			} else {
-				if (!client.write(msg::cl::out::PlaySoundReliable{{}, otherTeamId})) {
+				if (!client.write(otherTeamMsg)) {
 					INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write team sound message to \"{}\".", std::string{endpoint});
 				}
 			}
@@ -785,9 +873,10 @@ auto GameServer::playPlayerInterfaceSound(SoundId soundId, PlayerId playerId) ->
 }
 
 auto GameServer::playGameSound(SoundId soundId) -> void {
+	const auto msg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, soundId});
 	for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 		if (playerId != PLAYER_ID_UNCONNECTED) {
-			if (!client.write(msg::cl::out::PlaySoundReliable{{}, soundId})) {
+			if (!client.write(msg)) {
 				INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write game sound message to \"{}\".", std::string{endpoint});
 			}
 		}
@@ -843,7 +932,7 @@ auto GameServer::handleMessage(net::msg::in::Connect&&) -> void {
 
 	if (endpoint == m_metaServerEndpoint) {
 		if (sv_meta_submit) {
-			if (!client.connection.write<MetaServerOutputMessages>(msg::meta::sv::out::Heartbeat{{}})) {
+			if (!this->writeHeartbeat(client)) {
 				this->disconnectClient(m_currentClient, "Failed to write initial heartbeat.");
 			}
 		} else {
@@ -952,13 +1041,21 @@ auto GameServer::handleMessage(msg::sv::in::JoinRequest&& msg) -> void {
 		return;
 	}
 
+	// Let the client start downloading the next map while it plays this one.
+	if (!m_prefetchResourceInfo.empty()) {
+		if (!client.write(msg::cl::out::ResourcePrefetch{{}, m_prefetchResourceInfo})) {
+			this->disconnectClient(m_currentClient, "Failed to write resource prefetch message.");
+			return;
+		}
+	}
+
 	auto joinMessage = fmt::format("{} has joined the game.", username);
 	this->writeServerChatMessage(joinMessage);
 	m_game.println(std::move(joinMessage));
 
 	INFO_MSG(Msg::SERVER, "Game server: Client \"{}\" ({}) successfully joined with player id \"{}\".", std::string{endpoint}, username, playerId);
 
-	this->callIfDefined(Script::command({"on_player_join", cmd::formatPlayerId(playerId)}));
+	this->callHook(ScriptHook::on_player_join, playerId);
 }
 
 auto GameServer::handleMessage(msg::sv::in::UserCmd&& msg) -> void {
@@ -997,10 +1094,11 @@ auto GameServer::handleMessage(msg::sv::in::ChatMessage&& msg) -> void {
 		m_game.println(fmt::format("[CHAT] {}: {}", username, message));
 	}
 
+	const auto chatMsg = GameServer::shareMessage(msg::cl::out::ChatMessage{{}, playerId, message});
+	const auto soundMsg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, SoundId::chat_message()});
 	for (auto& [otherClient, otherEndpoint, otherAddress, otherUsername, otherPlayerId, otherInventoryId, otherRconToken] : m_clients) {
 		if (otherPlayerId != PLAYER_ID_UNCONNECTED) {
-			if (!otherClient.write(msg::cl::out::ChatMessage{{}, playerId, message}) ||
-			    !otherClient.write(msg::cl::out::PlaySoundReliable{{}, SoundId::chat_message()})) {
+			if (!otherClient.write(chatMsg) || !otherClient.write(soundMsg)) {
 				INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT | Msg::CHAT,
 				         "Game server: Failed to write chat message from \"{}\" to \"{}\".",
 				         std::string{endpoint},
@@ -1009,7 +1107,7 @@ auto GameServer::handleMessage(msg::sv::in::ChatMessage&& msg) -> void {
 		}
 	}
 
-	this->callIfDefined(Script::command({"on_chat", cmd::formatIpEndpoint(endpoint), message}));
+	this->callHook(ScriptHook::on_chat, cmd::formatIpEndpoint(endpoint), message);
 }
 
 auto GameServer::handleMessage(msg::sv::in::TeamChatMessage&& msg) -> void {
@@ -1029,12 +1127,13 @@ auto GameServer::handleMessage(msg::sv::in::TeamChatMessage&& msg) -> void {
 			m_game.println(fmt::format("[{} CHAT] {}: {}", player.getTeam().getName(), username, message));
 		}
 
+		const auto chatMsg = GameServer::shareMessage(msg::cl::out::TeamChatMessage{{}, playerId, message});
+		const auto soundMsg = GameServer::shareMessage(msg::cl::out::PlaySoundReliable{{}, SoundId::chat_message()});
 		for (auto& [otherClient, otherEndpoint, otherAddress, otherUsername, otherPlayerId, otherInventoryId, otherRconToken] : m_clients) {
 			if (otherPlayerId != PLAYER_ID_UNCONNECTED) {
 				if (const auto& otherPlayer = m_world.findPlayer(otherPlayerId)) {
 					if (otherPlayer.getTeam() == player.getTeam()) {
-						if (!otherClient.write(msg::cl::out::TeamChatMessage{{}, playerId, message}) ||
-						    !otherClient.write(msg::cl::out::PlaySoundReliable{{}, SoundId::chat_message()})) {
+						if (!otherClient.write(chatMsg) || !otherClient.write(soundMsg)) {
 							INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT | Msg::CHAT,
 							         "Game server: Failed to write team chat message from \"{}\" to \"{}\".",
 							         std::string{endpoint},
@@ -1045,7 +1144,7 @@ auto GameServer::handleMessage(msg::sv::in::TeamChatMessage&& msg) -> void {
 			}
 		}
 
-		this->callIfDefined(Script::command({"on_team_chat", cmd::formatIpEndpoint(endpoint), cmd::formatTeamId(player.getTeam()), message}));
+		this->callHook(ScriptHook::on_team_chat, cmd::formatIpEndpoint(endpoint), player.getTeam().getId(), message);
 	}
 }
 
@@ -1093,21 +1192,18 @@ auto GameServer::handleMessage(msg::sv::in::ResourceDownloadRequest&& msg) -> vo
 			return;
 		}
 
-		INFO_MSG(Msg::SERVER, "Game server uploading {} to \"{}\".", it->second.name, std::string{endpoint});
-		const auto chunkSize = static_cast<std::size_t>(sv_resource_upload_chunk_size);
-		if (it->second.data.size() <= chunkSize) {
-			if (!client.write(msg::cl::out::ResourceDownloadLast{{}, it->first, it->second.data})) {
-				this->disconnectClient(m_currentClient, "Failed to write resource.");
-				return;
-			}
-		} else {
-			if (!client.write(msg::cl::out::ResourceDownloadPart{{}, it->first, it->second.data.substr(0, chunkSize)})) {
-				this->disconnectClient(m_currentClient, "Failed to write first resource part.");
-				return;
-			}
-			client.resourceUpload = &*it;
-			client.resourceUploadProgress = chunkSize;
-			client.resourceUploadTimer.reset();
+		if (msg.offset > it->second.data.size()) {
+			this->disconnectClient(m_currentClient, "Invalid resource download offset.");
+			return;
+		}
+
+		INFO_MSG(Msg::SERVER, "Game server uploading {} to \"{}\" from offset {}.", it->second.name, std::string{endpoint}, msg.offset);
+		client.resourceUpload = &*it;
+		client.resourceUploadProgress = static_cast<std::size_t>(msg.offset);
+		client.resourceUploadTimer.reset();
+		if (!this->writeResourceUploadPart(client)) {
+			this->disconnectClient(m_currentClient, "Failed to write first resource part.");
+			return;
 		}
 	} else {
 		this->disconnectClient(m_currentClient, "Resource download request denied.");
@@ -1159,14 +1255,21 @@ auto GameServer::handleMessage(msg::sv::in::ForwardedCommand&& msg) -> void {
 		return;
 	}
 
-	auto command = Script::Command{};
-	command.reserve(msg.command.size() + 2);
-	command.emplace_back("on_server_receive_command");
-	command.emplace_back(std::string{endpoint});
+	if (m_hooks[static_cast<std::size_t>(ScriptHook::on_server_receive_command)].symbol->definitions == 0) {
+		return;
+	}
+	auto& hook = this->resolveHook(ScriptHook::on_server_receive_command);
+	if (!hook.defined) {
+		return;
+	}
+
+	auto arguments = cmd::CommandArguments{};
+	arguments.reserve(msg.command.size() + 1);
+	arguments.push_back(cmd::done(std::string{endpoint}));
 	for (auto& arg : msg.command) {
-		command.emplace_back(std::move(arg));
+		arguments.push_back(cmd::done(std::move(arg)));
 	}
-	this->callIfDefined(std::move(command));
+	this->dispatchHook(hook, std::move(arguments));
 }
 
 auto GameServer::handleMessage(msg::sv::in::HeartbeatRequest&&) -> void {
@@ -1177,7 +1280,7 @@ auto GameServer::handleMessage(msg::sv::in::HeartbeatRequest&&) -> void {
 	auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] = *m_currentClient;
 	if (endpoint == m_metaServerEndpoint) {
 		client.afkTimer.reset();
-		if (!client.connection.write<MetaServerOutputMessages>(msg::meta::sv::out::Heartbeat{{}})) {
+		if (!this->writeHeartbeat(client)) {
 			this->disconnectClient(m_currentClient, "Failed to write heartbeat.");
 		}
 		m_metaServerRetryTimer.reset();
@@ -1378,26 +1481,237 @@ auto GameServer::tick() -> void {
 	DEBUG_MSG_INDENT(Msg::SERVER_TICK | Msg::CONNECTION_DETAILED, "Tick @ {} ms", m_tickInterval * 1000.0f) {
 		// Update bots.
 		if (sv_bot_ai_enable && (!sv_bot_ai_require_players || this->hasPlayers())) {
-			if (m_botTickTimer.advance(m_tickInterval, m_botTickInterval)) {
-				for (auto& bot : m_bots) {
-					if (auto&& player = m_world.findPlayer(bot.getId())) {
-						bot.setSnapshot(m_world.takeSnapshot(bot.getId()));
-						bot.think(m_botTickInterval);
-						player.setActions(bot.getActions());
-					}
-				}
-			}
+			const auto timer = m_perf.measure(ServerPerfPhase::BOTS);
+			this->updateBots();
 		}
 
 		// Update entity state.
+		const auto timer = m_perf.measure(ServerPerfPhase::WORLD);
 		m_world.update(m_tickInterval);
 	}
 }
 
+auto GameServer::updateBots() -> void {
+	using Clock = std::chrono::steady_clock;
+
+	// The limits count bots and paths instead of measuring time, so that which bots think on a given tick only depends on the
+	// state of the game and not on how fast the machine is.
+	const auto maxThinks = static_cast<std::size_t>(static_cast<int>(sv_bot_ai_max_thinks));
+	const auto maxPaths = static_cast<std::size_t>(static_cast<int>(sv_bot_ai_max_paths));
+
+	const auto startTime = Clock::now();
+
+	auto stats = BotAiStats{};
+
+	// Collect the bots that are due to think, most overdue first so that bots that were deferred on an earlier tick get to go next.
+	m_thinkingBots.clear();
+	for (auto& bot : m_bots) {
+		bot.advanceThinkTimer(m_tickInterval);
+		if (bot.getTimeSinceThink() + m_tickInterval * 0.5f >= m_botTickInterval && m_world.hasPlayerId(bot.getId())) {
+			m_thinkingBots.push_back(&bot);
+		}
+	}
+	std::stable_sort(m_thinkingBots.begin(), m_thinkingBots.end(), [](const Bot* lhs, const Bot* rhs) {
+		return lhs->getTimeSinceThink() > rhs->getTimeSinceThink();
+	});
+	if (maxThinks != 0 && m_thinkingBots.size() > maxThinks) {
+		stats.deferredThinks = m_thinkingBots.size() - maxThinks;
+		m_thinkingBots.resize(maxThinks);
+	}
+
+	this->thinkBots(m_thinkingBots);
+	for (auto* const bot : m_thinkingBots) {
+		++stats.thinks;
+		if (auto&& player = m_world.findPlayer(bot->getId())) {
+			player.setActions(bot->getActions());
+		}
+		if (auto request = bot->takePathRequest()) {
+			m_botPathRequests.push_back(BotPathRequest{bot->getId(), *request});
+		}
+		const auto plans = bot->takePlanStats();
+		stats.plans.fullPlans += plans.fullPlans;
+		stats.plans.repairedPlans += plans.repairedPlans;
+		stats.plans.failedRepairs += plans.failedRepairs;
+	}
+
+	const auto pathStartTime = Clock::now();
+	stats.thinkTime = std::chrono::duration_cast<std::chrono::microseconds>(pathStartTime - startTime);
+
+	// Solve queued paths in the order they were requested.
+	while (!m_botPathRequests.empty() && (maxPaths == 0 || stats.pathsSolved < maxPaths)) {
+		const auto [botId, request] = m_botPathRequests.front();
+		m_botPathRequests.pop_front();
+		const auto it = util::findIf(m_bots, [botId = botId](const auto& bot) { return bot.getId() == botId; });
+		if (it != m_bots.end() && it->isWaitingForPath(request.id)) {
+			it->onPathFound(request.id, m_game.map().findPath(request.start, request.destination, request.red, request.blue));
+			++stats.pathsSolved;
+		}
+	}
+	stats.pathTime = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - pathStartTime);
+
+	m_botAiStats = stats;
+	m_botAiTotals.thinkTime += stats.thinkTime;
+	m_botAiTotals.pathTime += stats.pathTime;
+	m_botAiTotals.thinks += stats.thinks;
+	m_botAiTotals.deferredThinks += stats.deferredThinks;
+	m_botAiTotals.pathsSolved += stats.pathsSolved;
+	m_botAiTotals.plans.fullPlans += stats.plans.fullPlans;
+	m_botAiTotals.plans.repairedPlans += stats.plans.repairedPlans;
+	m_botAiTotals.plans.failedRepairs += stats.plans.failedRepairs;
+}
+
+auto GameServer::thinkBots(const std::vector<Bot*>& bots) -> void {
+	// Bots only read the world while thinking and write to their own state, so they can all think at the same time.
+	m_botThreadPool.parallelFor(bots.size(), [&](std::size_t i) { bots[i]->think(bots[i]->getTimeSinceThink()); });
+}
+
+auto GameServer::getBotAiStatusString() const -> std::string {
+	return fmt::format(
+		"Bots: {}\n"
+		"Last tick: {} thinks ({} deferred) in {} us, {} paths solved in {} us, {} paths queued.\n"
+		"Total: {} thinks ({} deferred) in {} ms, {} paths solved in {} ms.\n"
+		"Plans: {} full, {} repaired, {} failed repairs.",
+		m_bots.size(),
+		m_botAiStats.thinks,
+		m_botAiStats.deferredThinks,
+		m_botAiStats.thinkTime.count(),
+		m_botAiStats.pathsSolved,
+		m_botAiStats.pathTime.count(),
+		m_botPathRequests.size(),
+		m_botAiTotals.thinks,
+		m_botAiTotals.deferredThinks,
+		std::chrono::duration_cast<std::chrono::milliseconds>(m_botAiTotals.thinkTime).count(),
+		m_botAiTotals.pathsSolved,
+		std::chrono::duration_cast<std::chrono::milliseconds>(m_botAiTotals.pathTime).count(),
+		m_botAiTotals.plans.fullPlans,
+		m_botAiTotals.plans.repairedPlans,
+		m_botAiTotals.plans.failedRepairs);
+}
+
+auto GameServer::writeConfig() -> ConfigSaveResult {
+	this->waitForConfigSave();
+	return this->finishConfigSave(GameServer::runConfigSave(this->makeConfigSave()));
+}
+
+auto GameServer::getConfigSaveStatusString() const -> std::string {
+	return fmt::format(
+		"Saves: {} ({} failed){}\n"
+		"Last save: {} bytes, {} us on the main thread, {} us writing.\n"
+		"Slowest: {} us on the main thread, {} us writing.",
+		m_configSaveStats.saves,
+		m_configSaveStats.failures,
+		(m_pendingConfigSave.valid()) ? ", one in progress." : ".",
+		m_configSaveStats.lastSize,
+		m_configSaveStats.lastSnapshotTime.count(),
+		m_configSaveStats.lastWriteTime.count(),
+		m_configSaveStats.maxSnapshotTime.count(),
+		m_configSaveStats.maxWriteTime.count());
+}
+
 auto GameServer::updateConfigAutoSave(float deltaTime) -> void {
+	if (m_pendingConfigSave.valid() && m_pendingConfigSave.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+		this->waitForConfigSave();
+	}
+
 	if (m_configAutoSaveTimer.advance(deltaTime, m_configAutoSaveInterval, sv_config_auto_save_interval != 0)) {
-		INFO_MSG(Msg::SERVER, "Auto-saving game server config.");
-		m_game.consoleCommand(GET_COMMAND(sv_writeconfig));
+		if (m_pendingConfigSave.valid()) {
+			INFO_MSG(Msg::SERVER, "Skipping game server config auto-save because the previous one is still being written.");
+		} else {
+			INFO_MSG(Msg::SERVER, "Auto-saving game server config.");
+			m_pendingConfigSave = std::async(std::launch::async, [save = this->makeConfigSave()]() mutable { return GameServer::runConfigSave(std::move(save)); });
+		}
+	}
+}
+
+auto GameServer::makeConfigSave() -> ConfigSave {
+	const auto startTime = std::chrono::steady_clock::now();
+
+	auto save = ConfigSave{};
+	save.filepath = fmt::format("{}/{}/{}", data_dir, data_subdir_cfg, sv_config_file);
+	save.header = GameServer::getConfigHeader();
+	save.inventoryFile = std::string{sv_inventory_file};
+	save.rconConfig = this->getRconConfig();
+	save.bannedPlayers.reserve(m_bannedPlayers.size());
+	for (const auto& [ip, bannedPlayer] : m_bannedPlayers) {
+		save.bannedPlayers.emplace_back(ip, bannedPlayer.username);
+	}
+	save.inventories = this->makeInventorySave();
+
+	m_configSaveStats.lastSnapshotTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+	m_configSaveStats.maxSnapshotTime = std::max(m_configSaveStats.maxSnapshotTime, m_configSaveStats.lastSnapshotTime);
+	return save;
+}
+
+auto GameServer::runConfigSave(ConfigSave save) noexcept -> FinishedConfigSave {
+	const auto startTime = std::chrono::steady_clock::now();
+
+	auto finished = FinishedConfigSave{};
+	auto& result = finished.result;
+	try {
+		if (!save.inventories.write()) {
+			result.error = fmt::format("Failed to save inventory database \"{}\"!", save.inventoryFile);
+		}
+
+		static constexpr auto getBannedPlayerCommand = [](const auto& bannedPlayer) {
+			return fmt::format("{} {} {}",
+			                   GET_COMMAND(sv_ban).getName(),
+			                   Script::escapedString(std::string{bannedPlayer.first}),
+			                   Script::escapedString(bannedPlayer.second));
+		};
+
+		auto bannedPlayers = save.bannedPlayers;
+		std::sort(bannedPlayers.begin(), bannedPlayers.end(), [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+
+		const auto config = fmt::format(
+			"{}\n"
+			"\n"
+			"// Inventories:\n"
+			"{}\n"
+			"// Remote console:\n"
+			"{}\n"
+			"\n"
+			"// Banned IPs:\n"
+			"{}\n",
+			save.header,
+			(save.inventories.database) ? fmt::format("// Stored in {}.\n", Script::escapedString(save.inventoryFile)) : save.inventories.getConfig(),
+			save.rconConfig,
+			bannedPlayers | util::transform(getBannedPlayerCommand) | util::join('\n'));
+		if (util::replaceFile(save.filepath, config)) {
+			result.size = config.size();
+		} else if (result.error.empty()) {
+			result.error = fmt::format("Failed to save config file \"{}\"!", save.filepath);
+		}
+	} catch (const std::exception& e) {
+		result.error = fmt::format("Failed to save config: {}", e.what());
+	}
+
+	result.writeTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+	finished.inventories = std::move(save.inventories);
+	return finished;
+}
+
+auto GameServer::finishConfigSave(FinishedConfigSave&& save) -> ConfigSaveResult {
+	this->finishInventorySave(std::move(save.inventories));
+
+	const auto& result = save.result;
+	++m_configSaveStats.saves;
+	m_configSaveStats.lastWriteTime = result.writeTime;
+	m_configSaveStats.maxWriteTime = std::max(m_configSaveStats.maxWriteTime, result.writeTime);
+	if (!result.error.empty()) {
+		// Failures are reported by whoever started the save: sv_writeconfig returns the error, auto-saves warn in waitForConfigSave.
+		++m_configSaveStats.failures;
+		return std::move(save.result);
+	}
+	m_configSaveStats.lastSize = result.size;
+	INFO_MSG(Msg::SERVER, "Game server: Saved {} bytes of config in {} us.", result.size, result.writeTime.count());
+	return std::move(save.result);
+}
+
+auto GameServer::waitForConfigSave() -> void {
+	if (m_pendingConfigSave.valid()) {
+		if (const auto result = this->finishConfigSave(m_pendingConfigSave.get()); !result.error.empty()) {
+			m_game.warning(fmt::format("Auto-save failed: {}", result.error));
+		}
 	}
 }
 
@@ -1414,6 +1728,10 @@ auto GameServer::receivePackets() -> void {
 			break;
 		}
 
+		auto& sample = m_perf.current();
+		++sample.packetsReceived;
+		sample.bytesReceived += static_cast<std::uint32_t>(receivedBytes);
+
 		if (const auto it = m_clients.find<CLIENT_ENDPOINT>(remoteEndpoint); it != m_clients.end()) {
 			buffer.resize(receivedBytes);
 			(*it)->connection.receivePacket(std::move(buffer));
@@ -1510,13 +1828,25 @@ auto GameServer::updateTicks(float deltaTime) -> void {
 			ticks = sv_max_ticks_per_frame;
 		}
 
+		auto& sample = m_perf.current();
+		sample.ticks += static_cast<std::uint32_t>(ticks);
+		sample.tickLateness = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<float>{m_tickTimer.getElapsedTime()});
 		while (ticks-- > 0) {
 			this->tick();
 		}
 
-		this->updateClients(timeSinceLastTick);
-		this->writeWorldStateToClients();
-		this->sendPackets();
+		{
+			const auto timer = m_perf.measure(ServerPerfPhase::CLIENTS);
+			this->updateClients(timeSinceLastTick);
+		}
+		{
+			const auto timer = m_perf.measure(ServerPerfPhase::SNAPSHOTS);
+			this->writeWorldStateToClients();
+		}
+		{
+			const auto timer = m_perf.measure(ServerPerfPhase::SEND);
+			this->sendPackets();
+		}
 	}
 }
 
@@ -1530,13 +1860,51 @@ auto GameServer::updateClients(float deltaTime) -> void {
 }
 
 auto GameServer::sendPackets() -> void {
+	auto& sample = m_perf.current();
 	for (auto& client : m_clients) {
+		const auto& stats = client->connection.getStats();
+		const auto packetsSent = stats.packetsSent;
+		const auto bytesSent = stats.bytesSent;
 		client->connection.sendPackets();
+		sample.packetsSent += stats.packetsSent - packetsSent;
+		sample.bytesSent += stats.bytesSent - bytesSent;
+	}
+}
+
+auto GameServer::updatePerf(float deltaTime) -> void {
+	if (auto& sample = m_perf.current(); sample.ticks > 0) {
+		sample.tickCount = m_world.getTickCount();
+		sample.players = static_cast<std::uint32_t>(m_world.getPlayerCount());
+		sample.entities = static_cast<std::uint32_t>(m_world.getProjectileCount() + m_world.getExplosionCount() + m_world.getSentryGunCount() +
+		                                             m_world.getMedkitCount() + m_world.getAmmopackCount() + m_world.getGenericEntityCount() +
+		                                             m_world.getFlagCount() + m_world.getPayloadCartCount());
+		m_perf.commit();
+	}
+
+	if (m_perfLogTimer.advance(deltaTime, sv_perf_log_interval, sv_perf_log_interval > 0.0f)) {
+		INFO_MSG(Msg::SERVER, "Game server: Perf: {}", m_perf.getLogLine());
+	}
+}
+
+auto GameServer::getPerf() const noexcept -> const ServerPerf& {
+	return m_perf;
+}
+
+auto GameServer::getTimeUntilNextTick() const noexcept -> float {
+	return std::max(m_tickInterval - m_tickTimer.getElapsedTime(), 0.0f);
+}
+
+auto GameServer::waitForPackets(net::Duration timeout) -> void {
+	auto ec = std::error_code{};
+	static_cast<void>(m_socket.waitUntilReadable(timeout, ec));
+	if (ec) {
+		DEBUG_MSG(Msg::SERVER, "Game server: Failed to wait for packets: {}", ec.message());
 	}
 }
 
 auto GameServer::updateProcess() -> void {
-	m_vm.output(m_process->run(m_game, this, nullptr, nullptr, nullptr));
+	// Bounded like the background processes, so that a runaway server script can't take up the whole frame.
+	m_vm.output(m_process->runFor(std::chrono::microseconds{process_budget}, m_game, this, nullptr, nullptr, nullptr));
 }
 
 auto GameServer::pollModifiedCvars() -> std::vector<ConVarUpdate> { // NOLINT(readability-convert-member-functions-to-static)
@@ -1593,26 +1961,33 @@ auto GameServer::updateClientResourceUpload(Clients::iterator it, float deltaTim
 	assert(it != m_clients.end());
 	auto& client = **it;
 
-	const auto chunkSize = static_cast<std::size_t>(sv_resource_upload_chunk_size);
-	for (auto parts = client.resourceUploadTimer.advance(deltaTime, m_resourceUploadInterval, client.resourceUpload != nullptr); parts > 0; --parts) {
-		const auto& [nameHash, resource] = *client.resourceUpload;
-		const auto remainingSize = resource.data.size() - client.resourceUploadProgress;
-		if (remainingSize <= chunkSize) {
-			if (!client.write(msg::cl::out::ResourceDownloadLast{{}, nameHash, resource.data.substr(client.resourceUploadProgress)})) {
-				this->disconnectClient(m_currentClient, "Failed to write last resource part.");
-			}
-			client.resourceUpload = nullptr;
-			client.resourceUploadProgress = 0;
-			client.resourceUploadTimer.reset();
+	for (auto parts = client.resourceUploadTimer.advance(deltaTime, m_resourceUploadInterval, client.resourceUpload != nullptr);
+	     parts > 0 && client.resourceUpload;
+	     --parts) {
+		if (!this->writeResourceUploadPart(client)) {
+			this->disconnectClient(it, "Failed to write resource part.");
 			break;
 		}
-		if (!client.write(msg::cl::out::ResourceDownloadPart{{}, nameHash, resource.data.substr(client.resourceUploadProgress, chunkSize)})) {
-			this->disconnectClient(m_currentClient, "Failed to write resource part.");
-		}
-		client.resourceUploadProgress += chunkSize;
 	}
 }
 
+auto GameServer::writeResourceUploadPart(ClientInfo& client) -> bool {
+	assert(client.resourceUpload);
+	const auto& [nameHash, resource] = *client.resourceUpload;
+
+	// Every downloader gets a view into the same resource data. The only copy made per client is into its outgoing packets.
+	const auto offset = client.resourceUploadProgress;
+	const auto part = std::string_view{resource.data}.substr(offset, static_cast<std::size_t>(sv_resource_upload_chunk_size));
+	if (offset + part.size() >= resource.data.size()) {
+		client.resourceUpload = nullptr;
+		client.resourceUploadProgress = 0;
+		client.resourceUploadTimer.reset();
+		return client.write(msg::cl::out::ResourceDownloadLast{{}, nameHash, offset, part});
+	}
+	client.resourceUploadProgress += part.size();
+	return client.write(msg::cl::out::ResourceDownloadPart{{}, nameHash, offset, part});
+}
+
 auto GameServer::updateClientPing(Clients::iterator it) -> void {
 	assert(it != m_clients.end());
 	auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] = *it;
@@ -1624,22 +1999,54 @@ auto GameServer::updateClientPing(Clients::iterator it) -> void {
 	}
 }
 
-auto GameServer::addResource(std::string name, std::string data) -> void { // NOLINT(performance-unnecessary-value-param)
+auto GameServer::addResource(ResourceInfoList& resourceInfo, std::string name, std::string data) -> bool { // NOLINT(performance-unnecessary-value-param)
 	const auto extension = std::filesystem::path{name}.extension();
 	const auto size = data.size();
 	const auto isText = extension == ".txt" || extension == ".cfg";
 	const auto nameHash = util::CRC32{util::asBytes(util::Span{name})};
 	const auto fileHash = util::CRC32{util::asBytes(util::Span{data})};
 	if (m_resources.try_emplace(nameHash, name, std::move(data), sv_allow_resource_download).second) {
-		m_resourceInfo.emplace_back(std::move(name), nameHash, fileHash, size, isText, sv_allow_resource_download);
-	} else {
-		m_game.warning(fmt::format("Failed to add resource \"{}\"!", name));
+		resourceInfo.emplace_back(std::move(name), nameHash, fileHash, size, isText, sv_allow_resource_download);
+		return true;
+	}
+	return false;
+}
+
+auto GameServer::loadPrefetchResources() -> void {
+	m_prefetchResourceInfo.clear();
+	if (!sv_resource_prefetch || !sv_allow_resource_download || sv_nextlevel.empty() || sv_nextlevel == m_game.map().getName()) {
+		return;
+	}
+
+	auto buf = util::readFile(fmt::format("{}/{}/{}", data_dir, data_subdir_maps, sv_nextlevel));
+	if (!buf) {
+		buf = util::readFile(fmt::format("{}/{}/{}/{}", data_dir, data_subdir_downloads, data_subdir_maps, sv_nextlevel));
+		if (!buf) {
+			INFO_MSG(Msg::SERVER, "Game server: Not prefetching next map \"{}\" (couldn't read file).", sv_nextlevel);
+			return;
+		}
+	}
+
+	auto nextMap = Map{};
+	if (!nextMap.load(std::string{sv_nextlevel}, *buf)) {
+		INFO_MSG(Msg::SERVER, "Game server: Not prefetching next map \"{}\" (invalid format).", sv_nextlevel);
+		return;
+	}
+
+	INFO_MSG(Msg::SERVER, "Game server: Prefetching next map \"{}\".", sv_nextlevel);
+	// Resources that are shared with the current map are already available under the same name, so failing to add them is fine.
+	this->addResource(m_prefetchResourceInfo, fmt::format("{}/{}", data_subdir_maps, sv_nextlevel), std::move(*buf));
+	for (const auto& resourceName : nextMap.getResources()) {
+		if (auto resourceBuf = util::readFile(fmt::format("{}/{}", data_dir, resourceName))) {
+			this->addResource(m_prefetchResourceInfo, resourceName, std::move(*resourceBuf));
+		}
 	}
 }
 
 auto GameServer::loadMap() -> bool {
 	m_world.reset();
 	m_bots.clear();
+	m_botPathRequests.clear();
 
 	for (auto& client : m_clients) {
 		client->resourceUpload = nullptr;
@@ -1648,6 +2055,7 @@ auto GameServer::loadMap() -> bool {
 	}
 	m_resources.clear();
 	m_resourceInfo.clear();
+	m_prefetchResourceInfo.clear();
 
 	INFO_MSG(Msg::SERVER, "Game server: Loading map \"{}\"...", sv_map);
 	auto buf = util::readFile(fmt::format("{}/{}/{}", data_dir, data_subdir_maps, sv_map));
@@ -1663,13 +2071,17 @@ auto GameServer::loadMap() -> bool {
 		m_game.warning(fmt::format("Failed to load map \"{}\" (invalid format).", sv_map));
 		return false;
 	}
-	this->addResource(fmt::format("{}/{}", data_subdir_maps, sv_map), std::move(*buf));
+	if (!this->addResource(m_resourceInfo, fmt::format("{}/{}", data_subdir_maps, sv_map), std::move(*buf))) {
+		m_game.warning(fmt::format("Failed to add resource \"{}/{}\"!", data_subdir_maps, sv_map));
+	}
 
 	for (const auto& resourceName : m_game.map().getResources()) {
 		const auto resourceFilepath = fmt::format("{}/{}", data_dir, resourceName);
 		INFO_MSG(Msg::SERVER, "Game server: Loading resource \"{}\".", resourceFilepath);
 		if (auto buf = util::readFile(resourceFilepath)) {
-			this->addResource(resourceName, std::move(*buf));
+			if (!this->addResource(m_resourceInfo, resourceName, std::move(*buf))) {
+				m_game.warning(fmt::format("Failed to add resource \"{}\"!", resourceName));
+			}
 		} else {
 			m_game.warning(fmt::format("Failed to load resource \"{}\" (couldn't read file).", resourceName));
 			return false;
@@ -1736,6 +2148,8 @@ auto GameServer::loadMap() -> bool {
 		}
 	}
 
+	this->loadPrefetchResources();
+
 	// Add bots.
 	for (auto i = 0; i < sv_bot_count; ++i) {
 		if (!this->addBot()) {
@@ -1872,6 +2286,17 @@ auto GameServer::writeServerInfo(ClientInfo& client) -> bool {
 	return false;
 }
 
+auto GameServer::writeHeartbeat(ClientInfo& client) -> bool {
+	return client.connection.write<MetaServerOutputMessages>(msg::meta::sv::out::Heartbeat{{},
+	                                                                                      m_tickrate,
+	                                                                                      static_cast<std::uint32_t>(m_world.getPlayerCount()),
+	                                                                                      static_cast<std::uint32_t>(m_bots.size()),
+	                                                                                      static_cast<std::uint32_t>(sv_playerlimit),
+	                                                                                      m_game.map().getName(),
+	                                                                                      sv_hostname,
+	                                                                                      game_version});
+}
+
 auto GameServer::writeCommandOutput(ClientInfo& client, std::string_view message) -> void { // NOLINT(readability-convert-member-functions-to-static)
 	if (!client.write(msg::cl::out::CommandOutput{{}, false, message})) {
 		INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT,
@@ -1890,14 +2315,28 @@ auto GameServer::writeCommandError(ClientInfo& client, std::string_view message)
 
 auto GameServer::writeWorldStateToClients() -> void {
 	DEBUG_MSG_INDENT(Msg::CONNECTION_DETAILED, "Game server: Writing world state to clients...") {
+		const auto tick = m_world.getTickCount();
+
+		// Start over with the views of this tick. They are taken when the first client that needs each of them is updated.
+		auto& pooled = m_snapshotPool[tick % m_snapshotPool.size()];
+		pooled.tickCount = tick;
+		pooled.viewCount = 0;
+
 		auto deltaData = std::vector<std::byte>{};
 		for (auto& [client, endpoint, address, username, playerId, inventoryId, rconToken] : m_clients) {
 			if (playerId != PLAYER_ID_UNCONNECTED && client.updateTimer.advance(m_tickInterval, client.updateInterval)) {
-				const auto tick = m_world.getTickCount();
-				const auto& snapshot = ((*client.snapshots)[tick % client.snapshots->size()] = m_world.takeSnapshot(playerId));
-				if (client.latestSnapshotReceived == 0 || client.latestSnapshotReceived + client.snapshots->size() <= tick) {
+				auto& sent = client.snapshots[tick % client.snapshots.size()];
+				sent.tickCount = tick;
+				sent.selfPlayer = m_world.takeSelfPlayer(playerId);
+				GameServer::makeClientSnapshot(this->takeSnapshotView(sent.getTeam()), playerId, sent.selfPlayer, m_snapshot);
+
+				const auto sourceTick = client.latestSnapshotReceived;
+				const auto& source = client.snapshots[sourceTick % client.snapshots.size()];
+				const auto hasSource = sourceTick != 0 && sourceTick + client.snapshots.size() > tick && source.tickCount == sourceTick;
+				const auto* const sourceView = (hasSource) ? this->findSnapshotView(sourceTick, source.getTeam()) : nullptr;
+				if (!sourceView) {
 					DEBUG_MSG_INDENT(Msg::CONNECTION_DETAILED, "Game server: Player \"{}\": Writing full snapshot #{}.", username, tick) {
-						if (!client.write(msg::cl::out::Snapshot{{}, snapshot})) {
+						if (!client.write(msg::cl::out::Snapshot{{}, m_snapshot})) {
 							INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write snapshot to \"{}\".", std::string{endpoint});
 						}
 					}
@@ -1905,13 +2344,12 @@ auto GameServer::writeWorldStateToClients() -> void {
 					DEBUG_MSG_INDENT(Msg::CONNECTION_DETAILED,
 					                 "Game server: Player \"{}\": Writing snapshot delta from #{} to #{}.",
 					                 username,
-					                 client.latestSnapshotReceived,
+					                 sourceTick,
 					                 tick) {
-						const auto sourceTick = client.latestSnapshotReceived;
-						const auto& sourceSnapshot = (*client.snapshots)[sourceTick % client.snapshots->size()];
+						GameServer::makeClientSnapshot(*sourceView, playerId, source.selfPlayer, m_baselineSnapshot);
 
 						auto deltaDataStream = net::ByteOutputStream{deltaData};
-						deltaCompress(deltaDataStream, sourceSnapshot, snapshot);
+						deltaCompress(deltaDataStream, m_baselineSnapshot, m_snapshot);
 
 						if (!client.write(msg::cl::out::SnapshotDelta{{}, sourceTick, deltaData})) {
 							INFO_MSG(Msg::SERVER | Msg::CONNECTION_EVENT, "Game server: Failed to write snapshot delta to \"{}\".", std::string{endpoint});
@@ -1925,6 +2363,42 @@ auto GameServer::writeWorldStateToClients() -> void {
 	}
 }
 
+auto GameServer::findSnapshotView(TickCount tick, std::optional<Team> team) const -> const SnapshotView* {
+	const auto& pooled = m_snapshotPool[tick % m_snapshotPool.size()];
+	if (pooled.tickCount != tick) {
+		return nullptr;
+	}
+	const auto end = pooled.views.begin() + static_cast<std::ptrdiff_t>(pooled.viewCount);
+	const auto it = std::find_if(pooled.views.begin(), end, [&](const SnapshotView& view) { return view.team == team; });
+	return (it == end) ? nullptr : &*it;
+}
+
+auto GameServer::takeSnapshotView(std::optional<Team> team) -> const SnapshotView& {
+	const auto tick = m_world.getTickCount();
+	if (const auto* const view = this->findSnapshotView(tick, team)) {
+		return *view;
+	}
+
+	auto& pooled = m_snapshotPool[tick % m_snapshotPool.size()];
+	if (pooled.viewCount == pooled.views.size()) {
+		pooled.views.emplace_back();
+	}
+	auto& view = pooled.views[pooled.viewCount++];
+	view.team = team;
+	m_world.takeSnapshot(team, view.snapshot, view.playerIds);
+	return view;
+}
+
+auto GameServer::makeClientSnapshot(const SnapshotView& view, PlayerId playerId, const std::optional<ent::sh::SelfPlayer>& selfPlayer, Snapshot& snap) -> void {
+	snap = view.snapshot;
+	snap.selfPlayer = selfPlayer.value_or(ent::sh::SelfPlayer{});
+
+	// Clients don't see their own player in the players list.
+	if (const auto it = std::find(view.playerIds.begin(), view.playerIds.end(), playerId); it != view.playerIds.end()) {
+		snap.players.erase(snap.players.begin() + (it - view.playerIds.begin()));
+	}
+}
+
 auto GameServer::findValidUsername(std::string_view original) const -> std::string {
 	auto name = std::string{original.substr(0, static_cast<std::size_t>(sv_max_username_length))};
 	if (util::iequals(name, USERNAME_META_SERVER) || util::iequals(name, USERNAME_UNCONNECTED)) {
@@ -1998,6 +2472,80 @@ auto GameServer::findClientByIp(net::IpEndpoint endpoint) const -> Clients::cons
 	return m_clients.end();
 }
 
+auto GameServer::makeHookStates() -> HookStates {
+	auto hooks = HookStates{};
+	for (auto i = std::size_t{0}; i < hooks.size(); ++i) {
+		hooks[i].symbol = SymbolRef{Symbol::get(SCRIPT_HOOK_NAMES[i])};
+	}
+	return hooks;
+}
+
+auto GameServer::resolveHook(ScriptHook hook) -> HookState& {
+	assert(m_env);
+	auto& state = m_hooks[static_cast<std::size_t>(hook)];
+	if (state.version != state.symbol->version) {
+		// Something with the name of the hook has been defined or removed since we last looked, so look it up again.
+		state.version = state.symbol->version;
+		state.object = nullptr;
+		state.defined = m_process->defined(m_env, state.symbol->name);
+		if (state.defined) {
+			auto aliased = false;
+			for (const auto* pEnv = m_env.get(); pEnv && !aliased; pEnv = pEnv->parent.get()) {
+				aliased = pEnv->aliases.count(*state.symbol) != 0;
+			}
+			if (!aliased) {
+				state.object = m_process->findObject(m_env, state.symbol->name);
+			}
+		}
+	}
+	return state;
+}
+
+auto GameServer::dispatchHook(HookState& state, cmd::CommandArguments arguments) -> void {
+	assert(m_env);
+	assert(state.defined);
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto* const function = (state.object) ? std::get_if<Environment::Function>(state.object) : nullptr;
+	if (function &&
+	    (arguments.size() == function->parameters.size() ||
+	     (!function->parameters.empty() && arguments.size() + 1 >= function->parameters.size() && function->parameters.back() == "..."))) {
+		// Pass the arguments straight to the function so that numbers don't have to be formatted as text.
+		if (const auto frame = m_process->call(m_env, *function, std::move(arguments))) {
+			m_vm.output(frame->run(m_game, this, nullptr, nullptr, nullptr));
+		} else {
+			m_vm.outputError("Stack overflow.");
+		}
+	} else {
+		auto command = Script::Command{};
+		command.reserve(arguments.size() + 1);
+		command.emplace_back(std::string{state.symbol->name}, Script::Argument::NO_FLAGS);
+		for (auto& argument : arguments) {
+			command.emplace_back(std::move(argument.text()), Script::Argument::NO_FLAGS);
+		}
+		// The hook is already known to be defined, so call it directly instead of looking it up again.
+		if (const auto frame = m_process->call(m_env, std::move(command))) {
+			m_vm.output(frame->run(m_game, this, nullptr, nullptr, nullptr));
+		} else {
+			m_vm.outputError("Stack overflow.");
+		}
+	}
+	++state.calls;
+	state.time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+}
+
+auto GameServer::getHookStatusString() const -> std::string {
+	auto result = std::string{};
+	for (auto i = std::size_t{0}; i < m_hooks.size(); ++i) {
+		if (const auto& state = m_hooks[i]; state.calls != 0) {
+			result.append(fmt::format("\n  {}: {} calls in {} ms",
+			                          SCRIPT_HOOK_NAMES[i],
+			                          state.calls,
+			                          std::chrono::duration_cast<std::chrono::milliseconds>(state.time).count()));
+		}
+	}
+	return result;
+}
+
 auto GameServer::countClientsWithIp(net::IpAddress ip) const noexcept -> std::size_t {
 	return util::countIf(m_clients, [ip](const auto& elem) { return elem.template get<CLIENT_ADDRESS>() == ip; });
 }
@@ -4,6 +4,7 @@
 #include "../../console/command.hpp"          // cmd::...
 #include "../../console/environment.hpp"      // Environment
 #include "../../console/script.hpp"           // Script
+#include "../../console/symbol.hpp"           // Symbol, SymbolRef
 #include "../../network/config.hpp"           // net::Duration, net::MAX_...
 #include "../../network/connection.hpp"       // net::Connection, net::msg::in::Connect, net::sanitizeMessage
 #include "../../network/crypto.hpp"           // crypto::...
@@ -14,6 +15,7 @@
 #include "../../utilities/multi_hash.hpp"     // util::MultiHash
 #include "../../utilities/reference.hpp"      // util::Reference
 #include "../../utilities/span.hpp"           // util::Span, util::asBytes
+#include "../../utilities/thread_pool.hpp"    // util::ThreadPool
 #include "../data/hat.hpp"                    // Hat
 #include "../data/health.hpp"                 // Health
 #include "../data/inventory.hpp"              // InventoryId, InventoryToken, INVENTORY_ID_INVALID
@@ -24,6 +26,7 @@
 #include "../data/tick_count.hpp"             // TickCount
 #include "../data/tickrate.hpp"               // Tickrate
 #include "../shared/convar_update.hpp"        // ConVarUpdate
+#include "../shared/entities.hpp"             // ent::sh::SelfPlayer
 #include "../shared/game_client_messages.hpp" // GameClientOutputMessages, msg::cl::out::...
 #include "../shared/game_server_messages.hpp" // GameServerInputMessages, msg::sv::in::...
 #include "../shared/resource_info.hpp"        // ResourceInfo
@@ -31,19 +34,24 @@
 #include "bot.hpp"                            // Bot
 #include "inventory_server.hpp"               // InventoryServer
 #include "remote_console_server.hpp"          // RemoteConsoleServer
+#include "script_hook.hpp"                    // ScriptHook, SCRIPT_HOOK_COUNT
+#include "server_perf.hpp"                    // ServerPerf, ServerPerfPhase
 #include "world.hpp"                          // World
 
 #include <array>         // std::array
+#include <chrono>        // std::chrono::...
 #include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint64_t
 #include <deque>         // std::deque
-#include <memory>        // std::shared_ptr, std::unique_ptr, std::make_unique
+#include <future>        // std::future
+#include <memory>        // std::shared_ptr
 #include <optional>      // std::optional, std::nullopt
 #include <random>        // std::discrete_distribution
 #include <string>        // std::string
 #include <string_view>   // std::string_view
 #include <unordered_map> // std::unordered_map
 #include <unordered_set> // std::unordered_set
-#include <utility>       // std::move, std::forward
+#include <utility>       // std::move, std::forward, std::pair
 #include <vector>        // std::vector
 
 class Game;
@@ -62,6 +70,12 @@ public:
 	};
 	using BannedPlayers = std::unordered_map<net::IpAddress, BannedPlayer>;
 
+	struct ConfigSaveResult final {
+		std::string error{};                   // Empty if the save succeeded.
+		std::size_t size = 0;                  // Size of the written config file in bytes.
+		std::chrono::microseconds writeTime{}; // Time spent formatting and writing the files.
+	};
+
 	static constexpr auto USERNAME_UNCONNECTED = std::string_view{"unconnected"};
 	static constexpr auto USERNAME_META_SERVER = std::string_view{"metaserver"};
 
@@ -92,6 +106,7 @@ public:
 	auto updateSpamLimit() -> void;
 	auto updateTickrate() -> void;
 	auto updateBotTickrate() -> void;
+	auto updateBotThreads() -> void;
 	auto updateConfigAutoSaveInterval() -> void;
 	auto updateResourceUploadInterval() -> void;
 	auto updateAllowResourceDownload() -> void;
@@ -114,6 +129,25 @@ public:
 
 	auto freezeBots() -> void;
 
+	// Run a number of real ticks twice from the same world, bot and random state, first with bots thinking on this thread and then on a pool
+	// of at least two worker threads, and compare the world after every tick. Returns the first tick where the two runs differed, if any.
+	// The world is left as the second run left it.
+	[[nodiscard]] auto testBotDeterminism(int tickCount) -> std::optional<TickCount>;
+
+	[[nodiscard]] auto getBotAiStatusString() const -> std::string;
+
+	// Save the server config and inventories, and wait for the files to be written.
+	[[nodiscard]] auto writeConfig() -> ConfigSaveResult;
+	[[nodiscard]] auto getConfigSaveStatusString() const -> std::string;
+
+	[[nodiscard]] auto getPerf() const noexcept -> const ServerPerf&;
+
+	// Time in seconds until the next tick is due, in server time.
+	[[nodiscard]] auto getTimeUntilNextTick() const noexcept -> float;
+
+	// Sleep until a packet arrives or the timeout expires.
+	auto waitForPackets(net::Duration timeout) -> void;
+
 	[[nodiscard]] auto getBannedPlayers() const -> const BannedPlayers&;
 	[[nodiscard]] auto getConnectedClientIps() const -> std::vector<net::IpEndpoint>;
 	[[nodiscard]] auto getBotNames() const -> std::vector<std::string>;
@@ -165,6 +199,18 @@ public:
 	auto callIfDefined(Script::Command command) -> void;
 	auto callScript(Script script) -> void;
 
+	// Call a script hook with the given arguments if the server scripts have defined it.
+	// If nothing with the name of the hook is defined anywhere, this only costs a single branch, and the arguments are only built once the hook
+	// has been found in the server environment.
+	template <typename... Args>
+	auto callHook(ScriptHook hook, Args&&... args) -> void {
+		if (m_hooks[static_cast<std::size_t>(hook)].symbol->definitions != 0) {
+			if (auto& state = this->resolveHook(hook); state.defined) {
+				this->dispatchHook(state, cmd::CommandArguments{cmd::done(std::forward<Args>(args))...});
+			}
+		}
+	}
+
 private:
 	struct MessageHandler final {
 		util::Reference<GameServer> server;
@@ -193,8 +239,86 @@ private:
 	using Resources = std::unordered_map<util::CRC32, Resource>;
 	using ResourceInfoList = std::vector<ResourceInfo>;
 
+	struct BotPathRequest final {
+		PlayerId botId;
+		Bot::PathRequest request;
+	};
+
+	// Everything that goes into the server config, copied on the main thread so that the rest of the save can be done on another thread.
+	struct ConfigSave final {
+		std::string filepath{};
+		std::string header{};
+		std::string inventoryFile{};
+		std::string rconConfig{};
+		std::vector<std::pair<net::IpAddress, std::string>> bannedPlayers{};
+		InventorySave inventories{};
+	};
+
+	// What a written save hands back to the main thread.
+	struct FinishedConfigSave final {
+		ConfigSaveResult result{};
+		InventorySave inventories{}; // Database state after the write, taken over by the server in finishConfigSave.
+	};
+
+	struct ConfigSaveStats final {
+		std::size_t saves = 0;
+		std::size_t failures = 0;
+		std::size_t lastSize = 0;
+		std::chrono::microseconds lastSnapshotTime{}; // Time spent on the main thread copying the data to save.
+		std::chrono::microseconds lastWriteTime{};
+		std::chrono::microseconds maxSnapshotTime{};
+		std::chrono::microseconds maxWriteTime{};
+	};
+
+	struct BotAiStats final {
+		std::chrono::microseconds thinkTime{};
+		std::chrono::microseconds pathTime{};
+		std::size_t thinks = 0;
+		std::size_t deferredThinks = 0;
+		std::size_t pathsSolved = 0;
+		Bot::PlanStats plans{};
+	};
+
+	struct HookState final {
+		SymbolRef symbol{};                          // Symbol of the name of the hook.
+		std::uint64_t version = 0;                   // Version of the symbol when the hook was last looked up.
+		const Environment::Object* object = nullptr; // Object that the hook refers to, if it is not an alias.
+		bool defined = false;                        // Whether the hook refers to anything at all.
+		std::size_t calls = 0;                       // Number of times the hook has been called.
+		std::chrono::microseconds time{};            // Total time spent in the hook.
+	};
+	using HookStates = std::array<HookState, SCRIPT_HOOK_COUNT>;
+
+	static constexpr auto SNAPSHOT_HISTORY_SIZE = std::size_t{32};
+
+	// The part of the snapshots taken on one tick that is the same for every client whose player is on the same team.
+	struct SnapshotView final {
+		std::optional<Team> team{};        // Team the view was taken for, or nothing for clients that don't have a player.
+		Snapshot snapshot{};               // Snapshot without the self player, with every visible player in the players list.
+		std::vector<PlayerId> playerIds{}; // Ids of the players in the players list of the snapshot, in the same order.
+	};
+
+	// The views taken on one tick, shared between all clients.
+	struct SnapshotPoolEntry final {
+		TickCount tickCount = 0;
+		std::vector<SnapshotView> views{};
+		std::size_t viewCount = 0; // Number of views in use. The rest are only kept to reuse their memory.
+	};
+	using SnapshotPool = std::array<SnapshotPoolEntry, SNAPSHOT_HISTORY_SIZE>;
+
+	// Snapshot that was sent to a client, kept as a baseline for future deltas.
+	// Only the part that is specific to the client is stored here. The rest is in the view of the same tick in the snapshot pool.
+	struct SentSnapshot final {
+		TickCount tickCount = 0; // 0 if the slot is unused.
+		std::optional<ent::sh::SelfPlayer> selfPlayer{};
+
+		[[nodiscard]] auto getTeam() const -> std::optional<Team> {
+			return (selfPlayer) ? std::optional<Team>{selfPlayer->team} : std::nullopt;
+		}
+	};
+
 	struct ClientInfo final {
-		using SnapshotBuffer = std::unique_ptr<std::array<Snapshot, 32>>;
+		using SnapshotBuffer = std::array<SentSnapshot, SNAPSHOT_HISTORY_SIZE>;
 		using RconToken = std::optional<std::string_view>;
 
 		Connection connection;
@@ -207,7 +331,7 @@ private:
 		int spamCounter = 0;
 		util::Countup<float> afkTimer{};
 		Actions latestActions = Action::NONE;
-		SnapshotBuffer snapshots = std::make_unique<std::array<Snapshot, 32>>();
+		SnapshotBuffer snapshots{};
 		Resources::const_pointer resourceUpload = nullptr;
 		std::size_t resourceUploadProgress = 0;
 		util::CountupLoop<float> resourceUploadTimer{};
@@ -219,6 +343,10 @@ private:
 		[[nodiscard]] auto write(const Message& msg) -> bool {
 			return connection.write<GameClientOutputMessages>(msg);
 		}
+
+		[[nodiscard]] auto write(const net::SharedMessage& msg) -> bool {
+			return connection.write(msg);
+		}
 	};
 
 	using Clients = util::MultiHash<ClientInfo,           // client
@@ -251,7 +379,9 @@ private:
 		client.spamCounter = 0;
 		client.afkTimer.reset();
 		client.latestActions = Action::NONE;
-		client.snapshots->fill(Snapshot{});
+		for (auto& snapshot : client.snapshots) {
+			snapshot.tickCount = 0;
+		}
 		client.resourceUpload = nullptr;
 		client.resourceUploadProgress = 0;
 		client.resourceUploadTimer.reset();
@@ -313,14 +443,21 @@ private:
 	auto write(std::string_view username, msg::cl::out::RemoteConsoleLoggedOut&& msg) -> void override;
 
 	auto tick() -> void;
+	auto updateBots() -> void;
+	auto thinkBots(const std::vector<Bot*>& bots) -> void;
 
 	auto updateConfigAutoSave(float deltaTime) -> void;
+	[[nodiscard]] auto makeConfigSave() -> ConfigSave;
+	[[nodiscard]] static auto runConfigSave(ConfigSave save) noexcept -> FinishedConfigSave;
+	[[nodiscard]] auto finishConfigSave(FinishedConfigSave&& save) -> ConfigSaveResult;
+	auto waitForConfigSave() -> void;
 	auto receivePackets() -> void;
 	auto updateConnections() -> void;
 	auto updateMetaServerConnection(float deltaTime) -> void;
 	auto updateTicks(float deltaTime) -> void;
 	auto updateClients(float deltaTime) -> void;
 	auto sendPackets() -> void;
+	auto updatePerf(float deltaTime) -> void;
 	auto updateProcess() -> void;
 
 	[[nodiscard]] auto pollModifiedCvars() -> std::vector<ConVarUpdate>;
@@ -330,9 +467,11 @@ private:
 	auto updateClientAfkTimer(Clients::iterator it, float deltaTime) -> void;
 	auto writeClientModifiedCvars(Clients::iterator it, const msg::cl::out::CvarMod& modifiedCvarsMessage) -> void;
 	auto updateClientResourceUpload(Clients::iterator it, float deltaTime) -> void;
+	[[nodiscard]] auto writeResourceUploadPart(ClientInfo& client) -> bool;
 	auto updateClientPing(Clients::iterator it) -> void;
 
-	auto addResource(std::string name, std::string data) -> void;
+	auto addResource(ResourceInfoList& resourceInfo, std::string name, std::string data) -> bool;
+	auto loadPrefetchResources() -> void;
 
 	[[nodiscard]] auto loadMap() -> bool;
 
@@ -342,12 +481,22 @@ private:
 
 	auto dropClient(Clients::iterator it) -> void;
 
+	// Serialize a message once, so that broadcasting it only costs a reference per client.
+	template <typename Message>
+	[[nodiscard]] static auto shareMessage(const Message& msg) -> net::SharedMessage {
+		return Connection::share<GameClientOutputMessages>(msg);
+	}
+
 	[[nodiscard]] auto writeServerInfo(ClientInfo& client) -> bool;
+	[[nodiscard]] auto writeHeartbeat(ClientInfo& client) -> bool;
 
 	auto writeCommandOutput(ClientInfo& client, std::string_view message) -> void;
 	auto writeCommandError(ClientInfo& client, std::string_view message) -> void;
 
 	auto writeWorldStateToClients() -> void;
+	[[nodiscard]] auto findSnapshotView(TickCount tick, std::optional<Team> team) const -> const SnapshotView*;
+	[[nodiscard]] auto takeSnapshotView(std::optional<Team> team) -> const SnapshotView&;
+	static auto makeClientSnapshot(const SnapshotView& view, PlayerId playerId, const std::optional<ent::sh::SelfPlayer>& selfPlayer, Snapshot& snap) -> void;
 
 	[[nodiscard]] auto findValidUsername(std::string_view original) const -> std::string;
 
@@ -356,6 +505,11 @@ private:
 	[[nodiscard]] auto findClientByIp(net::IpEndpoint endpoint) -> Clients::iterator;
 	[[nodiscard]] auto findClientByIp(net::IpEndpoint endpoint) const -> Clients::const_iterator;
 
+	[[nodiscard]] static auto makeHookStates() -> HookStates;
+	[[nodiscard]] auto resolveHook(ScriptHook hook) -> HookState&;
+	auto dispatchHook(HookState& state, cmd::CommandArguments arguments) -> void;
+	[[nodiscard]] auto getHookStatusString() const -> std::string;
+
 	[[nodiscard]] auto countClientsWithIp(net::IpAddress ip) const noexcept -> std::size_t;
 	[[nodiscard]] auto countPlayersWithIp(net::IpAddress ip) const noexcept -> std::size_t;
 
@@ -363,10 +517,15 @@ private:
 	VirtualMachine& m_vm;
 	std::shared_ptr<Environment> m_env;
 	std::shared_ptr<Process> m_process;
+	HookStates m_hooks = GameServer::makeHookStates();
 	World m_world;
+	SnapshotPool m_snapshotPool{};
+	Snapshot m_snapshot{};         // Reused for the snapshots to send.
+	Snapshot m_baselineSnapshot{}; // Reused for the baselines of the snapshot deltas to send.
 	net::UDPSocket m_socket{};
 	Resources m_resources{};
 	ResourceInfoList m_resourceInfo{};
+	ResourceInfoList m_prefetchResourceInfo{}; // Resources of the next map, which clients may download while playing the current one.
 	Tickrate m_tickrate = 0;
 	float m_spamInterval = 0.0f;
 	float m_tickInterval = 0.0f;
@@ -375,11 +534,19 @@ private:
 	float m_resourceUploadInterval = 0.0f;
 	util::CountupLoop<float> m_spamTimer{};
 	util::CountupLoop<float> m_tickTimer{};
-	util::CountupLoop<float> m_botTickTimer{};
 	util::CountupLoop<float> m_configAutoSaveTimer{};
+	std::future<FinishedConfigSave> m_pendingConfigSave{}; // Auto-save that is being written on another thread.
+	ConfigSaveStats m_configSaveStats{};
 	util::CountupLoop<float> m_metaServerRetryTimer{};
+	ServerPerf m_perf{};
+	util::CountupLoop<float> m_perfLogTimer{};
 	BannedPlayers m_bannedPlayers{};
 	std::vector<Bot> m_bots{};
+	std::vector<Bot*> m_thinkingBots{};
+	std::deque<BotPathRequest> m_botPathRequests{};
+	BotAiStats m_botAiStats{};
+	BotAiStats m_botAiTotals{};
+	util::ThreadPool m_botThreadPool{};
 	Clients m_clients{};
 	Clients::iterator m_currentClient;
 	Bot::CoordinateDistributionX m_xCoordinateDistribution{};
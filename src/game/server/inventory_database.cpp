@@ -0,0 +1,233 @@
+#include "inventory_database.hpp"
+
+#include "../../debug.hpp"               // Msg, INFO_MSG
+#include "../../network/byte_stream.hpp" // net::ByteInputStream, net::ByteOutputStream
+#include "../../utilities/crc.hpp"       // util::CRC32
+#include "../../utilities/file.hpp"      // util::readFile, util::dumpFile, util::replaceFile
+
+#include <algorithm>     // std::max, std::sort
+#include <array>         // std::array
+#include <cstdint>       // std::uint8_t, std::uint32_t
+#include <filesystem>    // std::filesystem::...
+#include <ios>           // std::ios
+#include <string_view>   // std::string_view
+#include <system_error>  // std::error_code
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::move
+
+namespace {
+
+constexpr auto SNAPSHOT_ID = util::CRC32{std::array{
+	std::byte{'A'},
+	std::byte{'F'},
+	std::byte{'2'},
+	std::byte{'I'},
+	std::byte{'S'},
+}};
+
+constexpr auto FORMAT_VERSION = std::uint32_t{1};
+
+using LogEntryType = std::uint8_t;
+enum LogEntry : LogEntryType {
+	LOG_ENTRY_UPDATE = 1, // Payload is a full inventory record that replaces any previous one with the same id.
+	LOG_ENTRY_REMOVE = 2, // Payload is the id of an inventory that was removed.
+};
+
+constexpr auto LOG_ENTRY_HEADER_SIZE = sizeof(LogEntryType) + sizeof(std::uint32_t);
+
+// Don't bother rewriting the snapshot for small logs, even if the snapshot is tiny.
+constexpr auto MIN_COMPACT_LOG_SIZE = std::size_t{64} * 1024;
+
+auto writeRecord(net::ByteOutputStream& stream, const InventoryRecord& record) -> void {
+	stream << record.id << record.address << record.username << record.tokenHash << record.points << record.level << record.hats;
+}
+
+[[nodiscard]] auto readRecord(net::ByteInputStream& stream, InventoryRecord& record) -> bool {
+	stream >> record.id >> record.address >> record.username >> record.tokenHash >> record.points >> record.level >> record.hats;
+	return stream.valid() && record.id != INVENTORY_ID_INVALID;
+}
+
+// Write a log entry, framed by its type and size in front and a checksum of the whole entry at the end.
+template <typename WritePayload>
+auto writeLogEntry(std::vector<std::byte>& data, LogEntryType type, WritePayload&& writePayload) -> void {
+	auto stream = net::ByteOutputStream{data};
+	const auto begin = stream.size();
+	stream << type << std::uint32_t{0};
+	writePayload(stream);
+	stream.replace(begin + sizeof(LogEntryType), static_cast<std::uint32_t>(stream.size() - begin - LOG_ENTRY_HEADER_SIZE));
+	stream << util::CRC32{util::Span<const std::byte>{data}.subspan(begin)};
+}
+
+[[nodiscard]] auto asString(util::Span<const std::byte> bytes) noexcept -> std::string_view {
+	return std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+} // namespace
+
+InventoryDatabase::InventoryDatabase(std::string filepath)
+	: m_filepath(std::move(filepath))
+	, m_logFilepath(m_filepath + ".log") {}
+
+auto InventoryDatabase::load(std::vector<InventoryRecord>& records) -> bool {
+	auto inventories = std::unordered_map<InventoryId, InventoryRecord>{};
+	m_snapshotSize = 0;
+	m_logSize = 0;
+
+	// Both files are read in one go and parsed straight from memory.
+	auto ec = std::error_code{};
+	if (std::filesystem::exists(m_filepath, ec)) {
+		const auto snapshot = util::readFile(m_filepath, std::ios::in | std::ios::binary);
+		if (!snapshot) {
+			return false;
+		}
+
+		const auto bytes = util::asBytes(util::Span<const char>{*snapshot});
+		if (bytes.size() < sizeof(util::CRC32)) {
+			return false;
+		}
+
+		const auto body = bytes.first(bytes.size() - sizeof(util::CRC32));
+		auto trailer = net::ByteInputStream{bytes.last(sizeof(util::CRC32))};
+		if (auto checksum = util::CRC32{}; !(trailer >> checksum) || checksum != util::CRC32{body}) {
+			return false;
+		}
+
+		auto stream = net::ByteInputStream{body};
+		auto id = util::CRC32{};
+		auto version = std::uint32_t{};
+		auto count = std::uint32_t{};
+		if (!(stream >> id >> version >> count) || id != SNAPSHOT_ID || version != FORMAT_VERSION) {
+			return false;
+		}
+
+		inventories.reserve(count);
+		for (auto i = std::uint32_t{0}; i < count; ++i) {
+			auto record = InventoryRecord{};
+			if (!readRecord(stream, record)) {
+				return false;
+			}
+			const auto recordId = record.id;
+			inventories.insert_or_assign(recordId, std::move(record));
+		}
+
+		if (!stream.eof()) {
+			return false;
+		}
+		m_snapshotSize = bytes.size();
+	}
+
+	if (std::filesystem::exists(m_logFilepath, ec)) {
+		const auto log = util::readFile(m_logFilepath, std::ios::in | std::ios::binary);
+		if (!log) {
+			return false;
+		}
+
+		const auto bytes = util::asBytes(util::Span<const char>{*log});
+		auto offset = std::size_t{0};
+		while (offset < bytes.size()) {
+			auto header = net::ByteInputStream{bytes.subspan(offset)};
+			auto type = LogEntryType{};
+			auto size = std::uint32_t{};
+			if (!(header >> type >> size) || header.size() < std::size_t{size} + sizeof(util::CRC32)) {
+				break;
+			}
+
+			const auto entry = bytes.subspan(offset, LOG_ENTRY_HEADER_SIZE + size);
+			auto trailer = net::ByteInputStream{bytes.subspan(offset + entry.size(), sizeof(util::CRC32))};
+			if (auto checksum = util::CRC32{}; !(trailer >> checksum) || checksum != util::CRC32{entry}) {
+				break;
+			}
+
+			auto payload = net::ByteInputStream{entry.subspan(LOG_ENTRY_HEADER_SIZE)};
+			if (type == LOG_ENTRY_UPDATE) {
+				auto record = InventoryRecord{};
+				if (!readRecord(payload, record) || !payload.eof()) {
+					break;
+				}
+				const auto recordId = record.id;
+				inventories.insert_or_assign(recordId, std::move(record));
+			} else if (type == LOG_ENTRY_REMOVE) {
+				auto recordId = InventoryId{};
+				if (!(payload >> recordId) || !payload.eof()) {
+					break;
+				}
+				inventories.erase(recordId);
+			} else {
+				break;
+			}
+			offset += entry.size() + sizeof(util::CRC32);
+		}
+
+		if (offset != bytes.size()) {
+			// The server most likely went down in the middle of an append. Drop the partial entry so that new entries can follow the valid ones.
+			INFO_MSG(Msg::SERVER, "Inventory database: Discarding {} bytes of invalid data at the end of \"{}\".", bytes.size() - offset, m_logFilepath);
+			std::filesystem::resize_file(m_logFilepath, offset, ec);
+			if (ec) {
+				return false;
+			}
+		}
+		m_logSize = offset;
+	}
+
+	records.clear();
+	records.reserve(inventories.size());
+	for (auto& [recordId, record] : inventories) {
+		records.push_back(std::move(record));
+	}
+	std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; });
+	return true;
+}
+
+auto InventoryDatabase::append(util::Span<const InventoryRecord> updated, util::Span<const InventoryId> removed) -> bool {
+	if (updated.empty() && removed.empty()) {
+		return true;
+	}
+
+	auto data = std::vector<std::byte>{};
+	for (const auto& record : updated) {
+		writeLogEntry(data, LOG_ENTRY_UPDATE, [&](auto& stream) { writeRecord(stream, record); });
+	}
+	for (const auto id : removed) {
+		writeLogEntry(data, LOG_ENTRY_REMOVE, [&](auto& stream) { stream << id; });
+	}
+
+	if (!util::dumpFile(m_logFilepath, asString(data), std::ios::app | std::ios::binary)) {
+		m_compactNeeded = true;
+		return false;
+	}
+	m_logSize += data.size();
+	return true;
+}
+
+auto InventoryDatabase::compact(util::Span<const InventoryRecord> records) -> bool {
+	auto data = std::vector<std::byte>{};
+	auto stream = net::ByteOutputStream{data};
+	stream << SNAPSHOT_ID << FORMAT_VERSION << static_cast<std::uint32_t>(records.size());
+	for (const auto& record : records) {
+		writeRecord(stream, record);
+	}
+	stream << util::CRC32{util::Span<const std::byte>{data}};
+
+	// If we go down before the log is emptied, replaying it again on load is harmless.
+	if (!util::replaceFile(m_filepath, asString(data), std::ios::binary)) {
+		m_compactNeeded = true;
+		return false;
+	}
+	m_snapshotSize = data.size();
+
+	if (!util::dumpFile(m_logFilepath, std::string_view{}, std::ios::trunc | std::ios::binary)) {
+		m_compactNeeded = true;
+		return false;
+	}
+	m_logSize = 0;
+	m_compactNeeded = false;
+	return true;
+}
+
+auto InventoryDatabase::shouldCompact() const noexcept -> bool {
+	return m_compactNeeded || m_logSize > std::max(m_snapshotSize, MIN_COMPACT_LOG_SIZE);
+}
+
+auto InventoryDatabase::getFilepath() const noexcept -> const std::string& {
+	return m_filepath;
+}
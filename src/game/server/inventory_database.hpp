@@ -0,0 +1,50 @@
+#ifndef AF2_SERVER_INVENTORY_DATABASE_HPP
+#define AF2_SERVER_INVENTORY_DATABASE_HPP
+
+#include "../../network/crypto.hpp"   // crypto::FastHash
+#include "../../network/endpoint.hpp" // net::IpAddress
+#include "../../utilities/span.hpp"   // util::Span
+#include "../data/hat.hpp"            // Hat
+#include "../data/inventory.hpp"      // InventoryId, INVENTORY_ID_INVALID
+#include "../data/score.hpp"          // Score
+
+#include <cstddef> // std::size_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+struct InventoryRecord final {
+	InventoryId id = INVENTORY_ID_INVALID;
+	net::IpAddress address{};
+	std::string username{};
+	crypto::FastHash tokenHash{};
+	Score points = 0;
+	Score level = 0;
+	std::vector<Hat> hats{};
+};
+
+// Binary inventory store made up of a snapshot file and a write-ahead log next to it.
+// Changes are appended to the log as whole inventory records, so saving only costs as much as what has changed since the last save.
+// The snapshot is rewritten from scratch and the log is emptied whenever the log grows larger than the snapshot.
+class InventoryDatabase final {
+public:
+	explicit InventoryDatabase(std::string filepath);
+
+	// Read the snapshot and replay the log on top of it. A torn entry at the end of the log is cut off.
+	[[nodiscard]] auto load(std::vector<InventoryRecord>& records) -> bool;
+
+	[[nodiscard]] auto append(util::Span<const InventoryRecord> updated, util::Span<const InventoryId> removed) -> bool;
+	[[nodiscard]] auto compact(util::Span<const InventoryRecord> records) -> bool;
+
+	[[nodiscard]] auto shouldCompact() const noexcept -> bool;
+
+	[[nodiscard]] auto getFilepath() const noexcept -> const std::string&;
+
+private:
+	std::string m_filepath;
+	std::string m_logFilepath;
+	std::size_t m_snapshotSize = 0;
+	std::size_t m_logSize = 0;
+	bool m_compactNeeded = false; // Set when an append fails, since the changes it contained are only recoverable from a full snapshot.
+};
+
+#endif
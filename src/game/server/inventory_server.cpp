@@ -5,7 +5,7 @@
 #include "../../utilities/algorithm.hpp"                        // util::transform, util::collect, util::erase, util::contains
 #include "../../utilities/string.hpp"                           // util::join
 
-#include <algorithm>   // std::max, std::lower_bound
+#include <algorithm>   // std::max, std::lower_bound, std::sort
 #include <cassert>     // assert
 #include <fmt/core.h>  // fmt::format
 #include <string_view> // std::string_view
@@ -20,9 +20,13 @@ auto InventoryServer::createInventory(net::IpAddress address, std::string userna
 	auto token = InventoryToken{};
 	crypto::generateAccessToken(token);
 	if (!m_inventories.contains<INVENTORY_ID>(id)) {
-		m_inventories.erase<INVENTORY_ADDRESS>(address);
+		for (auto it = m_inventories.find<INVENTORY_ADDRESS>(address); it != m_inventories.end(); it = m_inventories.find<INVENTORY_ADDRESS>(address)) {
+			m_modifiedInventories.insert(it->get<INVENTORY_ID>());
+			m_inventories.erase(it);
+		}
 		if (auto tokenHash = crypto::FastHash{}; crypto::fastHash(tokenHash, util::asBytes(util::Span{token}))) {
 			m_inventories.emplace_back(Inventory{std::move(username), tokenHash}, id, address);
+			m_modifiedInventories.insert(id);
 			++m_latestId;
 			return {id, token};
 		}
@@ -37,6 +41,7 @@ auto InventoryServer::accessInventory(InventoryId id, const InventoryToken& toke
 		if (crypto::verifyFastHash(inventory.tokenHash, util::asBytes(util::Span{token}))) {
 			inventory.username = std::move(username);
 			m_inventories.set<INVENTORY_ADDRESS>(it, address);
+			m_modifiedInventories.insert(id);
 			return true;
 		}
 	}
@@ -46,6 +51,7 @@ auto InventoryServer::accessInventory(InventoryId id, const InventoryToken& toke
 auto InventoryServer::addInventory(InventoryId id, net::IpAddress address, std::string username, const crypto::FastHash& tokenHash) -> bool {
 	if (!m_inventories.contains<INVENTORY_ID>(id) && !m_inventories.contains<INVENTORY_ADDRESS>(address)) {
 		m_inventories.emplace_back(Inventory{std::move(username), tokenHash}, id, address);
+		m_modifiedInventories.insert(id);
 		m_latestId = std::max(m_latestId, id);
 		return true;
 	}
@@ -57,7 +63,11 @@ auto InventoryServer::hasInventory(InventoryId id) const -> bool {
 }
 
 auto InventoryServer::removeInventory(InventoryId id) -> bool {
-	return m_inventories.erase<INVENTORY_ID>(id) != 0;
+	if (m_inventories.erase<INVENTORY_ID>(id) == 0) {
+		return false;
+	}
+	m_modifiedInventories.insert(id);
+	return true;
 }
 
 auto InventoryServer::getInventoryList() const -> std::string {
@@ -92,42 +102,118 @@ auto InventoryServer::getInventoryList() const -> std::string {
 }
 
 auto InventoryServer::getInventoryConfig() const -> std::string {
-	using InventoryRef = util::Reference<const Inventories::value_type>;
-	using Refs = std::vector<InventoryRef>;
-
-	static constexpr auto compareInventoryRefs = [](const auto& lhs, const auto& rhs) {
-		return lhs->template get<INVENTORY_ID>() < rhs->template get<INVENTORY_ID>();
-	};
+	return InventoryServer::formatInventoryConfig(this->getInventoryRecords());
+}
 
-	static constexpr auto getInventoryCommands = [](const auto& elem) {
+auto InventoryServer::formatInventoryConfig(util::Span<const InventoryRecord> records) -> std::string {
+	static constexpr auto getInventoryCommands = [](const auto& record) {
 		const auto getHatCommand = [&](const auto& hat) {
-			return fmt::format("{} {} {}",
-			                   GET_COMMAND(sv_inventory_give_hat).getName(),
-			                   elem->template get<INVENTORY_ID>(),
-			                   Script::escapedString(hat.getName()));
+			return fmt::format("{} {} {}", GET_COMMAND(sv_inventory_give_hat).getName(), record.id, Script::escapedString(hat.getName()));
 		};
 
-		const auto& [inventory, inventoryId, inventoryAddress] = *elem;
 		return fmt::format(
 			"{} {} {} {} {}\n"
 			"{} {} {}\n"
 			"{} {} {}\n"
 			"{}\n",
 			GET_COMMAND(sv_inventory_add).getName(),
-			inventoryId,
-			Script::escapedString(std::string{inventoryAddress}),
-			Script::escapedString(inventory.username),
-			Script::escapedString(std::string_view{reinterpret_cast<const char*>(inventory.tokenHash.data()), inventory.tokenHash.size()}),
+			record.id,
+			Script::escapedString(std::string{record.address}),
+			Script::escapedString(record.username),
+			Script::escapedString(std::string_view{reinterpret_cast<const char*>(record.tokenHash.data()), record.tokenHash.size()}),
 			GET_COMMAND(sv_inventory_set_points).getName(),
-			inventoryId,
-			inventory.points,
+			record.id,
+			record.points,
 			GET_COMMAND(sv_inventory_set_level).getName(),
-			inventoryId,
-			inventory.level,
-			inventory.hats | util::transform(getHatCommand) | util::join('\n'));
+			record.id,
+			record.level,
+			record.hats | util::transform(getHatCommand) | util::join('\n'));
 	};
 
-	return util::collect<Refs>(m_inventories) | util::sort(compareInventoryRefs) | util::transform(getInventoryCommands) | util::join('\n');
+	return records | util::transform(getInventoryCommands) | util::join('\n');
+}
+
+auto InventoryServer::loadInventoryDatabase(std::string filepath) -> bool {
+	auto& database = m_database.emplace(std::move(filepath));
+
+	auto records = std::vector<InventoryRecord>{};
+	if (!database.load(records)) {
+		m_database.reset();
+		return false;
+	}
+
+	// The database takes precedence over any inventories that were added before it was loaded, such as from an old config.
+	for (auto& record : records) {
+		m_inventories.erase<INVENTORY_ID>(record.id);
+		for (auto it = m_inventories.find<INVENTORY_ADDRESS>(record.address); it != m_inventories.end();
+		     it = m_inventories.find<INVENTORY_ADDRESS>(record.address)) {
+			m_modifiedInventories.insert(it->get<INVENTORY_ID>());
+			m_inventories.erase(it);
+		}
+
+		auto& [inventory, inventoryId, inventoryAddress] =
+			m_inventories.emplace_back(Inventory{std::move(record.username), record.tokenHash}, record.id, record.address);
+		inventory.hats = std::move(record.hats);
+		inventory.points = record.points;
+		inventory.level = record.level;
+		m_modifiedInventories.erase(inventoryId);
+		m_latestId = std::max(m_latestId, inventoryId);
+	}
+	return true;
+}
+
+auto InventoryServer::hasInventoryDatabase() const noexcept -> bool {
+	return m_database.has_value();
+}
+
+auto InventoryServer::makeInventorySave() -> InventorySave {
+	auto save = InventorySave{};
+	if (!m_database) {
+		save.records = this->getInventoryRecords();
+		return save;
+	}
+
+	save.database = m_database;
+	if (m_database->shouldCompact()) {
+		save.records = this->getInventoryRecords();
+		save.compact = true;
+	} else {
+		save.records.reserve(m_modifiedInventories.size());
+		for (const auto id : m_modifiedInventories) {
+			if (const auto it = m_inventories.find<INVENTORY_ID>(id); it != m_inventories.end()) {
+				save.records.push_back(InventoryServer::makeInventoryRecord(*it));
+			} else {
+				save.removed.push_back(id);
+			}
+		}
+	}
+
+	// If the write fails, the database will ask for a full snapshot next time instead.
+	m_modifiedInventories.clear();
+	return save;
+}
+
+auto InventoryServer::finishInventorySave(InventorySave&& save) -> void {
+	if (save.database && m_database) {
+		m_database = std::move(save.database);
+	}
+}
+
+auto InventoryServer::InventorySave::write() -> bool {
+	if (!database) {
+		return true;
+	}
+	if (compact) {
+		return database->compact(records);
+	}
+	return database->append(records, removed);
+}
+
+auto InventoryServer::InventorySave::getConfig() const -> std::string {
+	if (database) {
+		return std::string{};
+	}
+	return InventoryServer::formatInventoryConfig(records);
 }
 
 auto InventoryServer::getInventoryIds() const -> std::vector<InventoryId> {
@@ -168,6 +254,7 @@ auto InventoryServer::giveInventoryHat(InventoryId id, Hat hat) -> bool {
 		                                        [](const auto& lhs, const auto& rhs) { return lhs.getName() < rhs.getName(); });
 		    hatIt == (*it)->hats.end() || *hatIt != hat) {
 			(*it)->hats.insert(hatIt, hat);
+			m_modifiedInventories.insert(id);
 		}
 		return true;
 	}
@@ -177,7 +264,10 @@ auto InventoryServer::giveInventoryHat(InventoryId id, Hat hat) -> bool {
 auto InventoryServer::removeInventoryHat(InventoryId id, Hat hat) -> bool {
 	if (const auto it = m_inventories.find<INVENTORY_ID>(id); it != m_inventories.end()) {
 		this->unequipHat(id, hat);
-		util::erase((*it)->hats, hat);
+		if (util::contains((*it)->hats, hat)) {
+			util::erase((*it)->hats, hat);
+			m_modifiedInventories.insert(id);
+		}
 		return true;
 	}
 	return false;
@@ -192,6 +282,7 @@ auto InventoryServer::getInventoryHats(InventoryId id) const -> const std::vecto
 
 auto InventoryServer::inventoryPoints(InventoryId id) -> Score* {
 	if (const auto it = m_inventories.find<INVENTORY_ID>(id); it != m_inventories.end()) {
+		m_modifiedInventories.insert(id);
 		return &((*it)->points);
 	}
 	return nullptr;
@@ -206,6 +297,7 @@ auto InventoryServer::inventoryPoints(InventoryId id) const -> const Score* {
 
 auto InventoryServer::inventoryLevel(InventoryId id) -> Score* {
 	if (const auto it = m_inventories.find<INVENTORY_ID>(id); it != m_inventories.end()) {
+		m_modifiedInventories.insert(id);
 		return &((*it)->level);
 	}
 	return nullptr;
@@ -218,6 +310,21 @@ auto InventoryServer::inventoryLevel(InventoryId id) const -> const Score* {
 	return nullptr;
 }
 
+auto InventoryServer::makeInventoryRecord(const Inventories::value_type& elem) -> InventoryRecord {
+	const auto& [inventory, inventoryId, inventoryAddress] = elem;
+	return InventoryRecord{inventoryId, inventoryAddress, inventory.username, inventory.tokenHash, inventory.points, inventory.level, inventory.hats};
+}
+
+auto InventoryServer::getInventoryRecords() const -> std::vector<InventoryRecord> {
+	auto records = std::vector<InventoryRecord>{};
+	records.reserve(m_inventories.size());
+	for (const auto& elem : m_inventories) {
+		records.push_back(InventoryServer::makeInventoryRecord(elem));
+	}
+	std::sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) { return lhs.id < rhs.id; });
+	return records;
+}
+
 auto InventoryServer::handleMessage(msg::sv::in::InventoryEquipHatRequest&& msg) -> void {
 	if (this->testSpam()) {
 		return;
@@ -4,20 +4,37 @@
 #include "../../network/crypto.hpp"           // crypto::...
 #include "../../network/endpoint.hpp"         // net::IpAddress
 #include "../../utilities/multi_hash.hpp"     // util::MultiHash
+#include "../../utilities/span.hpp"           // util::Span
 #include "../data/hat.hpp"                    // Hat
 #include "../data/inventory.hpp"              // InventoryId, InventoryToken, INVENTORY_ID_INVALID
 #include "../data/score.hpp"                  // Score
 #include "../shared/game_client_messages.hpp" // msg::cl::out::Inventory...
 #include "../shared/game_server_messages.hpp" // msg::sv::in::Inventory...
+#include "inventory_database.hpp"             // InventoryDatabase, InventoryRecord
 
-#include <cstddef>  // std::size_t, std::byte
-#include <optional> // std::optional
-#include <string>   // std::string
-#include <utility>  // std::move, std::pair
-#include <vector>   // std::vector
+#include <cstddef>       // std::size_t, std::byte
+#include <optional>      // std::optional
+#include <string>        // std::string
+#include <unordered_set> // std::unordered_set
+#include <utility>       // std::move, std::pair
+#include <vector>        // std::vector
 
 class InventoryServer {
 public:
+	// Copy of the inventory data that needs to be saved, so that it can be written on another thread.
+	struct InventorySave final {
+		std::optional<InventoryDatabase> database{}; // Copy of the database, or empty if the inventories are stored in the server config.
+		std::vector<InventoryRecord> records{};      // All inventories, or only the modified ones when appending to the database.
+		std::vector<InventoryId> removed{};
+		bool compact = false;
+
+		// Writes through the copy of the database, so the one owned by the server is never touched off the main thread.
+		[[nodiscard]] auto write() -> bool;
+		[[nodiscard]] auto getConfig() const -> std::string;
+	};
+
+	[[nodiscard]] static auto formatInventoryConfig(util::Span<const InventoryRecord> records) -> std::string;
+
 	InventoryServer() = default;
 
 	InventoryServer(const InventoryServer&) = default;
@@ -41,6 +58,15 @@ public:
 	[[nodiscard]] auto getInventoryList() const -> std::string;
 	[[nodiscard]] auto getInventoryConfig() const -> std::string;
 
+	[[nodiscard]] auto loadInventoryDatabase(std::string filepath) -> bool;
+	[[nodiscard]] auto hasInventoryDatabase() const noexcept -> bool;
+
+	// Take the changes since the last save. The returned save must be written and finished before the next one is made.
+	[[nodiscard]] auto makeInventorySave() -> InventorySave;
+
+	// Take over the database state from a written save, such as the new log size or whether the write failed.
+	auto finishInventorySave(InventorySave&& save) -> void;
+
 	[[nodiscard]] auto getInventoryIds() const -> std::vector<InventoryId>;
 
 	[[nodiscard]] auto equipInventoryHat(InventoryId id, Hat hat) -> bool;
@@ -95,8 +121,14 @@ private:
 	static constexpr auto INVENTORY_ID = std::size_t{INVENTORY_INVENTORY + 1};
 	static constexpr auto INVENTORY_ADDRESS = std::size_t{INVENTORY_ID + 1};
 
+	[[nodiscard]] static auto makeInventoryRecord(const Inventories::value_type& elem) -> InventoryRecord;
+
+	[[nodiscard]] auto getInventoryRecords() const -> std::vector<InventoryRecord>;
+
 	Inventories m_inventories{};
 	InventoryId m_latestId = INVENTORY_ID_INVALID;
+	std::optional<InventoryDatabase> m_database{};
+	std::unordered_set<InventoryId> m_modifiedInventories{}; // Inventories that have been changed, added or removed since the last database save.
 };
 
 #endif
@@ -0,0 +1,83 @@
+#ifndef AF2_SERVER_SCRIPT_HOOK_HPP
+#define AF2_SERVER_SCRIPT_HOOK_HPP
+
+#include <array>       // std::array
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t
+#include <string_view> // std::string_view
+
+// clang-format off
+// X(name)
+#define ENUM_SCRIPT_HOOKS(X) \
+	X(on_map_start) \
+	X(on_map_end) \
+	X(on_round_start) \
+	X(on_round_reset) \
+	X(on_round_won) \
+	X(on_stalemate) \
+	X(on_pre_tick) \
+	X(on_post_tick) \
+	X(on_chat) \
+	X(on_team_chat) \
+	X(on_server_receive_command) \
+	X(on_player_join) \
+	X(on_player_leave) \
+	X(on_player_create) \
+	X(on_team_select) \
+	X(on_player_spawn) \
+	X(on_kill_player) \
+	X(on_resupply) \
+	X(on_projectile_create) \
+	X(on_explosion_create) \
+	X(on_sentry_create) \
+	X(on_kill_sentry) \
+	X(on_medkit_create) \
+	X(on_medkit_spawn) \
+	X(on_pickup_medkit) \
+	X(on_ammopack_create) \
+	X(on_ammopack_spawn) \
+	X(on_pickup_ammopack) \
+	X(on_flag_create) \
+	X(on_pickup_flag) \
+	X(on_drop_flag) \
+	X(on_return_flag) \
+	X(on_capture_flag) \
+	X(on_cart_create) \
+	X(on_push_cart) \
+	X(on_capture_cart) \
+	X(on_ent_create) \
+	X(on_ent_step) \
+	X(on_collide_ent_world) \
+	X(on_collide_ent_player) \
+	X(on_collide_ent_projectile) \
+	X(on_collide_ent_explosion) \
+	X(on_collide_ent_sentry) \
+	X(on_collide_ent_medkit) \
+	X(on_collide_ent_ammopack) \
+	X(on_collide_ent_ent) \
+	X(on_collide_ent_flag) \
+	X(on_collide_ent_cart)
+// clang-format on
+
+// Script function that the game server calls when something happens, if the server scripts have defined it.
+enum class ScriptHook : std::uint8_t {
+#define X(name) name,
+	ENUM_SCRIPT_HOOKS(X)
+#undef X
+};
+
+inline constexpr auto SCRIPT_HOOK_NAMES = std::array{
+#define X(name) std::string_view{#name},
+	ENUM_SCRIPT_HOOKS(X)
+#undef X
+};
+
+inline constexpr auto SCRIPT_HOOK_COUNT = SCRIPT_HOOK_NAMES.size();
+
+[[nodiscard]] constexpr auto getScriptHookName(ScriptHook hook) noexcept -> std::string_view {
+	return SCRIPT_HOOK_NAMES[static_cast<std::size_t>(hook)];
+}
+
+#undef ENUM_SCRIPT_HOOKS
+
+#endif
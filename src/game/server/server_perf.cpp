@@ -0,0 +1,165 @@
+#include "server_perf.hpp"
+
+#include <algorithm>   // std::nth_element, std::max_element
+#include <cstddef>     // std::ptrdiff_t
+#include <fmt/core.h>  // fmt::format, fmt::format_to
+#include <iterator>    // std::back_inserter
+#include <type_traits> // std::underlying_type_t
+
+namespace {
+
+[[nodiscard]] auto toMicroseconds(std::chrono::nanoseconds time) noexcept -> std::chrono::microseconds {
+	return std::chrono::duration_cast<std::chrono::microseconds>(time);
+}
+
+} // namespace
+
+ServerPerf::ServerPerf()
+	: m_history(HISTORY_SIZE) {}
+
+template <typename Callback>
+auto ServerPerf::forEachSample(Callback&& callback) const -> void {
+	for (auto i = std::size_t{0}; i < m_count; ++i) {
+		callback(m_history[(m_next + m_history.size() - m_count + i) % m_history.size()]);
+	}
+}
+
+auto ServerPerf::measure(ServerPerfPhase phase) noexcept -> Timer {
+	return Timer{*this, phase};
+}
+
+auto ServerPerf::add(ServerPerfPhase phase, Clock::duration time) noexcept -> void {
+	m_current.phaseTimes[static_cast<std::underlying_type_t<ServerPerfPhase>>(phase)] += time;
+}
+
+auto ServerPerf::current() noexcept -> ServerPerfSample& {
+	return m_current;
+}
+
+auto ServerPerf::commit() noexcept -> void {
+	m_history[m_next] = m_current;
+	m_next = (m_next + 1) % m_history.size();
+	if (m_count < m_history.size()) {
+		++m_count;
+	}
+	m_current = ServerPerfSample{};
+}
+
+auto ServerPerf::reset() noexcept -> void {
+	m_next = 0;
+	m_count = 0;
+	m_current = ServerPerfSample{};
+}
+
+template <typename GetTime>
+auto ServerPerf::summarizeTimes(GetTime&& getTime) const -> Summary {
+	if (m_count == 0) {
+		return Summary{};
+	}
+
+	auto times = std::vector<std::chrono::nanoseconds>{};
+	times.reserve(m_count);
+	this->forEachSample([&](const ServerPerfSample& sample) { times.push_back(getTime(sample)); });
+
+	auto summary = Summary{};
+	const auto p50 = times.begin() + static_cast<std::ptrdiff_t>(times.size() / 2);
+	std::nth_element(times.begin(), p50, times.end());
+	summary.p50 = toMicroseconds(*p50);
+	const auto p99 = times.begin() + static_cast<std::ptrdiff_t>(times.size() * 99 / 100);
+	std::nth_element(times.begin(), p99, times.end());
+	summary.p99 = toMicroseconds(*p99);
+	summary.max = toMicroseconds(*std::max_element(times.begin(), times.end()));
+	return summary;
+}
+
+auto ServerPerf::summarize(ServerPerfPhase phase) const -> Summary {
+	const auto index = static_cast<std::underlying_type_t<ServerPerfPhase>>(phase);
+	return this->summarizeTimes([index](const ServerPerfSample& sample) { return sample.phaseTimes[index]; });
+}
+
+auto ServerPerf::summarizeTickLateness() const -> Summary {
+	return this->summarizeTimes([](const ServerPerfSample& sample) { return sample.tickLateness; });
+}
+
+auto ServerPerf::getStatusString() const -> std::string {
+	if (m_count == 0) {
+		return "No ticks recorded.";
+	}
+
+	auto result = fmt::format("Last {} tick frames (times in us):\n{:<12} {:>8} {:>8} {:>8}", m_count, "phase", "p50", "p99", "max");
+	for (auto i = std::size_t{0}; i < SERVER_PERF_PHASE_COUNT; ++i) {
+		const auto summary = this->summarize(static_cast<ServerPerfPhase>(i));
+		fmt::format_to(std::back_inserter(result),
+		               "\n{:<12} {:>8} {:>8} {:>8}",
+		               SERVER_PERF_PHASE_NAMES[i],
+		               summary.p50.count(),
+		               summary.p99.count(),
+		               summary.max.count());
+	}
+	const auto lateness = this->summarizeTickLateness();
+	fmt::format_to(std::back_inserter(result), "\n{:<12} {:>8} {:>8} {:>8}", "tick jitter", lateness.p50.count(), lateness.p99.count(), lateness.max.count());
+
+	const auto& last = m_history[(m_next + m_history.size() - 1) % m_history.size()];
+	fmt::format_to(std::back_inserter(result),
+	               "\nLast frame: tick #{} ({} ticks), {} players, {} entities, {} packets ({} bytes) in, {} packets ({} bytes) out.",
+	               last.tickCount,
+	               last.ticks,
+	               last.players,
+	               last.entities,
+	               last.packetsReceived,
+	               last.bytesReceived,
+	               last.packetsSent,
+	               last.bytesSent);
+	return result;
+}
+
+auto ServerPerf::getLogLine() const -> std::string {
+	const auto total = this->summarize(ServerPerfPhase::TOTAL);
+	const auto world = this->summarize(ServerPerfPhase::WORLD);
+	const auto bots = this->summarize(ServerPerfPhase::BOTS);
+	const auto snapshots = this->summarize(ServerPerfPhase::SNAPSHOTS);
+	const auto lateness = this->summarizeTickLateness();
+	return fmt::format(
+		"total {}/{}/{} us, world {}/{}/{} us, bots {}/{}/{} us, snapshots {}/{}/{} us, tick jitter {}/{}/{} us (p50/p99/max over {} tick frames).",
+		total.p50.count(),
+		total.p99.count(),
+		total.max.count(),
+		world.p50.count(),
+		world.p99.count(),
+		world.max.count(),
+		bots.p50.count(),
+		bots.p99.count(),
+		bots.max.count(),
+		snapshots.p50.count(),
+		snapshots.p99.count(),
+		snapshots.max.count(),
+		lateness.p50.count(),
+		lateness.p99.count(),
+		lateness.max.count(),
+		m_count);
+}
+
+auto ServerPerf::exportCsv() const -> std::string {
+	auto result = std::string{"tick,ticks"};
+	for (const auto& name : SERVER_PERF_PHASE_NAMES) {
+		fmt::format_to(std::back_inserter(result), ",{}_us", name);
+	}
+	result.append(",lateness_us,players,entities,packets_in,bytes_in,packets_out,bytes_out\n");
+
+	this->forEachSample([&](const ServerPerfSample& sample) {
+		fmt::format_to(std::back_inserter(result), "{},{}", sample.tickCount, sample.ticks);
+		for (const auto& time : sample.phaseTimes) {
+			fmt::format_to(std::back_inserter(result), ",{}", toMicroseconds(time).count());
+		}
+		fmt::format_to(std::back_inserter(result),
+		               ",{},{},{},{},{},{},{}\n",
+		               toMicroseconds(sample.tickLateness).count(),
+		               sample.players,
+		               sample.entities,
+		               sample.packetsReceived,
+		               sample.bytesReceived,
+		               sample.packetsSent,
+		               sample.bytesSent);
+	});
+	return result;
+}
@@ -0,0 +1,123 @@
+#ifndef AF2_SERVER_SERVER_PERF_HPP
+#define AF2_SERVER_SERVER_PERF_HPP
+
+#include "../data/tick_count.hpp" // TickCount
+
+#include <array>       // std::array
+#include <chrono>      // std::chrono::...
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint8_t, std::uint32_t
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+enum class ServerPerfPhase : std::uint8_t {
+	RECEIVE,     // Receiving packets from the socket.
+	CONNECTIONS, // Updating connections and handling received messages.
+	BOTS,        // Bot thinking and path finding.
+	WORLD,       // Updating the world.
+	CLIENTS,     // Per-client updates such as cvars and resource uploads.
+	SNAPSHOTS,   // Taking and writing snapshots.
+	SEND,        // Sending packets.
+	PROCESS,     // Running the server console process.
+	TOTAL,       // Everything the server did, including the phases above.
+};
+
+inline constexpr auto SERVER_PERF_PHASE_COUNT = static_cast<std::size_t>(ServerPerfPhase::TOTAL) + 1;
+
+inline constexpr auto SERVER_PERF_PHASE_NAMES = std::array<std::string_view, SERVER_PERF_PHASE_COUNT>{
+	"receive",
+	"connections",
+	"bots",
+	"world",
+	"clients",
+	"snapshots",
+	"send",
+	"process",
+	"total",
+};
+
+// Everything the server did from the end of one tick frame to the end of the next one.
+struct ServerPerfSample final {
+	std::array<std::chrono::nanoseconds, SERVER_PERF_PHASE_COUNT> phaseTimes{};
+	std::chrono::nanoseconds tickLateness{}; // How long after its deadline the last tick of the frame ran, in server time.
+	TickCount tickCount = 0;
+	std::uint32_t ticks = 0;
+	std::uint32_t players = 0;
+	std::uint32_t entities = 0;
+	std::uint32_t packetsReceived = 0;
+	std::uint32_t bytesReceived = 0;
+	std::uint32_t packetsSent = 0;
+	std::uint32_t bytesSent = 0;
+};
+
+// Rolling record of the most recent server tick frames.
+// Recording only adds to the current sample, so all sorting for the percentiles is left to when the statistics are requested.
+class ServerPerf final {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr auto HISTORY_SIZE = std::size_t{1024};
+
+	class Timer final {
+	public:
+		Timer(ServerPerf& perf, ServerPerfPhase phase) noexcept
+			: m_perf(perf)
+			, m_phase(phase)
+			, m_startTime(Clock::now()) {}
+
+		~Timer() {
+			m_perf.add(m_phase, Clock::now() - m_startTime);
+		}
+
+		Timer(const Timer&) = delete;
+		Timer(Timer&&) = delete;
+		auto operator=(const Timer&) -> Timer& = delete;
+		auto operator=(Timer&&) -> Timer& = delete;
+
+	private:
+		ServerPerf& m_perf;
+		ServerPerfPhase m_phase;
+		Clock::time_point m_startTime;
+	};
+
+	struct Summary final {
+		std::chrono::microseconds p50{};
+		std::chrono::microseconds p99{};
+		std::chrono::microseconds max{};
+	};
+
+	ServerPerf();
+
+	[[nodiscard]] auto measure(ServerPerfPhase phase) noexcept -> Timer;
+	auto add(ServerPerfPhase phase, Clock::duration time) noexcept -> void;
+
+	[[nodiscard]] auto current() noexcept -> ServerPerfSample&;
+
+	// Finish the current sample and start a new one.
+	auto commit() noexcept -> void;
+	auto reset() noexcept -> void;
+
+	[[nodiscard]] auto summarize(ServerPerfPhase phase) const -> Summary;
+	[[nodiscard]] auto summarizeTickLateness() const -> Summary;
+
+	[[nodiscard]] auto getStatusString() const -> std::string;
+	[[nodiscard]] auto getLogLine() const -> std::string;
+
+	// One line per sample, oldest first, with a header line naming the columns.
+	[[nodiscard]] auto exportCsv() const -> std::string;
+
+private:
+	template <typename GetTime>
+	[[nodiscard]] auto summarizeTimes(GetTime&& getTime) const -> Summary;
+
+	template <typename Callback>
+	auto forEachSample(Callback&& callback) const -> void;
+
+	std::vector<ServerPerfSample> m_history;
+	std::size_t m_next = 0;
+	std::size_t m_count = 0;
+	ServerPerfSample m_current{};
+};
+
+#endif
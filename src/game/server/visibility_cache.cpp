@@ -0,0 +1,85 @@
+#include "visibility_cache.hpp"
+
+#include "../shared/map.hpp" // Map
+
+#include <limits> // std::numeric_limits
+
+namespace {
+
+constexpr auto ENTRY_BITS = std::size_t{2};
+constexpr auto ENTRY_MASK = std::uint32_t{0b11};
+constexpr auto ENTRIES_PER_WORD = std::size_t{std::numeric_limits<std::uint32_t>::digits} / ENTRY_BITS;
+
+// Entries start out as zero, meaning unknown.
+constexpr auto ENTRY_VISIBLE = std::uint32_t{0b01};
+constexpr auto ENTRY_BLOCKED = std::uint32_t{0b10};
+
+// Don't cache anything if the table would be larger than this.
+constexpr auto MAX_TABLE_SIZE = std::size_t{32} * 1024 * 1024;
+
+} // namespace
+
+VisibilityCache::VisibilityCache(const Map& map)
+	: m_map(map) {}
+
+auto VisibilityCache::reset(Vec2::Length radius) -> void {
+	this->clear();
+	if (radius <= 0 || !m_map->isLoaded()) {
+		return;
+	}
+
+	const auto width = static_cast<std::size_t>(m_map->getWidth());
+	const auto height = static_cast<std::size_t>(m_map->getHeight());
+	const auto windowSize = static_cast<std::size_t>(radius) * 2 + 1;
+	const auto entryCount = width * height * windowSize * windowSize;
+	const auto wordCount = (entryCount + ENTRIES_PER_WORD - 1) / ENTRIES_PER_WORD;
+	if (wordCount > MAX_TABLE_SIZE / sizeof(Word)) {
+		return;
+	}
+
+	m_radius = radius;
+	m_width = width;
+	m_height = height;
+	m_windowSize = windowSize;
+	m_entries = std::make_unique<std::atomic<Word>[]>(wordCount);
+}
+
+auto VisibilityCache::clear() noexcept -> void {
+	m_radius = 0;
+	m_width = 0;
+	m_height = 0;
+	m_windowSize = 0;
+	m_entries.reset();
+}
+
+auto VisibilityCache::lineOfSight(Vec2 p1, Vec2 p2) const noexcept -> bool {
+	if (!m_entries) {
+		return m_map->lineOfSight(p1, p2);
+	}
+
+	const auto x = static_cast<std::size_t>(p1.x);
+	const auto y = static_cast<std::size_t>(p1.y);
+	const auto dx = static_cast<std::size_t>(p2.x - p1.x + m_radius);
+	const auto dy = static_cast<std::size_t>(p2.y - p1.y + m_radius);
+	if (p1.x < 0 || p1.y < 0 || x >= m_width || y >= m_height || dx >= m_windowSize || dy >= m_windowSize) {
+		return m_map->lineOfSight(p1, p2);
+	}
+
+	const auto entry = ((y * m_width + x) * m_windowSize + dy) * m_windowSize + dx;
+	auto& word = m_entries[entry / ENTRIES_PER_WORD];
+	const auto shift = (entry % ENTRIES_PER_WORD) * ENTRY_BITS;
+	switch ((word.load(std::memory_order_relaxed) >> shift) & ENTRY_MASK) {
+		case ENTRY_VISIBLE: return true;
+		case ENTRY_BLOCKED: return false;
+		default: break;
+	}
+
+	// Two threads may end up tracing the same pair, but they will always store the same result.
+	const auto visible = m_map->lineOfSight(p1, p2);
+	word.fetch_or(((visible) ? ENTRY_VISIBLE : ENTRY_BLOCKED) << shift, std::memory_order_relaxed);
+	return visible;
+}
+
+auto VisibilityCache::getRadius() const noexcept -> Vec2::Length {
+	return m_radius;
+}
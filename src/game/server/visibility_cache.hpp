@@ -0,0 +1,39 @@
+#ifndef AF2_SERVER_VISIBILITY_CACHE_HPP
+#define AF2_SERVER_VISIBILITY_CACHE_HPP
+
+#include "../../utilities/reference.hpp" // util::Reference
+#include "../data/vector.hpp"            // Vec2
+
+#include <atomic>  // std::atomic
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <memory>  // std::unique_ptr
+
+class Map;
+
+// Lazily filled table of line of sight results between pairs of tiles that are at most a certain radius apart.
+// Each pair is traced at most once per map; queries outside of the radius fall back to Map::lineOfSight.
+// Queries are safe to make concurrently from multiple threads.
+class VisibilityCache final {
+public:
+	explicit VisibilityCache(const Map& map);
+
+	auto reset(Vec2::Length radius) -> void;
+	auto clear() noexcept -> void;
+
+	[[nodiscard]] auto lineOfSight(Vec2 p1, Vec2 p2) const noexcept -> bool;
+
+	[[nodiscard]] auto getRadius() const noexcept -> Vec2::Length;
+
+private:
+	using Word = std::uint32_t;
+
+	util::Reference<const Map> m_map;
+	Vec2::Length m_radius = 0;
+	std::size_t m_width = 0;
+	std::size_t m_height = 0;
+	std::size_t m_windowSize = 0;
+	std::unique_ptr<std::atomic<Word>[]> m_entries = nullptr;
+};
+
+#endif
@@ -1,22 +1,23 @@
 #include "world.hpp"
 
-#include "../../console/command_utilities.hpp"       // cmd::...
+#include "../../console/commands/bot_commands.hpp"   // bot_range
 #include "../../console/commands/world_commands.hpp" // mp_..., sv_max_shots_per_frame, sv_max_move_steps_per_frame
 #include "../../console/environment.hpp"             // Environment
 #include "../../gui/layout.hpp"                      // gui::VIEWPORT_...
+#include "../../network/byte_stream.hpp"             // net::ByteOutputStream
 #include "../../network/connection.hpp"              // net::Connection
 #include "../../utilities/algorithm.hpp" // util::filter, util::eraseIf, util::anyOf, util::findIf, util::countIf, util::transform, util::collect
-#include "../../utilities/match.hpp"  // util::match
-#include "../../utilities/string.hpp" // util::toString
-#include "../data/actions.hpp"        // Actions, Action
-#include "../shared/entities.hpp"     // ent::sh::..., ent::findClosestDistanceSquared
-#include "../shared/map.hpp"          // Map
-#include "game_server.hpp"            // GameServer
+#include "../../utilities/match.hpp" // util::match
+#include "../data/actions.hpp"       // Actions, Action
+#include "../shared/entities.hpp"    // ent::sh::..., ent::findClosestDistanceSquared
+#include "../shared/map.hpp"         // Map
+#include "game_server.hpp"           // GameServer
 
 #include <algorithm>     // std::min, std::max, std::clamp, std::find_if
 #include <array>         // std::array
 #include <cassert>       // assert
 #include <cmath>         // std::ceil, std::round
+#include <cstddef>       // std::byte
 #include <fmt/core.h>    // fmt::format
 #include <unordered_set> // std::unordered_set
 #include <utility>       // std::move, std::pair
@@ -24,10 +25,11 @@
 
 World::World(const Map& map, GameServer& server)
 	: m_map(map)
-	, m_server(server) {}
+	, m_server(server)
+	, m_visibilityCache(map) {}
 
 auto World::reset() -> void {
-	m_server.callIfDefined(Script::command({"on_map_end"}));
+	m_server.callHook(ScriptHook::on_map_end);
 	m_server.resetClients();
 	m_server.resetEnvironment();
 	m_tickCount = 0;
@@ -45,20 +47,22 @@ auto World::reset() -> void {
 	m_teamSpawns.clear();
 	m_teamWins.clear();
 	m_collisionMap.clear();
+	m_visibilityCache.clear();
 	m_mapTime = 0.0f;
 	m_roundsPlayed = 0;
 	m_awaitingLevelChange = false;
 }
 
 auto World::startMap() -> void {
+	m_visibilityCache.reset(static_cast<Vec2::Length>(std::max(static_cast<int>(bot_range), static_cast<int>(mp_sentry_range))));
 	m_server.setObject("map_name", Environment::Constant{std::string{m_map.getName()}});
 	m_server.callScript(m_map.getScript());
-	m_server.callIfDefined(Script::command({"on_map_start"}));
+	m_server.callHook(ScriptHook::on_map_start);
 	this->startRound();
 }
 
 auto World::resetRound() -> void {
-	m_server.callIfDefined(Script::command({"on_round_reset"}));
+	m_server.callHook(ScriptHook::on_round_reset);
 	for (auto it = m_flags.stable_begin(); it != m_flags.stable_end(); ++it) {
 		it->second->score = 0;
 		this->returnFlag(it, false);
@@ -103,7 +107,7 @@ auto World::resetRound() -> void {
 auto World::win(Team team) -> void {
 	const auto rounds = ++m_roundsPlayed;
 	const auto wins = ++m_teamWins[team];
-	m_server.callIfDefined(Script::command({"on_round_won", cmd::formatTeamId(team)}));
+	m_server.callHook(ScriptHook::on_round_won, team.getId());
 	m_server.playTeamSound(SoundId::victory(), SoundId::defeat(), team);
 	m_server.writeServerChatMessage(fmt::format("{} team wins!", team.getName()));
 	const auto winPoints = static_cast<Score>(mp_score_win);
@@ -131,7 +135,7 @@ auto World::win(Team team) -> void {
 
 auto World::stalemate() -> void {
 	const auto rounds = ++m_roundsPlayed;
-	m_server.callIfDefined(Script::command({"on_stalemate"}));
+	m_server.callHook(ScriptHook::on_stalemate);
 	m_server.playGameSound(SoundId::stalemate());
 	m_server.writeServerChatMessage("Stalemate!");
 	this->resetRound();
@@ -154,7 +158,7 @@ auto World::startRound(float delay) -> void {
 	} else {
 		m_roundCountdown.start(mp_roundtime_tdm + delay);
 	}
-	m_server.callIfDefined(Script::command({"on_round_start"}));
+	m_server.callHook(ScriptHook::on_round_start);
 }
 
 auto World::update(float deltaTime) -> void {
@@ -189,7 +193,7 @@ auto World::update(float deltaTime) -> void {
 	this->updateCollisionMap();
 
 	// Update entities.
-	m_server.callIfDefined(Script::command({"on_pre_tick", util::toString(deltaTime)}));
+	m_server.callHook(ScriptHook::on_pre_tick, deltaTime);
 	this->updatePlayers(deltaTime);
 	this->updateSentryGuns(deltaTime);
 	this->updateProjectiles(deltaTime);
@@ -201,7 +205,7 @@ auto World::update(float deltaTime) -> void {
 	this->updatePayloadCarts(deltaTime);
 	this->updateRoundState(deltaTime);
 	this->updateTeamSwitchCountdown(deltaTime);
-	m_server.callIfDefined(Script::command({"on_post_tick", util::toString(deltaTime)}));
+	m_server.callHook(ScriptHook::on_post_tick, deltaTime);
 }
 
 auto World::getTickCount() const -> TickCount {
@@ -216,28 +220,17 @@ auto World::getRoundsPlayed() const -> int {
 	return m_roundsPlayed;
 }
 
-auto World::takeSnapshot(PlayerId id) const -> Snapshot {
-	auto snap = Snapshot{};
+auto World::takeSnapshot(std::optional<Team> viewerTeam, Snapshot& snap, std::vector<PlayerId>& playerIds) const -> void {
+	snap.clear();
 	snap.tickCount = m_tickCount;
 	snap.roundSecondsLeft = static_cast<decltype(snap.roundSecondsLeft)>(std::ceil(m_roundCountdown.getTimeLeft()));
+	playerIds.clear();
 
-	const auto it = m_players.find(id);
-	if (it == m_players.end()) {
-		return snap;
+	if (!viewerTeam) {
+		return;
 	}
 
-	auto&& [playerId, player] = *it;
-
-	snap.selfPlayer.position = player.position;
-	snap.selfPlayer.team = player.team;
-	snap.selfPlayer.skinTeam = (player.disguised) ? player.team.getOppositeTeam() : player.team;
-	snap.selfPlayer.alive = player.alive;
-	snap.selfPlayer.aimDirection = player.aimDirection;
-	snap.selfPlayer.playerClass = player.playerClass;
-	snap.selfPlayer.health = player.health;
-	snap.selfPlayer.primaryAmmo = player.primaryAmmo;
-	snap.selfPlayer.secondaryAmmo = player.secondaryAmmo;
-	snap.selfPlayer.hat = player.hat;
+	const auto team = *viewerTeam;
 
 	snap.flagInfo.reserve(m_flags.size());
 	snap.flags.reserve(m_flags.size());
@@ -272,7 +265,8 @@ auto World::takeSnapshot(PlayerId id) const -> Snapshot {
 	}
 
 	snap.playerInfo.reserve(m_players.size());
-	snap.players.reserve(m_players.size() - 1);
+	snap.players.reserve(m_players.size());
+	playerIds.reserve(m_players.size());
 	snap.corpses.reserve((m_players.size() + m_sentryGuns.size()) / 2);
 	for (const auto& [id, otherPlayer] : m_players) {
 		auto plyInfoEntity = ent::sh::PlayerInfo{};
@@ -280,7 +274,7 @@ auto World::takeSnapshot(PlayerId id) const -> Snapshot {
 		plyInfoEntity.team = otherPlayer.team;
 		plyInfoEntity.score = otherPlayer.score;
 		plyInfoEntity.name = otherPlayer.name;
-		if (player.team == Team::spectators() || otherPlayer.team == Team::spectators() || player.team == otherPlayer.team) {
+		if (team == Team::spectators() || otherPlayer.team == Team::spectators() || team == otherPlayer.team) {
 			plyInfoEntity.playerClass = otherPlayer.playerClass;
 		} else {
 			plyInfoEntity.playerClass = PlayerClass::none();
@@ -294,11 +288,11 @@ auto World::takeSnapshot(PlayerId id) const -> Snapshot {
 				corpseEntity.position = otherPlayer.position;
 				corpseEntity.team = otherPlayer.team;
 				snap.corpses.push_back(corpseEntity);
-			} else if (id != playerId) {
+			} else {
 				auto playerEntity = ent::sh::Player{};
 				playerEntity.position = otherPlayer.position;
 				playerEntity.team = otherPlayer.team;
-				if (otherPlayer.disguised && player.team != playerEntity.team) {
+				if (otherPlayer.disguised && team != playerEntity.team) {
 					playerEntity.team = playerEntity.team.getOppositeTeam();
 				}
 				playerEntity.aimDirection = otherPlayer.aimDirection;
@@ -306,6 +300,7 @@ auto World::takeSnapshot(PlayerId id) const -> Snapshot {
 				playerEntity.hat = otherPlayer.hat;
 				playerEntity.name = otherPlayer.name;
 				snap.players.push_back(std::move(playerEntity));
+				playerIds.push_back(id);
 			}
 		}
 	}
@@ -373,8 +368,98 @@ auto World::takeSnapshot(PlayerId id) const -> Snapshot {
 			snap.genericEntities.push_back(std::move(genericEntityEntity));
 		}
 	}
+}
 
-	return snap;
+auto World::takeSelfPlayer(PlayerId id) const -> std::optional<ent::sh::SelfPlayer> {
+	const auto it = m_players.find(id);
+	if (it == m_players.end()) {
+		return std::nullopt;
+	}
+
+	const auto& player = it->second;
+
+	auto selfPlayer = ent::sh::SelfPlayer{};
+	selfPlayer.position = player.position;
+	selfPlayer.team = player.team;
+	selfPlayer.skinTeam = (player.disguised) ? player.team.getOppositeTeam() : player.team;
+	selfPlayer.alive = player.alive;
+	selfPlayer.aimDirection = player.aimDirection;
+	selfPlayer.playerClass = player.playerClass;
+	selfPlayer.health = player.health;
+	selfPlayer.primaryAmmo = player.primaryAmmo;
+	selfPlayer.secondaryAmmo = player.secondaryAmmo;
+	selfPlayer.hat = player.hat;
+	return selfPlayer;
+}
+
+auto World::saveState() const -> State {
+	auto state = State{};
+	state.tickCount = m_tickCount;
+	state.roundCountdown = m_roundCountdown;
+	state.levelChangeCountdown = m_levelChangeCountdown;
+	state.teamSwitchCountdown = m_teamSwitchCountdown;
+	state.players = m_players;
+	state.projectiles = m_projectiles;
+	state.explosions = m_explosions;
+	state.sentryGuns = m_sentryGuns;
+	state.medkits = m_medkits;
+	state.ammopacks = m_ammopacks;
+	state.genericEntities = m_genericEntities;
+	state.flags = m_flags;
+	state.carts = m_carts;
+	state.teamSpawns = m_teamSpawns;
+	state.teamWins = m_teamWins;
+	state.mapTime = m_mapTime;
+	state.roundsPlayed = m_roundsPlayed;
+	state.awaitingLevelChange = m_awaitingLevelChange;
+	state.awaitingTeamSwitch = m_awaitingTeamSwitch;
+	return state;
+}
+
+auto World::restoreState(const State& state) -> void {
+	m_tickCount = state.tickCount;
+	m_roundCountdown = state.roundCountdown;
+	m_levelChangeCountdown = state.levelChangeCountdown;
+	m_teamSwitchCountdown = state.teamSwitchCountdown;
+	m_players = state.players;
+	m_projectiles = state.projectiles;
+	m_explosions = state.explosions;
+	m_sentryGuns = state.sentryGuns;
+	m_medkits = state.medkits;
+	m_ammopacks = state.ammopacks;
+	m_genericEntities = state.genericEntities;
+	m_flags = state.flags;
+	m_carts = state.carts;
+	m_teamSpawns = state.teamSpawns;
+	m_teamWins = state.teamWins;
+	m_mapTime = state.mapTime;
+	m_roundsPlayed = state.roundsPlayed;
+	m_awaitingLevelChange = state.awaitingLevelChange;
+	m_awaitingTeamSwitch = state.awaitingTeamSwitch;
+
+	// The collision map refers to entities by their position in the registries, which may have changed.
+	this->updateCollisionMap();
+}
+
+auto World::hashState() const -> util::CRC32 {
+	auto data = std::vector<std::byte>{};
+	auto stream = net::ByteOutputStream{data};
+
+	// Every team sees a different set of players and disguises, so take the snapshot of each one.
+	auto snap = Snapshot{};
+	auto playerIds = std::vector<PlayerId>{};
+	for (const auto team : {Team::red(), Team::blue(), Team::spectators()}) {
+		this->takeSnapshot(team, snap, playerIds);
+		stream << snap << playerIds;
+	}
+
+	for (const auto& [id, player] : m_players) {
+		if (const auto selfPlayer = this->takeSelfPlayer(id)) {
+			stream << id << *selfPlayer;
+		}
+	}
+	stream << m_mapTime << m_roundsPlayed;
+	return util::CRC32{util::Span<const std::byte>{data}};
 }
 
 auto World::createPlayer(Vec2 position, std::string name) -> PlayerId {
@@ -382,7 +467,7 @@ auto World::createPlayer(Vec2 position, std::string name) -> PlayerId {
 
 	it->second->position = position;
 	it->second->name = std::move(name);
-	m_server.callIfDefined(Script::command({"on_player_create", cmd::formatPlayerId(it->first)}));
+	m_server.callHook(ScriptHook::on_player_create, it->first);
 	if (!it->second) {
 		return PlayerRegistry::INVALID_KEY;
 	}
@@ -412,7 +497,7 @@ auto World::createProjectile(Vec2 position, Direction moveDirection, ProjectileT
 			++itPlayer->second.nStickies;
 		}
 	}
-	m_server.callIfDefined(Script::command({"on_projectile_create", cmd::formatProjectileId(it->first)}));
+	m_server.callHook(ScriptHook::on_projectile_create, it->first);
 	if (!it->second) {
 		return ProjectileRegistry::INVALID_KEY;
 	}
@@ -434,7 +519,7 @@ auto World::createExplosion(Vec2 position, Team team, PlayerId owner, Weapon wea
 	it->second->damage = damage;
 	it->second->hurtSound = hurtSound;
 	it->second->disappearTimer.start(disappearTime);
-	m_server.callIfDefined(Script::command({"on_explosion_create", cmd::formatExplosionId(it->first)}));
+	m_server.callHook(ScriptHook::on_explosion_create, it->first);
 	if (!it->second) {
 		return ExplosionRegistry::INVALID_KEY;
 	}
@@ -454,7 +539,7 @@ auto World::createSentryGun(Vec2 position, Team team, Health health, PlayerId ow
 	it->second->owner = owner;
 	it->second->shootTimer.setTimeLeft(mp_sentry_build_time);
 	it->second->alive = true;
-	m_server.callIfDefined(Script::command({"on_sentry_create", cmd::formatSentryGunId(it->first)}));
+	m_server.callHook(ScriptHook::on_sentry_create, it->first);
 	if (!it->second) {
 		return SentryGunRegistry::INVALID_KEY;
 	}
@@ -470,7 +555,7 @@ auto World::createMedkit(Vec2 position) -> World::MedkitId {
 
 	it->second->position = position;
 	it->second->alive = true;
-	m_server.callIfDefined(Script::command({"on_medkit_create", cmd::formatMedkitId(it->first)}));
+	m_server.callHook(ScriptHook::on_medkit_create, it->first);
 	if (!it->second) {
 		return MedkitRegistry::INVALID_KEY;
 	}
@@ -486,7 +571,7 @@ auto World::createAmmopack(Vec2 position) -> World::AmmopackId {
 
 	it->second->position = position;
 	it->second->alive = true;
-	m_server.callIfDefined(Script::command({"on_ammopack_create", cmd::formatAmmopackId(it->first)}));
+	m_server.callHook(ScriptHook::on_ammopack_create, it->first);
 	if (!it->second) {
 		return AmmopackRegistry::INVALID_KEY;
 	}
@@ -501,7 +586,7 @@ auto World::createGenericEntity(Vec2 position) -> World::GenericEntityId {
 	const auto it = m_genericEntities.stable_emplace_back();
 
 	it->second->position = position;
-	m_server.callIfDefined(Script::command({"on_ent_create", cmd::formatGenericEntityId(it->first)}));
+	m_server.callHook(ScriptHook::on_ent_create, it->first);
 	if (!it->second) {
 		return GenericEntityRegistry::INVALID_KEY;
 	}
@@ -515,7 +600,7 @@ auto World::createFlag(Vec2 position, Team team, std::string name) -> World::Fla
 	it->second->spawnPosition = position;
 	it->second->team = team;
 	it->second->name = std::move(name);
-	m_server.callIfDefined(Script::command({"on_flag_create", cmd::formatFlagId(it->first)}));
+	m_server.callHook(ScriptHook::on_flag_create, it->first);
 	if (!it->second) {
 		return FlagRegistry::INVALID_KEY;
 	}
@@ -531,7 +616,7 @@ auto World::createPayloadCart(Team team, std::vector<Vec2> track) -> World::Payl
 
 	it->second->team = team;
 	it->second->track = std::move(track);
-	m_server.callIfDefined(Script::command({"on_cart_create", cmd::formatPayloadCartId(it->first)}));
+	m_server.callHook(ScriptHook::on_cart_create, it->first);
 	if (!it->second) {
 		return PayloadCartRegistry::INVALID_KEY;
 	}
@@ -618,7 +703,7 @@ auto World::killAmmopack(AmmopackId id, float respawnTime) -> bool {
 
 auto World::deletePlayer(PlayerId id) -> bool {
 	if (const auto it = m_players.stable_find(id); it != m_players.stable_end()) {
-		m_server.callIfDefined(Script::command({"on_player_leave", cmd::formatPlayerId(it->first)}));
+		m_server.callHook(ScriptHook::on_player_leave, it->first);
 		this->cleanupSentryGuns(id);
 		this->cleanupProjectiles(id);
 		if (!it->second) {
@@ -1061,6 +1146,92 @@ auto World::getTeamWins(Team team) const -> Score {
 	return Score{0};
 }
 
+auto World::getVisibilityCache() const noexcept -> const VisibilityCache& {
+	return m_visibilityCache;
+}
+
+auto World::perceiveSelf(PlayerId id) const -> ent::sh::SelfPlayer {
+	auto self = ent::sh::SelfPlayer{};
+	if (const auto it = m_players.find(id); it != m_players.end()) {
+		const auto& player = it->second;
+		self.position = player.position;
+		self.team = player.team;
+		self.skinTeam = (player.disguised) ? player.team.getOppositeTeam() : player.team;
+		self.alive = player.alive;
+		self.aimDirection = player.aimDirection;
+		self.playerClass = player.playerClass;
+		self.health = player.health;
+		self.primaryAmmo = player.primaryAmmo;
+		self.secondaryAmmo = player.secondaryAmmo;
+		self.hat = player.hat;
+	}
+	return self;
+}
+
+auto World::perceivePlayersInRange(PlayerId observer, Vec2 position, Vec2::Length range, std::vector<PerceivedPlayer>& players) const
+	-> void {
+	players.clear();
+	const auto observerIt = m_players.find(observer);
+	if (observerIt == m_players.end()) {
+		return;
+	}
+	const auto observerTeam = observerIt->second.team;
+	const auto rangeSquared = static_cast<int>(range) * static_cast<int>(range);
+	for (const auto& [id, player] : m_players) {
+		if (id == observer || !player.alive || player.team == Team::spectators() ||
+		    Vec2::distanceSquared(player.position, position) > rangeSquared) {
+			continue;
+		}
+		const auto team = (player.disguised && player.team != observerTeam) ? player.team.getOppositeTeam() : player.team;
+		players.push_back(PerceivedPlayer{id, player.position, team, player.playerClass});
+	}
+}
+
+auto World::perceiveSentryGunsInRange(Vec2 position, Vec2::Length range, std::vector<PerceivedObject>& sentryGuns) const -> void {
+	sentryGuns.clear();
+	const auto rangeSquared = static_cast<int>(range) * static_cast<int>(range);
+	for (const auto& [id, sentryGun] : m_sentryGuns) {
+		if (sentryGun.alive && Vec2::distanceSquared(sentryGun.position, position) <= rangeSquared) {
+			sentryGuns.push_back(PerceivedObject{sentryGun.position, sentryGun.team, sentryGun.owner});
+		}
+	}
+}
+
+auto World::perceiveFlags(std::vector<PerceivedObject>& flags) const -> void {
+	flags.clear();
+	for (const auto& [id, flag] : m_flags) {
+		flags.push_back(PerceivedObject{flag.position, flag.team, PLAYER_ID_UNCONNECTED});
+	}
+}
+
+auto World::perceivePayloadCarts(std::vector<PerceivedObject>& carts) const -> void {
+	carts.clear();
+	for (const auto& [id, cart] : m_carts) {
+		if (cart.currentTrackIndex < cart.track.size()) {
+			carts.push_back(PerceivedObject{cart.track[cart.currentTrackIndex], cart.team, PLAYER_ID_UNCONNECTED});
+		}
+	}
+}
+
+auto World::perceiveClosestMedkit(Vec2 position) const -> std::optional<Vec2> {
+	const auto aliveMedkits = m_medkits | util::filter([](const auto& kv) { return kv.second.alive; }) |
+	                          util::transform([](const auto& kv) { return kv.second.position; });
+	if (const auto closestMedkit = util::findClosestDistanceSquared(aliveMedkits, position); closestMedkit.first != aliveMedkits.end()) {
+		return *closestMedkit.first;
+	}
+	return std::nullopt;
+}
+
+auto World::perceiveOwnedSentryGun(PlayerId owner) const -> bool {
+	return util::anyOf(m_sentryGuns, [&](const auto& kv) { return kv.second.alive && kv.second.owner == owner; });
+}
+
+auto World::perceiveOwnedSticky(PlayerId owner, const Rect& area) const -> bool {
+	return util::anyOf(m_projectiles, [&](const auto& kv) {
+		return kv.second.owner == owner && kv.second.type == ProjectileType::sticky() && area.contains(kv.second.position);
+	});
+}
+
 auto World::updateCollisionMap() -> void {
 	m_collisionMap.clear();
 	m_collisionMap.reserve(m_players.size() + m_projectiles.size() + m_explosions.size() * 9 + m_sentryGuns.size() + m_medkits.size() +
@@ -1206,20 +1377,21 @@ auto World::updateSentryGun(SentryGunIterator it, float deltaTime) -> World::Sen
 		return ++it;
 	}
 
+	// Reject targets that are out of range before doing the more expensive line of sight check.
+	const auto range = static_cast<Vec2::Length>(mp_sentry_range);
 	const auto isPotentialSentryGunTarget = [&](const auto& kv) {
 		return kv.second->alive && kv.second->team != it->second->team && !kv.second->disguised &&
-		       m_map.lineOfSight(it->second->position, kv.second->position);
+		       Vec2::distanceSquared(kv.second->position, it->second->position) <= range * range &&
+		       m_visibilityCache.lineOfSight(it->second->position, kv.second->position);
 	};
 	const auto visibleEnemies = m_players.stable() | util::filter(isPotentialSentryGunTarget) |
-	                            util::transform([](const auto& kv) { return *kv.second; });
+	                            util::transform([](const auto& kv) -> const ent::sv::Player& { return *kv.second; });
 	const auto closestEnemy = ent::findClosestDistanceSquared(visibleEnemies, it->second->position);
 	const auto shouldShoot = [&] {
 		if (closestEnemy.first != visibleEnemies.end()) {
-			if (const auto range = static_cast<Vec2::Length>(mp_sentry_range); closestEnemy.second <= range * range) {
-				it->second->aimDirection = Direction{closestEnemy.first->position - it->second->position};
-				if (it->second->aimDirection.isAny()) {
-					return true;
-				}
+			it->second->aimDirection = Direction{(*closestEnemy.first).position - it->second->position};
+			if (it->second->aimDirection.isAny()) {
+				return true;
 			}
 		}
 		return false;
@@ -1403,7 +1575,7 @@ auto World::updatePayloadCart(PayloadCartIterator it, float deltaTime) -> World:
 	     loops > 0;
 	     --loops) {
 		m_server.playWorldSound(SoundId::push_cart(), it->second->track[it->second->currentTrackIndex]);
-		m_server.callIfDefined(Script::command({"on_push_cart", cmd::formatPayloadCartId(it->first)}));
+		m_server.callHook(ScriptHook::on_push_cart, it->first);
 		if (!it->second) {
 			return ++it;
 		}
@@ -1424,7 +1596,7 @@ auto World::updatePayloadCart(PayloadCartIterator it, float deltaTime) -> World:
 					m_server.awardPlayerPoints(itPushingPlayer->first, itPushingPlayer->second->name, points);
 				}
 			}
-			m_server.callIfDefined(Script::command({"on_capture_cart", cmd::formatPayloadCartId(it->first)}));
+			m_server.callHook(ScriptHook::on_capture_cart, it->first);
 			this->win(team);
 			break;
 		}
@@ -2337,7 +2509,7 @@ auto World::collide(PlayerIterator itPlayer, MedkitIterator itMedkit) -> void {
 		itMedkit->second->alive = false;
 		itPlayer->second->health = itPlayer->second->playerClass.getHealth();
 		m_server.playWorldSound(SoundId::medkit_collect(), itMedkit->second->position, itPlayer->first);
-		m_server.callIfDefined(Script::command({"on_pickup_medkit", cmd::formatMedkitId(itMedkit->first), cmd::formatPlayerId(itPlayer->first)}));
+		m_server.callHook(ScriptHook::on_pickup_medkit, itMedkit->first, itPlayer->first);
 	}
 }
 
@@ -2351,7 +2523,7 @@ auto World::collide(PlayerIterator itPlayer, AmmopackIterator itAmmopack) -> voi
 		itPlayer->second->primaryAmmo = primaryMaxAmmo;
 		itPlayer->second->secondaryAmmo = secondaryMaxAmmo;
 		m_server.playWorldSound(SoundId::player_spawn(), itAmmopack->second->position, itPlayer->first);
-		m_server.callIfDefined(Script::command({"on_pickup_ammopack", cmd::formatAmmopackId(itAmmopack->first), cmd::formatPlayerId(itPlayer->first)}));
+		m_server.callHook(ScriptHook::on_pickup_ammopack, itAmmopack->first, itPlayer->first);
 	}
 }
 
@@ -2482,56 +2654,47 @@ auto World::collide(AmmopackIterator itAmmopack, GenericEntityIterator itGeneric
 
 auto World::collide(GenericEntityIterator itGenericEntity, PlayerIterator itPlayer) -> void {
 	assert(this->canCollide(itGenericEntity, itPlayer));
-	m_server.callIfDefined(
-		Script::command({"on_collide_ent_player", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatPlayerId(itPlayer->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_player, itGenericEntity->first, itPlayer->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, ProjectileIterator itProjectile) -> void {
 	assert(this->canCollide(itGenericEntity, itProjectile));
-	m_server.callIfDefined(Script::command(
-		{"on_collide_ent_projectile", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatProjectileId(itProjectile->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_projectile, itGenericEntity->first, itProjectile->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, ExplosionIterator itExplosion) -> void {
 	assert(this->canCollide(itGenericEntity, itExplosion));
-	m_server.callIfDefined(Script::command(
-		{"on_collide_ent_explosion", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatExplosionId(itExplosion->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_explosion, itGenericEntity->first, itExplosion->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, SentryGunIterator itSentryGun) -> void {
 	assert(this->canCollide(itGenericEntity, itSentryGun));
-	m_server.callIfDefined(Script::command(
-		{"on_collide_ent_sentry", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatSentryGunId(itSentryGun->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_sentry, itGenericEntity->first, itSentryGun->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, MedkitIterator itMedkit) -> void {
 	assert(this->canCollide(itGenericEntity, itMedkit));
-	m_server.callIfDefined(
-		Script::command({"on_collide_ent_medkit", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatMedkitId(itMedkit->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_medkit, itGenericEntity->first, itMedkit->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, AmmopackIterator itAmmopack) -> void {
 	assert(this->canCollide(itGenericEntity, itAmmopack));
-	m_server.callIfDefined(Script::command(
-		{"on_collide_ent_ammopack", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatAmmopackId(itAmmopack->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_ammopack, itGenericEntity->first, itAmmopack->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntityA, GenericEntityIterator itGenericEntityB) -> void {
 	assert(this->canCollide(itGenericEntityA, itGenericEntityB));
-	m_server.callIfDefined(Script::command(
-		{"on_collide_ent_ent", cmd::formatGenericEntityId(itGenericEntityA->first), cmd::formatGenericEntityId(itGenericEntityB->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_ent, itGenericEntityA->first, itGenericEntityB->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, FlagIterator itFlag) -> void {
 	assert(this->canCollide(itGenericEntity, itFlag));
-	m_server.callIfDefined(
-		Script::command({"on_collide_ent_flag", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatFlagId(itFlag->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_flag, itGenericEntity->first, itFlag->first);
 }
 
 auto World::collide(GenericEntityIterator itGenericEntity, PayloadCartIterator itCart) -> void {
 	assert(this->canCollide(itGenericEntity, itCart));
-	m_server.callIfDefined(
-		Script::command({"on_collide_ent_cart", cmd::formatGenericEntityId(itGenericEntity->first), cmd::formatPayloadCartId(itCart->first)}));
+	m_server.callHook(ScriptHook::on_collide_ent_cart, itGenericEntity->first, itCart->first);
 }
 
 auto World::collide(FlagIterator itFlag, PlayerIterator itPlayer) -> void {
@@ -2796,8 +2959,7 @@ auto World::killPlayer(PlayerIterator it, bool announce, PlayerIterator killer,
 			}
 		}
 
-		m_server.callIfDefined(Script::command(
-			{"on_kill_player", cmd::formatPlayerId(it->first), cmd::formatPlayerId((hasKiller) ? killer->first : PlayerRegistry::INVALID_KEY)}));
+		m_server.callHook(ScriptHook::on_kill_player, it->first, (hasKiller) ? killer->first : PlayerRegistry::INVALID_KEY);
 	}
 
 	// Set respawn timer.
@@ -2837,8 +2999,7 @@ auto World::killSentryGun(SentryGunIterator it, PlayerIterator killer) -> void {
 			killer->second->score += points;
 			m_server.awardPlayerPoints(killer->first, killer->second->name, points);
 		}
-		m_server.callIfDefined(Script::command(
-			{"on_kill_sentry", cmd::formatSentryGunId(it->first), cmd::formatPlayerId((hasKiller) ? killer->first : PlayerRegistry::INVALID_KEY)}));
+		m_server.callHook(ScriptHook::on_kill_sentry, it->first, (hasKiller) ? killer->first : PlayerRegistry::INVALID_KEY);
 	}
 }
 
@@ -3170,8 +3331,7 @@ auto World::stepGenericEntity(GenericEntityIterator it, int steps) -> void {
 			} else if (canMoveVertical && !canMoveHorizontal) {
 				normal.y = 0;
 			}
-			m_server.callIfDefined(Script::command(
-				{"on_collide_ent_world", cmd::formatGenericEntityId(it->first), util::toString(normal.x), util::toString(normal.y)}));
+			m_server.callHook(ScriptHook::on_collide_ent_world, it->first, normal.x, normal.y);
 			if (!it->second) {
 				return;
 			}
@@ -3196,8 +3356,7 @@ auto World::stepGenericEntity(GenericEntityIterator it, int steps) -> void {
 			this->stepGenericEntity(it, steps);
 			return;
 		}
-		m_server.callIfDefined(
-			Script::command({"on_ent_step", cmd::formatGenericEntityId(it->first), util::toString(position.x), util::toString(position.y)}));
+		m_server.callHook(ScriptHook::on_ent_step, it->first, position.x, position.y);
 	}
 }
 
@@ -3279,7 +3438,7 @@ auto World::playerTeamSelect(PlayerIterator it, Team team, PlayerClass playerCla
 		return;
 	}
 
-	m_server.callIfDefined(Script::command({"on_team_select", cmd::formatPlayerId(it->first)}));
+	m_server.callHook(ScriptHook::on_team_select, it->first);
 	if (!it->second) {
 		return;
 	}
@@ -3324,7 +3483,7 @@ auto World::spawnPlayer(PlayerIterator it) -> void {
 	it->second->blastJumpInterval = 0.0f;
 	m_server.playWorldSound(SoundId::player_spawn(), it->second->position, it->first);
 	this->removePlayerStickies(it);
-	m_server.callIfDefined(Script::command({"on_player_spawn", cmd::formatPlayerId(it->first)}));
+	m_server.callHook(ScriptHook::on_player_spawn, it->first);
 }
 
 auto World::resupplyPlayer(PlayerIterator it) -> void {
@@ -3338,7 +3497,7 @@ auto World::resupplyPlayer(PlayerIterator it) -> void {
 		it->second->primaryAmmo = primaryMaxAmmo;
 		it->second->secondaryAmmo = secondaryMaxAmmo;
 		m_server.playWorldSound(SoundId::resupply(), it->second->position, it->first);
-		m_server.callIfDefined(Script::command({"on_resupply", cmd::formatPlayerId(it->first)}));
+		m_server.callHook(ScriptHook::on_resupply, it->first);
 	}
 }
 
@@ -3413,7 +3572,7 @@ auto World::spawnMedkit(MedkitIterator it) -> void {
 	it->second->respawnCountdown.reset();
 	it->second->alive = true;
 	m_server.playWorldSound(SoundId::medkit_spawn(), it->second->position);
-	m_server.callIfDefined(Script::command({"on_medkit_spawn", cmd::formatMedkitId(it->first)}));
+	m_server.callHook(ScriptHook::on_medkit_spawn, it->first);
 	if (it->second && it->second->alive) {
 		this->checkCollisions(it);
 	}
@@ -3425,7 +3584,7 @@ auto World::spawnAmmopack(AmmopackIterator it) -> void {
 	it->second->respawnCountdown.reset();
 	it->second->alive = true;
 	m_server.playWorldSound(SoundId::medkit_spawn(), it->second->position);
-	m_server.callIfDefined(Script::command({"on_ammopack_spawn", cmd::formatAmmopackId(it->first)}));
+	m_server.callHook(ScriptHook::on_ammopack_spawn, it->first);
 	if (it->second && it->second->alive) {
 		this->checkCollisions(it);
 	}
@@ -3442,7 +3601,7 @@ auto World::pickupFlag(FlagIterator it, PlayerIterator carrier) -> void {
 	carrier->second->disguised = false;
 	m_server.playTeamSound(SoundId::we_picked_intel(), SoundId::they_picked_intel(), carrier->second->team);
 	m_server.writeServerChatMessage(fmt::format("{} picked up the {}!", carrier->second->name, it->second->name));
-	m_server.callIfDefined(Script::command({"on_pickup_flag", cmd::formatFlagId(it->first), cmd::formatPlayerId(carrier->first)}));
+	m_server.callHook(ScriptHook::on_pickup_flag, it->first, carrier->first);
 }
 
 auto World::dropFlag(FlagIterator it, PlayerIterator carrier) -> void {
@@ -3460,7 +3619,7 @@ auto World::dropFlag(FlagIterator it, PlayerIterator carrier) -> void {
 	}
 	m_server.playTeamSound(SoundId::we_dropped_intel(), SoundId::they_dropped_intel(), carrier->second->team);
 	m_server.writeServerChatMessage(fmt::format("{} dropped the {}!", carrier->second->name, it->second->name));
-	m_server.callIfDefined(Script::command({"on_drop_flag", cmd::formatFlagId(it->first), cmd::formatPlayerId(carrier->first)}));
+	m_server.callHook(ScriptHook::on_drop_flag, it->first, carrier->first);
 }
 
 auto World::returnFlag(FlagIterator it, bool announce) -> void {
@@ -3478,7 +3637,7 @@ auto World::returnFlag(FlagIterator it, bool announce) -> void {
 	if (announce) {
 		m_server.playTeamSound(SoundId::we_returned_intel(), SoundId::they_returned_intel(), it->second->team);
 		m_server.writeServerChatMessage(fmt::format("{} has returned!", it->second->name));
-		m_server.callIfDefined(Script::command({"on_return_flag", cmd::formatFlagId(it->first)}));
+		m_server.callHook(ScriptHook::on_return_flag, it->first);
 	}
 }
 
@@ -3497,7 +3656,7 @@ auto World::captureFlag(FlagIterator it, PlayerIterator carrier) -> void {
 		const auto points = static_cast<Score>(mp_score_objective);
 		carrier->second->score += points;
 		++itFlag->second->score;
-		m_server.callIfDefined(Script::command({"on_capture_flag", cmd::formatFlagId(it->first), cmd::formatPlayerId(carrier->first)}));
+		m_server.callHook(ScriptHook::on_capture_flag, it->first, carrier->first);
 		if (!itFlag->second || !it->second || !carrier->second) {
 			return;
 		}
@@ -2,6 +2,7 @@
 #define AF2_SERVER_WORLD_HPP
 
 #include "../../utilities/countdown.hpp" // util::Countdown, util::CountdownLoop
+#include "../../utilities/crc.hpp"       // util::CRC32
 #include "../../utilities/registry.hpp"  // util::Registry
 #include "../data/ammo.hpp"              // Ammo
 #include "../data/hat.hpp"               // Hat
@@ -18,6 +19,7 @@
 #include "../data/weapon.hpp"            // Weapon
 #include "../shared/snapshot.hpp"        // Snapshot
 #include "entities.hpp"                  // ent::sv::...
+#include "visibility_cache.hpp"          // VisibilityCache
 
 #include <cstddef>       // std::size_t
 #include <cstdint>       // std::uint32_t
@@ -48,6 +50,9 @@ public:
 	using FlagId = std::uint32_t;
 	using PayloadCartId = std::uint32_t;
 
+	// Everything about the world that changes from tick to tick, so that the same ticks can be run again from the same start.
+	struct State;
+
 	World(const Map& map, GameServer& server);
 
 	auto reset() -> void;
@@ -62,7 +67,17 @@ public:
 	[[nodiscard]] auto getTickCount() const -> TickCount;
 	[[nodiscard]] auto getMapTime() const -> float;
 	[[nodiscard]] auto getRoundsPlayed() const -> int;
-	[[nodiscard]] auto takeSnapshot(PlayerId id) const -> Snapshot;
+	// Take the part of a snapshot that is the same for every player on the given team, without the self player. The players list
+	// contains every visible player, and the ids of those players are put in playerIds in the same order. Without a team, only the
+	// round state is taken, as for clients that don't have a player.
+	auto takeSnapshot(std::optional<Team> viewerTeam, Snapshot& snap, std::vector<PlayerId>& playerIds) const -> void;
+	[[nodiscard]] auto takeSelfPlayer(PlayerId id) const -> std::optional<ent::sh::SelfPlayer>;
+
+	[[nodiscard]] auto saveState() const -> State;
+	auto restoreState(const State& state) -> void;
+
+	// Checksum of the world as seen by every team and every player, for comparing the results of running the same ticks twice.
+	[[nodiscard]] auto hashState() const -> util::CRC32;
 
 	auto createPlayer(Vec2 position, std::string name) -> PlayerId;
 	auto createProjectile(Vec2 position, Direction moveDirection, ProjectileType type, Team team, PlayerId owner, Weapon weapon,
@@ -185,6 +200,34 @@ public:
 
 	[[nodiscard]] auto getTeamWins(Team team) const -> Score;
 
+	[[nodiscard]] auto getVisibilityCache() const noexcept -> const VisibilityCache&;
+
+	// Bot perception.
+	// These give bots the same view of the world as the snapshot that a client with the same player id would receive,
+	// but only for the parts they ask about, and without copying any names or building the full snapshot.
+	// Disguised enemy spies are reported as being on the observer's team.
+	struct PerceivedPlayer final {
+		PlayerId id;
+		Vec2 position;
+		Team team;
+		PlayerClass playerClass;
+	};
+
+	struct PerceivedObject final {
+		Vec2 position;
+		Team team;
+		PlayerId owner;
+	};
+
+	[[nodiscard]] auto perceiveSelf(PlayerId id) const -> ent::sh::SelfPlayer;
+	auto perceivePlayersInRange(PlayerId observer, Vec2 position, Vec2::Length range, std::vector<PerceivedPlayer>& players) const -> void;
+	auto perceiveSentryGunsInRange(Vec2 position, Vec2::Length range, std::vector<PerceivedObject>& sentryGuns) const -> void;
+	auto perceiveFlags(std::vector<PerceivedObject>& flags) const -> void;
+	auto perceivePayloadCarts(std::vector<PerceivedObject>& carts) const -> void;
+	[[nodiscard]] auto perceiveClosestMedkit(Vec2 position) const -> std::optional<Vec2>;
+	[[nodiscard]] auto perceiveOwnedSentryGun(PlayerId owner) const -> bool;
+	[[nodiscard]] auto perceiveOwnedSticky(PlayerId owner, const Rect& area) const -> bool;
+
 private:
 	static_assert(sizeof(PlayerId) >= 4, "Player id type should be at least 32 bits wide to avoid overflow.");
 	static_assert(sizeof(ProjectileId) >= 4, "Projectile id type should be at least 32 bits wide to avoid overflow.");
@@ -429,10 +472,33 @@ private:
 	TeamSpawns m_teamSpawns{};
 	TeamPoints m_teamWins{};
 	CollisionMap m_collisionMap{};
+	VisibilityCache m_visibilityCache;
 	float m_mapTime = 0.0f;
 	int m_roundsPlayed = 0;
 	bool m_awaitingLevelChange = false;
 	bool m_awaitingTeamSwitch = false;
 };
 
+struct World::State final {
+	TickCount tickCount = 0;
+	util::Countdown<float> roundCountdown{};
+	util::Countdown<float> levelChangeCountdown{};
+	util::Countdown<float> teamSwitchCountdown{};
+	PlayerRegistry players{};
+	ProjectileRegistry projectiles{};
+	ExplosionRegistry explosions{};
+	SentryGunRegistry sentryGuns{};
+	MedkitRegistry medkits{};
+	AmmopackRegistry ammopacks{};
+	GenericEntityRegistry genericEntities{};
+	FlagRegistry flags{};
+	PayloadCartRegistry carts{};
+	TeamSpawns teamSpawns{};
+	TeamPoints teamWins{};
+	float mapTime = 0.0f;
+	int roundsPlayed = 0;
+	bool awaitingLevelChange = false;
+	bool awaitingTeamSwitch = false;
+};
+
 #endif
@@ -290,28 +290,30 @@ struct PlaySoundPositionalReliable final : net::ReliableMessage<PlaySoundPositio
 template <net::MessageDirection DIR>
 struct ResourceDownloadPart final : net::SecretMessage<ResourceDownloadPart<DIR>, DIR> {
 	util::CRC32 nameHash{};
+	std::uint64_t offset = 0;
 	net::String<DIR> part{};
 
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie(nameHash, part);
+		return std::tie(nameHash, offset, part);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie(nameHash, part);
+		return std::tie(nameHash, offset, part);
 	}
 };
 
 template <net::MessageDirection DIR>
 struct ResourceDownloadLast final : net::SecretMessage<ResourceDownloadLast<DIR>, DIR> {
 	util::CRC32 nameHash{};
+	std::uint64_t offset = 0;
 	net::String<DIR> part{};
 
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie(nameHash, part);
+		return std::tie(nameHash, offset, part);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie(nameHash, part);
+		return std::tie(nameHash, offset, part);
 	}
 };
 
@@ -467,6 +469,23 @@ struct InventoryEquipHat final : net::SecretMessage<InventoryEquipHat<DIR>, DIR>
 	}
 };
 
+/**
+ * Resource prefetch message.
+ * Sent after joining to announce the resources of the next map, so that the client can download them in the background.
+ */
+template <net::MessageDirection DIR>
+struct ResourcePrefetch final : net::SecretMessage<ResourcePrefetch<DIR>, DIR> {
+	net::List<ResourceInfo, DIR> resources{};
+
+	[[nodiscard]] constexpr auto tie() noexcept {
+		return std::tie(resources);
+	}
+
+	[[nodiscard]] constexpr auto tie() const noexcept {
+		return std::tie(resources);
+	}
+};
+
 namespace in {
 
 using ServerInfo = msg::cl::ServerInfo<net::MessageDirection::INPUT>;
@@ -498,6 +517,7 @@ using RemoteConsoleOutput = msg::cl::RemoteConsoleOutput<net::MessageDirection::
 using RemoteConsoleDone = msg::cl::RemoteConsoleDone<net::MessageDirection::INPUT>;
 using RemoteConsoleLoggedOut = msg::cl::RemoteConsoleLoggedOut<net::MessageDirection::INPUT>;
 using InventoryEquipHat = msg::cl::InventoryEquipHat<net::MessageDirection::INPUT>;
+using ResourcePrefetch = msg::cl::ResourcePrefetch<net::MessageDirection::INPUT>;
 
 } // namespace in
 
@@ -532,6 +552,7 @@ using RemoteConsoleOutput = msg::cl::RemoteConsoleOutput<net::MessageDirection::
 using RemoteConsoleDone = msg::cl::RemoteConsoleDone<net::MessageDirection::OUTPUT>;
 using RemoteConsoleLoggedOut = msg::cl::RemoteConsoleLoggedOut<net::MessageDirection::OUTPUT>;
 using InventoryEquipHat = msg::cl::InventoryEquipHat<net::MessageDirection::OUTPUT>;
+using ResourcePrefetch = msg::cl::ResourcePrefetch<net::MessageDirection::OUTPUT>;
 
 } // namespace out
 
@@ -568,7 +589,8 @@ using GameClientMessages = util::TypeList<       //
 	msg::cl::RemoteConsoleOutput<DIR>,           // 25
 	msg::cl::RemoteConsoleDone<DIR>,             // 26
 	msg::cl::RemoteConsoleLoggedOut<DIR>,        // 27
-	msg::cl::InventoryEquipHat<DIR>              // 28
+	msg::cl::InventoryEquipHat<DIR>,             // 28
+	msg::cl::ResourcePrefetch<DIR>               // 29
 	>;
 
 using GameClientInputMessages = GameClientMessages<net::MessageDirection::INPUT>;
@@ -15,8 +15,9 @@
 #include "../data/tick_count.hpp"           // TickCount
 #include "../data/tickrate.hpp"             // Tickrate
 
-#include <string> // std::string
-#include <tuple>  // std::tie
+#include <cstdint> // std::uint64_t
+#include <string>  // std::string
+#include <tuple>   // std::tie
 
 namespace msg {
 namespace sv {
@@ -121,13 +122,14 @@ struct TeamSelect final : net::SecretMessage<TeamSelect<DIR>, DIR> {
 template <net::MessageDirection DIR>
 struct ResourceDownloadRequest final : net::SecretMessage<ResourceDownloadRequest<DIR>, DIR> {
 	util::CRC32 nameHash{};
+	std::uint64_t offset = 0; // Byte offset to resume an earlier download from.
 
 	[[nodiscard]] constexpr auto tie() noexcept {
-		return std::tie(nameHash);
+		return std::tie(nameHash, offset);
 	}
 
 	[[nodiscard]] constexpr auto tie() const noexcept {
-		return std::tie(nameHash);
+		return std::tie(nameHash, offset);
 	}
 };
 
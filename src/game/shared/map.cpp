@@ -8,6 +8,7 @@
 #include <cstdint>       // std::uint32_t
 #include <optional>      // std::optional, std::nullopt
 #include <queue>         // std::priority_queue
+#include <type_traits>   // std::make_unsigned_t
 #include <unordered_map> // std::unordered_map
 #include <unordered_set> // std::unordered_set
 
@@ -16,6 +17,8 @@ namespace {
 constexpr auto COST_STRAIGHT = std::uint32_t{1000};
 constexpr auto COST_DIAGONAL = std::uint32_t{1414};
 
+constexpr auto OPAQUE_WORD_BITS = std::size_t{64};
+
 auto parseSubstr(std::string_view str, std::string_view beginTag, std::string_view endTag) -> std::string_view {
 	const auto i = str.find(beginTag);
 	if (i == std::string_view::npos) {
@@ -91,6 +94,19 @@ auto makePath(const std::unordered_set<Vec2>& nodes, Vec2 start) -> std::vector<
 	return path;
 }
 
+struct PathNode final {
+	constexpr PathNode(std::uint32_t cost, Vec2 position) noexcept
+		: cost(cost)
+		, position(position) {}
+
+	[[nodiscard]] constexpr auto operator<(const PathNode& other) const noexcept -> bool {
+		return cost > other.cost;
+	}
+
+	std::uint32_t cost;
+	Vec2 position;
+};
+
 template <typename Func>
 auto forEachNonSolidNeighbor(const Map& map, Vec2 p, bool red, bool blue, Func&& callback) -> void {
 	if (const auto up = Vec2{p.x, p.y - 1}; !map.isSolid(up, red, blue, Direction::up())) {
@@ -124,6 +140,8 @@ auto forEachNonSolidNeighbor(const Map& map, Vec2 p, bool red, bool blue, Func&&
 
 auto Map::unLoad() -> void {
 	m_matrix.clear();
+	m_opaqueRows.clear();
+	m_opaqueRowWords = 0;
 	m_name.clear();
 	m_redCartSpawn = {};
 	m_blueCartSpawn = {};
@@ -241,6 +259,7 @@ auto Map::load(std::string name, std::string_view str) -> bool {
 		m_blueCartPath = makePath(blueTrack, m_blueCartSpawn);
 	}
 
+	this->updateOpaqueRows();
 	return true;
 }
 
@@ -398,48 +417,61 @@ auto Map::isSolid(Vec2 p, bool red, bool blue, Direction moveDirection) const no
 	return false;
 }
 
+auto Map::updateOpaqueRows() -> void {
+	const auto width = m_matrix.getWidth();
+	const auto height = m_matrix.getHeight();
+	m_opaqueRowWords = (width + OPAQUE_WORD_BITS - 1) / OPAQUE_WORD_BITS;
+	m_opaqueRows.assign(m_opaqueRowWords * height, OpaqueWord{0});
+	for (auto y = std::size_t{0}; y < height; ++y) {
+		for (auto x = std::size_t{0}; x < width; ++x) {
+			if (Map::isSolidChar(m_matrix.get(x, y))) {
+				m_opaqueRows[y * m_opaqueRowWords + x / OPAQUE_WORD_BITS] |= OpaqueWord{1} << (x % OPAQUE_WORD_BITS);
+			}
+		}
+	}
+}
+
+auto Map::isOpaque(Vec2 p) const noexcept -> bool {
+	const auto x = static_cast<std::size_t>(static_cast<std::make_unsigned_t<Vec2::Length>>(p.x));
+	const auto y = static_cast<std::size_t>(static_cast<std::make_unsigned_t<Vec2::Length>>(p.y));
+	if (x >= m_matrix.getWidth() || y >= m_matrix.getHeight()) {
+		return true;
+	}
+	const auto& word = m_opaqueRows[y * m_opaqueRowWords + x / OPAQUE_WORD_BITS];
+	return ((word >> (x % OPAQUE_WORD_BITS)) & OpaqueWord{1}) != 0;
+}
+
 auto Map::lineOfSight(Vec2 p1, Vec2 p2) const noexcept -> bool {
+	// Bresenham's line algorithm on the packed opacity rows.
+	// The steps are computed arithmetically so that the only branches in the loop are the exit conditions.
 	const auto dx = std::abs(p2.x - p1.x);
 	const auto dy = std::abs(p2.y - p1.y);
-	const auto sx = (p1.x < p2.x) ? Vec2::Length{1} : Vec2::Length{-1};
-	const auto sy = (p1.y < p2.y) ? Vec2::Length{1} : Vec2::Length{-1};
+	const auto sx = (p1.x < p2.x) ? 1 : -1;
+	const auto sy = (p1.y < p2.y) ? 1 : -1;
 
+	auto x = static_cast<int>(p1.x);
+	auto y = static_cast<int>(p1.y);
+	const auto x2 = static_cast<int>(p2.x);
+	const auto y2 = static_cast<int>(p2.y);
 	auto err = ((dx > dy) ? dx : -dy) / 2;
 	while (true) {
-		if (Map::isSolidChar(this->get(p1))) {
+		if (this->isOpaque(Vec2{static_cast<Vec2::Length>(x), static_cast<Vec2::Length>(y)})) {
 			return false;
 		}
-		if (p1 == p2) {
+		if (x == x2 && y == y2) {
 			break;
 		}
-		const auto error = err;
-		if (error > -dx) {
-			err -= dy;
-			p1.x = static_cast<Vec2::Length>(p1.x + sx);
-		}
-		if (error < dy) {
-			err += dx;
-			p1.y = static_cast<Vec2::Length>(p1.y + sy);
-		}
+		const auto stepX = static_cast<int>(err > -dx);
+		const auto stepY = static_cast<int>(err < dy);
+		err += stepY * dx - stepX * dy;
+		x += stepX * sx;
+		y += stepY * sy;
 	}
 	return true;
 }
 
 auto Map::findPath(Vec2 start, Vec2 destination, bool red, bool blue) const -> std::vector<Vec2> {
 	// Use A* pathfinding algorithm to find a path to the destination.
-	struct Node final {
-		constexpr Node(std::uint32_t cost, Vec2 position) noexcept
-			: cost(cost)
-			, position(position) {}
-
-		[[nodiscard]] constexpr auto operator<(const Node& other) const noexcept -> bool {
-			return cost > other.cost;
-		}
-
-		std::uint32_t cost;
-		Vec2 position;
-	};
-
 	// Heuristic function for A*. Uses Manhattan distance.
 	const auto heuristic = [destination](Vec2 p) {
 		return (std::abs(p.x - destination.x) + std::abs(p.y - destination.y)) * COST_STRAIGHT;
@@ -447,7 +479,7 @@ auto Map::findPath(Vec2 start, Vec2 destination, bool red, bool blue) const -> s
 
 	auto cost = std::unordered_map<Vec2, std::uint32_t>{{start, 0}};
 	auto previous = std::unordered_map<Vec2, Vec2>{{start, start}};
-	auto queue = std::priority_queue<Node>{};
+	auto queue = std::priority_queue<PathNode>{};
 	queue.emplace(0, start);
 
 	while (!queue.empty()) {
@@ -485,3 +517,87 @@ auto Map::findPath(Vec2 start, Vec2 destination, bool red, bool blue) const -> s
 	}
 	return path;
 }
+
+auto Map::repairPath(Vec2 start, util::Span<const Vec2> path, bool red, bool blue, std::size_t maxExpansions) const -> std::vector<Vec2> {
+	// Use a bounded Dijkstra search from the start position to find the cheapest place to rejoin the path,
+	// where rejoining at a node also costs the rest of the path from that node to the destination.
+	if (path.empty() || maxExpansions == 0) {
+		return std::vector<Vec2>{};
+	}
+
+	struct JoinPoint final {
+		std::uint32_t remainingCost;
+		std::size_t index;
+	};
+
+	auto joinPoints = std::unordered_map<Vec2, JoinPoint>{};
+	joinPoints.reserve(path.size());
+	auto remainingCost = std::uint32_t{0};
+	for (auto i = std::size_t{0}; i < path.size(); ++i) {
+		if (i > 0) {
+			const auto isDiagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+			remainingCost += (isDiagonal) ? COST_DIAGONAL : COST_STRAIGHT;
+		}
+		joinPoints.emplace(path[i], JoinPoint{remainingCost, i});
+	}
+
+	auto cost = std::unordered_map<Vec2, std::uint32_t>{{start, 0}};
+	auto previous = std::unordered_map<Vec2, Vec2>{{start, start}};
+	auto queue = std::priority_queue<PathNode>{};
+	queue.emplace(0, start);
+
+	auto bestCost = std::optional<std::uint32_t>{};
+	auto bestIndex = std::size_t{0};
+	auto expansions = std::size_t{0};
+	while (!queue.empty()) {
+		const auto node = queue.top();
+		queue.pop();
+		if (node.cost != cost[node.position]) {
+			continue;
+		}
+		if (bestCost && node.cost >= *bestCost) {
+			break;
+		}
+
+		if (const auto it = joinPoints.find(node.position); it != joinPoints.end()) {
+			if (const auto totalCost = node.cost + it->second.remainingCost; !bestCost || totalCost < *bestCost) {
+				bestCost = totalCost;
+				bestIndex = it->second.index;
+			}
+		}
+
+		if (expansions++ == maxExpansions) {
+			break;
+		}
+
+		forEachNonSolidNeighbor(*this, node.position, red, blue, [&](Vec2 neighbor, std::uint32_t weight) {
+			const auto newCost = node.cost + weight;
+			if (const auto result = cost.emplace(neighbor, newCost); result.second) {
+				previous.emplace(neighbor, node.position);
+				queue.emplace(newCost, neighbor);
+			} else if (newCost < result.first->second) {
+				result.first->second = newCost;
+				previous.at(neighbor) = node.position;
+				queue.emplace(newCost, neighbor);
+			}
+		});
+	}
+
+	if (!bestCost) {
+		return std::vector<Vec2>{};
+	}
+
+	// Keep the old path up to the join point and append the detour back to the start.
+	auto result = std::vector<Vec2>(path.data(), path.data() + bestIndex + 1);
+	const auto joinPoint = path[bestIndex];
+	if (joinPoint == start) {
+		if (bestIndex > 0) {
+			result.pop_back();
+		}
+		return result;
+	}
+	for (auto p = previous.at(joinPoint); p != start; p = previous.at(p)) {
+		result.push_back(p);
+	}
+	return result;
+}
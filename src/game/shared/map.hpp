@@ -8,6 +8,8 @@
 #include "../data/direction.hpp"           // Direction
 #include "../data/vector.hpp"              // Vec2
 
+#include <cstddef>     // std::size_t
+#include <cstdint>     // std::uint64_t
 #include <string>      // std::string
 #include <string_view> // std::string_view
 #include <utility>     // std::forward
@@ -62,6 +64,9 @@ public:
 	[[nodiscard]] auto isSolid(Vec2 p, bool red, bool blue) const noexcept -> bool;
 	[[nodiscard]] auto isSolid(Vec2 p, bool red, bool blue, Direction moveDirection) const noexcept -> bool;
 
+	// Check if a tile blocks line of sight. Tiles outside the map are always opaque.
+	[[nodiscard]] auto isOpaque(Vec2 p) const noexcept -> bool;
+
 	[[nodiscard]] auto lineOfSight(Vec2 p1, Vec2 p2) const noexcept -> bool;
 
 	// Find a walkable path from start to destination.
@@ -70,8 +75,20 @@ public:
 	// The start position is not included in the path, unless it is the same as the destination.
 	[[nodiscard]] auto findPath(Vec2 start, Vec2 destination, bool red, bool blue) const -> std::vector<Vec2>;
 
+	// Reconnect start to an existing path from findPath (or the part of it that has not been traversed yet) with a local search.
+	// Gives up and returns an empty vector if no node of the path is reached within maxExpansions expanded tiles.
+	// Otherwise, returns a new path with the same layout as findPath that rejoins the old one where it is cheapest to do so.
+	[[nodiscard]] auto repairPath(Vec2 start, util::Span<const Vec2> path, bool red, bool blue, std::size_t maxExpansions) const
+		-> std::vector<Vec2>;
+
 private:
+	using OpaqueWord = std::uint64_t;
+
+	auto updateOpaqueRows() -> void;
+
 	util::TileMatrix<char> m_matrix{};
+	std::vector<OpaqueWord> m_opaqueRows{}; // One bit per tile, packed row by row.
+	std::size_t m_opaqueRowWords = 0;
 	std::string m_name{};
 	util::CRC32 m_hash{};
 	Vec2 m_redCartSpawn{};
@@ -2,6 +2,25 @@
 
 #include <algorithm> // std::find_if
 
+auto Snapshot::clear() noexcept -> void {
+	tickCount = 0;
+	roundSecondsLeft = 0;
+	selfPlayer = ent::sh::SelfPlayer{};
+	flagInfo.clear();
+	cartInfo.clear();
+	playerInfo.clear();
+	players.clear();
+	corpses.clear();
+	sentryGuns.clear();
+	projectiles.clear();
+	explosions.clear();
+	medkits.clear();
+	ammopacks.clear();
+	genericEntities.clear();
+	flags.clear();
+	carts.clear();
+}
+
 auto Snapshot::findPlayerInfo(PlayerId id) -> ent::sh::PlayerInfo* {
 	const auto it = std::find_if(playerInfo.begin(), playerInfo.end(), [id](const auto& playerInfo) { return playerInfo.id == id; });
 	return (it == playerInfo.end()) ? nullptr : &*it;
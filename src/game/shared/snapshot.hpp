@@ -28,6 +28,9 @@ struct Snapshot final : net::TieDeltaCompressableDecompressableBase<Snapshot> {
 	std::vector<ent::sh::Flag> flags{};
 	std::vector<ent::sh::PayloadCart> carts{};
 
+	// Reset to an empty snapshot while keeping the capacity of every list, so that the snapshot can be refilled without allocating.
+	auto clear() noexcept -> void;
+
 	[[nodiscard]] auto findPlayerInfo(PlayerId id) -> ent::sh::PlayerInfo*;
 	[[nodiscard]] auto findPlayerInfo(PlayerId id) const -> const ent::sh::PlayerInfo*;
 
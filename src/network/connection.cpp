@@ -1,5 +1,6 @@
 #include "connection.hpp"
 
+#include <new>          // std::bad_alloc
 #include <stdexcept>    // std::length_error
 #include <system_error> // std::error_code
 
@@ -100,6 +101,39 @@ auto NetChannel::accept(IpEndpoint endpoint) -> bool {
 	return this->initializeConnection(true, endpoint);
 }
 
+auto NetChannel::bufferMessage(const SharedMessage& msg) noexcept -> bool {
+	if (!msg.data) {
+		return false;
+	}
+
+	if (msg.data->size() > MAX_MESSAGE_SIZE) {
+		DEBUG_MSG(Msg::CONNECTION_EVENT, "Failed to buffer shared message (greater than max message size ({}/{}))!", msg.data->size(), MAX_MESSAGE_SIZE);
+		++m_stats.invalidOutgoingMessageSizeCount;
+		return false;
+	}
+
+	if (msg.category == MessageCategory::SECRET && msg.data->size() > crypto::Stream::MAX_MESSAGE_SIZE) {
+		DEBUG_MSG(Msg::CONNECTION_EVENT,
+		          "Failed to buffer shared message (greater than max secret message size ({}/{}))!",
+		          msg.data->size(),
+		          crypto::Stream::MAX_MESSAGE_SIZE);
+		++m_stats.invalidOutgoingSecretMessageSizeCount;
+		return false;
+	}
+
+	try {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Buffering shared message ({} bytes).", msg.data->size());
+		auto& message = m_bufferedMessages.emplace_back();
+		message.sharedData = msg.data;
+		message.category = msg.category;
+	} catch ([[maybe_unused]] const std::bad_alloc& e) {
+		DEBUG_MSG(Msg::CONNECTION_EVENT, "Failed to buffer shared message ({} bytes) ({})!", msg.data->size(), e.what());
+		++m_stats.allocationErrorCount;
+		return false;
+	}
+	return true;
+}
+
 auto NetChannel::reset() noexcept -> void {
 	this->resetStats();
 	m_receiveBuffer.clear();
@@ -111,6 +145,7 @@ auto NetChannel::reset() noexcept -> void {
 	m_latestSeqSent = 0;
 	m_latestSeqHandled = 0;
 	m_latestAckReceived = Acknowledgement{};
+	m_handshakeCookie.reset();
 	m_state = State::DISCONNECTED;
 }
 
@@ -572,6 +607,17 @@ auto NetChannel::processReceivedPackets() -> void {
 	auto shouldCheckSavedPackets = false;
 	auto newestAck = m_latestAckReceived;
 	for (auto& packet : m_receivedPackets) {
+		// Check if the server wants us to prove that we own our endpoint before it accepts the connection.
+		if (!m_serverSide && m_state == State::HANDSHAKE_PART1) {
+			if (auto cookie = HandshakeCookie{}; cookie.read(packet, HandshakeCookie::CHALLENGE_PROTOCOL_ID)) {
+				INFO_MSG(Msg::CONNECTION_EVENT | Msg::CONNECTION_CRYPTO,
+				         "NetChannel to \"{}\" received handshake cookie.",
+				         std::string{this->getRemoteEndpoint()});
+				m_handshakeCookie = cookie;
+				continue;
+			}
+		}
+
 		auto packetStream = ByteInputStream{packet};
 		if (auto header = PacketHeader{}; packetStream >> header) {
 			DEBUG_MSG_INDENT(Msg::CONNECTION_DETAILED, "Received packet {}.", header) {
@@ -582,6 +628,9 @@ auto NetChannel::processReceivedPackets() -> void {
 					continue;
 				}
 
+				// The server has accepted us, so we don't need to echo the cookie anymore.
+				m_handshakeCookie.reset();
+
 				// Check if this packet contains a new acknowledgement.
 				if (const auto headerAck = Acknowledgement{header.ack, header.mask}; headerAck > newestAck) {
 					newestAck = headerAck; // Update the newest acknowledgement.
@@ -854,10 +903,10 @@ auto NetChannel::writeMessages(PacketHeader::Flags& flags, PacketMask mask, std:
 		// Don't send non-NetChannel messages if we are not connected.
 		if (!this->connected()) {
 			auto type = MessageType{};
-			auto messageStream = ByteInputStream{util::Span{message.data}.first(sizeof(MessageType))};
+			auto messageStream = ByteInputStream{message.bytes().first(sizeof(MessageType))};
 			messageStream >> type;
 			if (!net::isNetChannelMessage(type)) {
-				DEBUG_MSG(Msg::CONNECTION_DETAILED, "Ignoring non-NetChannel message because we are not connected ({}) bytes.", message.data.size());
+				DEBUG_MSG(Msg::CONNECTION_DETAILED, "Ignoring non-NetChannel message because we are not connected ({}) bytes.", message.bytes().size());
 				++it;
 				continue;
 			}
@@ -867,10 +916,11 @@ auto NetChannel::writeMessages(PacketHeader::Flags& flags, PacketMask mask, std:
 			constexpr auto type = message_type_of_v<msg::out::EncryptedMessage, NetChannelOutputMessages>;
 
 			auto cipherText = std::vector<std::byte>{};
-			if (!this->encryptMessage(cipherText, message.data)) {
+			if (!this->encryptMessage(cipherText, message.bytes())) {
 				return SendStatus::ENCRYPTION_FAILED;
 			}
 			const auto encryptedMessage = msg::out::EncryptedMessage{{}, cipherText};
+			message.sharedData.reset(); // The cipher text is unique to this connection.
 			message.data.clear();
 			auto countStream = ByteCountStream{};
 			countStream << type << encryptedMessage;
@@ -880,12 +930,13 @@ auto NetChannel::writeMessages(PacketHeader::Flags& flags, PacketMask mask, std:
 			message.category = MessageCategory::RELIABLE; // Treat it as a reliable message from now on.
 		}
 
-		if (message.data.size() > MAX_PACKET_PAYLOAD_SIZE) {
+		const auto bytes = message.bytes();
+		if (bytes.size() > MAX_PACKET_PAYLOAD_SIZE) {
 			DEBUG_MSG(Msg::CONNECTION_DETAILED,
 			          "Message ({} bytes) is larger than the maximum message space of {} bytes. Splitting into multiple packets.",
-			          message.data.size(),
+			          bytes.size(),
 			          MAX_PACKET_PAYLOAD_SIZE);
-			if (const auto status = this->splitAndSendMessage(std::move(payload), flags, mask, message.data); status != SendStatus::SUCCESS) {
+			if (const auto status = this->splitAndSendMessage(std::move(payload), flags, mask, bytes); status != SendStatus::SUCCESS) {
 				return status;
 			}
 			payload.clear();
@@ -895,10 +946,10 @@ auto NetChannel::writeMessages(PacketHeader::Flags& flags, PacketMask mask, std:
 				flags |= PacketHeader::RELIABLE;
 			}
 
-			if (payload.size() + message.data.size() > MAX_PACKET_PAYLOAD_SIZE) {
+			if (payload.size() + bytes.size() > MAX_PACKET_PAYLOAD_SIZE) {
 				DEBUG_MSG(Msg::CONNECTION_DETAILED,
 				          "Message ({} bytes) is too large to fit in remaining {} bytes of current packet payload. Sending another packet.",
-				          message.data.size(),
+				          bytes.size(),
 				          MAX_PACKET_PAYLOAD_SIZE - payload.size());
 				if (const auto status = this->sendPacket(flags, mask, std::move(payload)); status != SendStatus::SUCCESS) {
 					return status;
@@ -907,8 +958,8 @@ auto NetChannel::writeMessages(PacketHeader::Flags& flags, PacketMask mask, std:
 				flags &= ~PacketHeader::RELIABLE;
 			}
 
-			payload.insert(payload.end(), message.data.begin(), message.data.end());
-			DEBUG_MSG(Msg::CONNECTION_DETAILED, "Wrote {} byte message.", message.data.size());
+			payload.insert(payload.end(), bytes.begin(), bytes.end());
+			DEBUG_MSG(Msg::CONNECTION_DETAILED, "Wrote {} byte message.", bytes.size());
 		}
 		it = messages.erase(it);
 	}
@@ -1022,10 +1073,23 @@ auto NetChannel::sendAndBufferPacket(const PacketHeader& header, std::vector<std
 auto NetChannel::sendPacket(const PacketHeader& header, util::Span<const std::byte> payload) -> NetChannel::SendStatus {
 	auto packet = std::vector<std::byte>{};
 	auto countStream = ByteCountStream{};
+	if (m_handshakeCookie) {
+		countStream += HandshakeCookie::SIZE;
+	}
 	countStream << header;
 	countStream.write(payload);
+
+	// Until the server has answered, it may only know us by our endpoint, so don't send it anything smaller than the cookie it
+	// would answer with. Such a packet can only be an empty one, since the first handshake message is still unacknowledged.
+	if (!m_serverSide && m_state == State::HANDSHAKE_PART1 && !m_handshakeCookie && countStream.capacity() < HandshakeCookie::SIZE) {
+		DEBUG_MSG(Msg::CONNECTION_DETAILED, "Not sending {}-byte packet before the handshake has been answered.", countStream.capacity());
+		return SendStatus::SUCCESS;
+	}
 	packet.reserve(countStream.capacity());
 	auto packetStream = ByteOutputStream{packet};
+	if (m_handshakeCookie) {
+		m_handshakeCookie->write(packetStream, HandshakeCookie::ECHO_PROTOCOL_ID);
+	}
 	packetStream << header;
 	packetStream.write(payload);
 	++m_stats.packetsSent;
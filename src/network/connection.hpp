@@ -27,7 +27,9 @@
 #include <fmt/core.h>    // fmt::format
 #include <fmt/ostream.h> // operator<<
 #include <limits>        // std::numeric_limits
+#include <memory>        // std::shared_ptr, std::make_shared
 #include <new>           // std::bad_alloc
+#include <optional>      // std::optional
 #include <ostream>       // std::ostream
 #include <string>        // std::string
 #include <string_view>   // std::string_view
@@ -150,6 +152,60 @@ struct PacketHeader final {
 	}
 };
 
+/**
+ * Stateless cookie that a server can require from unknown endpoints before it allocates any connection state for them.
+ *
+ * The server answers packets from an unknown endpoint with a challenge containing a timestamp and a tag derived from a private
+ * key, the remote endpoint and the timestamp, without storing anything. While a client is waiting for the first part of the
+ * handshake, it prefixes every packet it sends with an echo of the latest challenge it received, and the server only accepts the
+ * connection once an echo with a valid tag arrives.
+ */
+struct HandshakeCookie final {
+	static constexpr auto CHALLENGE_PROTOCOL_ID = util::CRC32{std::array{
+		std::byte{'A'},
+		std::byte{'F'},
+		std::byte{'2'},
+		std::byte{'C'},
+		std::byte{'C'},
+	}};
+
+	static constexpr auto ECHO_PROTOCOL_ID = util::CRC32{std::array{
+		std::byte{'A'},
+		std::byte{'F'},
+		std::byte{'2'},
+		std::byte{'C'},
+		std::byte{'E'},
+	}};
+
+	std::uint32_t timestamp = 0; // Server time in milliseconds when the cookie was created. Expected to overflow.
+	crypto::FastHash tag{};      // Keyed hash of the remote endpoint and the timestamp.
+
+	static constexpr auto SIZE = sizeof(util::CRC32) + sizeof(timestamp) + crypto::FastHash::SIZE;
+
+	// Write the cookie, preceded by a 32-bit checksum of the protocol id and the cookie.
+	auto write(ByteOutputStream& stream, util::CRC32 protocolId) const -> void {
+		auto data = std::vector<std::byte>{};
+		data.reserve(SIZE - sizeof(util::CRC32));
+		auto dataStream = ByteOutputStream{data};
+		dataStream << timestamp << tag;
+		stream << protocolId + data;
+		stream.write(data);
+	}
+
+	// Read a cookie with the given protocol id from the start of a packet. Returns false if the packet doesn't start with one.
+	[[nodiscard]] auto read(util::Span<const std::byte> packet, util::CRC32 protocolId) noexcept -> bool {
+		if (packet.size() < SIZE) {
+			return false;
+		}
+		auto stream = ByteInputStream{packet.first(SIZE)};
+		auto checksum = util::CRC32{};
+		if (!(stream >> checksum) || checksum != protocolId + stream) {
+			return false;
+		}
+		return static_cast<bool>(stream >> timestamp >> tag);
+	}
+};
+
 static_assert(MAX_PACKET_SIZE > PacketHeader::MAX_SIZE, "Packets must always be able to fit a payload.");
 
 inline constexpr auto MAX_PACKET_PAYLOAD_SIZE = MAX_PACKET_SIZE - PacketHeader::MAX_SIZE;
@@ -345,6 +401,12 @@ using EncryptedMessage = net::msg::EncryptedMessage<net::MessageDirection::OUTPU
 
 } // namespace msg
 
+// Smallest possible packet containing the first handshake message: A header without early acks, the message type and the message.
+inline constexpr auto MIN_HANDSHAKE_PACKET_SIZE = sizeof(util::CRC32) + sizeof(PacketHeader::Flags) + sizeof(SequenceNumber) * 2 + sizeof(MessageType) +
+                                                  crypto::kx::PublicKey::SIZE + crypto::AccessToken::SIZE;
+
+static_assert(MIN_HANDSHAKE_PACKET_SIZE >= HandshakeCookie::SIZE, "A server answering unknown endpoints with a cookie must never send more than it received.");
+
 template <net::MessageDirection DIR>
 using NetChannelMessages = util::TypeList< //
 	msg::HandshakePart1<DIR>,              //
@@ -370,6 +432,13 @@ struct message_type_of : std::integral_constant<MessageType, util::typelist_inde
 template <typename Message, typename MessageList>
 inline constexpr auto message_type_of_v = message_type_of<Message, MessageList>::value;
 
+// Message that has been serialized once, so that it can be written to any number of connections without serializing it again.
+// All of the connections refer to the same immutable bytes.
+struct SharedMessage final {
+	std::shared_ptr<const std::vector<std::byte>> data{};
+	MessageCategory category{};
+};
+
 struct ConnectionStats final {
 	std::uint32_t packetsSent = 0;
 	std::uint32_t packetsReceived = 0;
@@ -487,6 +556,8 @@ protected:
 		return true;
 	}
 
+	[[nodiscard]] auto bufferMessage(const SharedMessage& msg) noexcept -> bool;
+
 	auto handleMessage(msg::in::HandshakePart1&& msg) -> void;
 	auto handleMessage(msg::in::HandshakePart2&& msg) -> void;
 	auto handleMessage(msg::in::HandshakePart3&& msg) -> void;
@@ -517,7 +588,12 @@ private:
 			: data(std::forward<Data>(data))
 			, category(std::forward<Category>(category)) {}
 
+		[[nodiscard]] auto bytes() const noexcept -> util::Span<const std::byte> {
+			return (sharedData) ? util::Span<const std::byte>{*sharedData} : util::Span<const std::byte>{data};
+		}
+
 		std::vector<std::byte> data;
+		std::shared_ptr<const std::vector<std::byte>> sharedData{}; // Used instead of data when the message is shared with other connections.
 		MessageCategory category{};
 	};
 
@@ -594,6 +670,7 @@ private:
 	crypto::Stream::Receive m_receiveStream{};
 	crypto::AccessToken m_localHandshakeToken{};
 	crypto::AccessToken m_remoteHandshakeToken{};
+	std::optional<HandshakeCookie> m_handshakeCookie{};
 	std::deque<OutgoingPacket> m_sendBuffer{};
 	util::RingMap<SequenceNumber, IncomingPacket> m_receiveBuffer{};
 	std::vector<std::vector<std::byte>> m_receivedPackets{};
@@ -693,6 +770,26 @@ public:
 		return this->bufferMessage<AllOutgoingMessages>(msg);
 	}
 
+	[[nodiscard]] auto write(const SharedMessage& msg) noexcept -> bool {
+		return this->bufferMessage(msg);
+	}
+
+	// Serialize a message once for writing to many connections that use the same message list.
+	template <typename MessageList, typename Message, typename = std::enable_if_t<is_output_message_v<Message>>>
+	[[nodiscard]] static auto share(const Message& msg) -> SharedMessage {
+		using AllOutgoingMessages = util::typelist_concat_t<NetChannelOutputMessages, MessageList>;
+		constexpr auto type = message_type_of_v<Message, AllOutgoingMessages>;
+
+		auto countStream = ByteCountStream{};
+		countStream << type << msg;
+
+		auto data = std::vector<std::byte>{};
+		data.reserve(countStream.capacity());
+		auto dataStream = ByteOutputStream{data};
+		dataStream << type << msg;
+		return SharedMessage{std::make_shared<const std::vector<std::byte>>(std::move(data)), message_category_of_v<Message>};
+	}
+
 private:
 	Handler m_handler;
 };
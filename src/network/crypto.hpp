@@ -205,6 +205,10 @@ class FastHash final : public crypto::detail::ByteArray<FastHash, unsigned char,
 using FastHashRef = util::Span<FastHash::value_type, FastHash::SIZE>;
 using FastHashView = util::Span<const FastHash::value_type, FastHash::SIZE>;
 
+class FastHashKey final : public crypto::detail::ByteArray<FastHashKey, unsigned char, crypto_generichash_blake2b_KEYBYTES> {};
+using FastHashKeyRef = util::Span<FastHashKey::value_type, FastHashKey::SIZE>;
+using FastHashKeyView = util::Span<const FastHashKey::value_type, FastHashKey::SIZE>;
+
 inline auto generateSeed(SeedRef result) noexcept -> void {
 	randombytes_buf(result.data(), result.size());
 }
@@ -241,6 +245,27 @@ inline auto generateAccessToken(AccessTokenRef result, SeedView seed) noexcept -
 	return std::equal(dataHash.begin(), dataHash.end(), hash.begin());
 }
 
+inline auto generateFastHashKey(FastHashKeyRef result) noexcept -> void {
+	randombytes_buf(result.data(), result.size());
+}
+
+[[nodiscard]] inline auto fastHash(FastHashRef result, util::Span<const std::byte> data, FastHashKeyView key) noexcept -> bool {
+	return crypto_generichash_blake2b(result.data(),
+	                                  result.size(),
+	                                  reinterpret_cast<const unsigned char*>(data.data()),
+	                                  data.size(),
+	                                  key.data(),
+	                                  key.size()) == 0;
+}
+
+[[nodiscard]] inline auto verifyFastHash(FastHashView hash, util::Span<const std::byte> data, FastHashKeyView key) noexcept -> bool {
+	auto dataHash = FastHash{};
+	if (!crypto::fastHash(dataHash, data, key)) {
+		return false;
+	}
+	return std::equal(dataHash.begin(), dataHash.end(), hash.begin());
+}
+
 // Password library.
 namespace pw {
 
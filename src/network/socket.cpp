@@ -355,6 +355,24 @@ auto UDPSocket::sendTo(IpEndpoint endpoint, util::Span<const std::byte> bytes, s
 	return Socket::sendTo(endpoint, bytes, UDP_SEND_FLAGS, ec);
 }
 
+auto UDPSocket::waitUntilReadable(Duration timeout, std::error_code& ec) -> bool {
+	auto fdset = fd_set{};
+	FD_ZERO(&fdset);
+	FD_SET(Socket::get(), &fdset);
+	const auto timeoutSeconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	const auto timeoutMicroseconds = std::chrono::ceil<std::chrono::microseconds>(timeout - timeoutSeconds);
+	auto tv = timeval{};
+	tv.tv_sec = static_cast<decltype(tv.tv_sec)>(timeoutSeconds.count());
+	tv.tv_usec = static_cast<decltype(tv.tv_usec)>(timeoutMicroseconds.count());
+	const auto result = select(static_cast<int>(Socket::get() + 1), &fdset, nullptr, nullptr, &tv);
+	if (result < 0) {
+		ec = getErrorStatus();
+		return false;
+	}
+	ec.clear();
+	return result > 0;
+}
+
 auto UDPSocket::get() const noexcept -> SOCKET {
 	return Socket::get();
 }
@@ -118,6 +118,9 @@ public:
 
 	auto sendTo(IpEndpoint endpoint, util::Span<const std::byte> bytes, std::error_code& ec) -> std::size_t;
 
+	// Block until there is a packet to receive or the timeout expires. Returns true if there is a packet.
+	[[nodiscard]] auto waitUntilReadable(Duration timeout, std::error_code& ec) -> bool;
+
 	[[nodiscard]] auto get() const noexcept -> SOCKET;
 };
 
@@ -41,6 +41,25 @@ auto dumpFile(std::string_view filepath, std::string_view text, std::ios::openmo
 	return false;
 }
 
+auto replaceFile(std::string_view filepath, std::string_view text, std::ios::openmode mode) noexcept -> bool {
+	try {
+		const auto tempFilepath = fmt::format("{}.tmp", filepath);
+		if (!util::dumpFile(tempFilepath, text, mode | std::ios::trunc)) {
+			return false;
+		}
+
+		auto ec = std::error_code{};
+		std::filesystem::rename(tempFilepath, std::filesystem::path{filepath}, ec);
+		if (ec) {
+			std::filesystem::remove(tempFilepath, ec);
+			return false;
+		}
+		return true;
+	} catch (...) {
+	}
+	return false;
+}
+
 auto uniqueFilePath(std::string_view path, std::string_view extension) -> std::string {
 	auto ec = std::error_code{};
 
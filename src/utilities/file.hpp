@@ -12,6 +12,9 @@ namespace util {
 
 [[nodiscard]] auto dumpFile(std::string_view filepath, std::string_view text, std::ios::openmode mode = std::ios::trunc) noexcept -> bool;
 
+// Write to a temporary file next to the destination and rename it over the destination, so that the file is never left half-written.
+[[nodiscard]] auto replaceFile(std::string_view filepath, std::string_view text, std::ios::openmode mode = {}) noexcept -> bool;
+
 [[nodiscard]] auto uniqueFilePath(std::string_view path, std::string_view extension) -> std::string;
 
 [[nodiscard]] auto pathIsBelowDirectory(std::string_view path, std::string_view directory) -> bool;
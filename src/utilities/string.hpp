@@ -1,21 +1,16 @@
 #ifndef AF2_UTILITIES_STRING_HPP
 #define AF2_UTILITIES_STRING_HPP
 
-#include <algorithm>   // std::transform
-#include <cstddef>     // std::size_t
-#include <iterator>    // std::begin, std::end, std::iterator_traits, std::forward_iterator_tag
-#include <optional>    // std::optional
-#include <string>      // std::string
-#include <string_view> // std::string_view
-#include <type_traits> // std::remove_..._t, std::is_..._v, std::conditional_t, std::common_type_t
-#include <utility>     // std::move, std::forward, std::declval
-// TODO: Always use <charconv> when GCC finally supports to_chars/from_chars for float types.
-#ifdef _MSC_VER
-#include <charconv>     // std::to_chars, std::from_chars, std::chars_format
+#include <algorithm>    // std::transform
+#include <charconv>     // std::to_chars, std::from_chars
+#include <cstddef>      // std::size_t
+#include <iterator>     // std::begin, std::end, std::iterator_traits, std::forward_iterator_tag
+#include <optional>     // std::optional
+#include <string>       // std::string
+#include <string_view>  // std::string_view
 #include <system_error> // std::errc
-#else
-#include <cstdio> // std::snprintf, std::sscanf
-#endif
+#include <type_traits>  // std::remove_..._t, std::is_..._v, std::conditional_t, std::common_type_t
+#include <utility>      // std::move, std::forward, std::declval
 
 namespace util {
 namespace detail {
@@ -210,53 +205,21 @@ namespace util {
 	return util::toUpper(std::string{str});
 }
 
+// Format a number in the shortest form that reads back as the same value with util::stringTo.
 template <typename T>
 [[nodiscard]] inline auto toString(T value) -> std::string {
 	auto buffer = std::string(32, '\0');
-	// TODO: Always use <charconv> when GCC finally supports to_chars/from_chars for float types.
-#ifdef _MSC_VER
 	if (const auto& result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value); result.ec == std::errc{}) {
 		buffer.erase(static_cast<std::size_t>(result.ptr - buffer.data()), std::string::npos);
 	} else {
 		buffer.clear();
 	}
-#else
-	auto charsWritten = 0;
-
-	if constexpr (std::is_floating_point_v<T>) {
-		charsWritten = std::snprintf(buffer.data(), buffer.size(), "%f", static_cast<float>(value));
-	} else if constexpr (std::is_signed_v<T>) {
-		charsWritten = std::snprintf(buffer.data(), buffer.size(), "%d", static_cast<int>(value));
-	} else if constexpr (std::is_unsigned_v<T>) {
-		charsWritten = std::snprintf(buffer.data(), buffer.size(), "%u", static_cast<unsigned>(value));
-	}
-
-	if (charsWritten > 0 && static_cast<std::size_t>(charsWritten) < buffer.size()) {
-		buffer.erase(static_cast<std::size_t>(charsWritten), std::string::npos);
-		if constexpr (std::is_floating_point_v<T>) {
-			if (const auto dotPos = buffer.rfind('.'); dotPos != std::string::npos) {
-				while (buffer.size() > dotPos + 2 && buffer.back() == '0') {
-					buffer.pop_back();
-				}
-
-				if (buffer.size() == dotPos + 2 && buffer.back() == '0') {
-					buffer.pop_back();
-					buffer.pop_back();
-				}
-			}
-		}
-	} else {
-		buffer.clear();
-	}
-#endif
 	return buffer;
 }
 
 // Convert a string to the given numeric type. Returns std::nullopt if there was a conversion error.
 template <typename T>
 [[nodiscard]] inline auto stringTo(std::string_view str) noexcept -> std::optional<T> {
-	// TODO: Always use <charconv> when GCC finally supports to_chars/from_chars for float types.
-#ifdef _MSC_VER
 	T value;
 
 	const auto end = str.data() + str.size();
@@ -264,47 +227,15 @@ template <typename T>
 		return std::nullopt;
 	}
 	return value;
-#else
-	const auto buffer = std::string{str}; // Copy to make sure the string is 0-terminated. Not necessary in the <charconv> version.
-	if constexpr (std::is_floating_point_v<T>) {
-		auto value = 0.0f;
-		auto readChars = 0;
-		if (std::sscanf(buffer.c_str(), "%f%n", &value, &readChars) == 1 && static_cast<std::size_t>(readChars) == buffer.size()) {
-			return static_cast<T>(value);
-		}
-	} else if constexpr (std::is_signed_v<T>) {
-		auto value = 0;
-		auto readChars = 0;
-		if (std::sscanf(buffer.c_str(), "%d%n", &value, &readChars) == 1 && static_cast<std::size_t>(readChars) == buffer.size()) {
-			return static_cast<T>(value);
-		}
-	} else if constexpr (std::is_unsigned_v<T>) {
-		auto value = 0u;
-		auto readChars = 0;
-		if (std::sscanf(buffer.c_str(), "%u%n", &value, &readChars) == 1 && static_cast<std::size_t>(readChars) == buffer.size()) {
-			return static_cast<T>(value);
-		}
-	}
-	return std::nullopt;
-#endif
 }
 
 // Convert a string to the given numeric type. Returns false if there was a conversion error, otherwise true.
 template <typename T>
 inline auto stringTo(T& value, std::string_view str) noexcept -> bool {
-	// TODO: Always use <charconv> when GCC finally supports to_chars/from_chars for float types.
-#ifdef _MSC_VER
 	const auto end = str.data() + str.size();
 
 	const auto& [ptr, ec] = std::from_chars(str.data(), end, value);
 	return ec == std::errc{} && ptr == end;
-#else
-	if (auto result = util::stringTo<T>(str)) {
-		value = *result;
-		return true;
-	}
-	return false;
-#endif
 }
 
 // Check if a string contains a substring.
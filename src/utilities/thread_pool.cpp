@@ -0,0 +1,103 @@
+#include "thread_pool.hpp"
+
+#include <utility> // std::exchange
+
+namespace util {
+
+ThreadPool::~ThreadPool() {
+	this->stop();
+}
+
+auto ThreadPool::resize(std::size_t threadCount) -> void {
+	if (threadCount == m_threads.size()) {
+		return;
+	}
+
+	this->stop();
+	m_stopping = false;
+	m_threads.reserve(threadCount);
+	for (auto i = std::size_t{0}; i < threadCount; ++i) {
+		m_threads.emplace_back([this, batch = m_batch] { this->workerMain(batch); });
+	}
+}
+
+auto ThreadPool::size() const noexcept -> std::size_t {
+	return m_threads.size();
+}
+
+auto ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& job) -> void {
+	if (m_threads.empty() || count <= 1) {
+		for (auto i = std::size_t{0}; i < count; ++i) {
+			job(i);
+		}
+		return;
+	}
+
+	{
+		auto lock = std::lock_guard{m_mutex};
+		m_job = &job;
+		m_count = count;
+		m_next = 0;
+		m_finishedWorkers = 0;
+		m_exception = nullptr;
+		++m_batch;
+	}
+	m_batchStarted.notify_all();
+
+	this->runJobs();
+
+	auto lock = std::unique_lock{m_mutex};
+	m_batchFinished.wait(lock, [&] { return m_finishedWorkers == m_threads.size(); });
+	m_job = nullptr;
+	if (auto exception = std::exchange(m_exception, nullptr)) {
+		std::rethrow_exception(exception);
+	}
+}
+
+auto ThreadPool::stop() -> void {
+	{
+		auto lock = std::lock_guard{m_mutex};
+		m_stopping = true;
+	}
+	m_batchStarted.notify_all();
+	for (auto& thread : m_threads) {
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+auto ThreadPool::workerMain(std::size_t batch) -> void {
+	while (true) {
+		{
+			auto lock = std::unique_lock{m_mutex};
+			m_batchStarted.wait(lock, [&] { return m_stopping || m_batch != batch; });
+			if (m_stopping) {
+				return;
+			}
+			batch = m_batch;
+		}
+
+		this->runJobs();
+
+		{
+			auto lock = std::lock_guard{m_mutex};
+			++m_finishedWorkers;
+		}
+		m_batchFinished.notify_one();
+	}
+}
+
+auto ThreadPool::runJobs() -> void {
+	for (auto i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_count; i = m_next.fetch_add(1, std::memory_order_relaxed)) {
+		try {
+			(*m_job)(i);
+		} catch (...) {
+			auto lock = std::lock_guard{m_mutex};
+			if (!m_exception) {
+				m_exception = std::current_exception();
+			}
+		}
+	}
+}
+
+} // namespace util
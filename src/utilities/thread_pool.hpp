@@ -0,0 +1,56 @@
+#ifndef AF2_UTILITIES_THREAD_POOL_HPP
+#define AF2_UTILITIES_THREAD_POOL_HPP
+
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // std::size_t
+#include <exception>          // std::exception_ptr
+#include <functional>         // std::function
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+namespace util {
+
+// Fixed set of worker threads that cooperate with the calling thread to run a batch of independent jobs.
+class ThreadPool final {
+public:
+	ThreadPool() = default;
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+
+	auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+	auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+	// Set the number of worker threads. 0 means that all jobs run on the calling thread.
+	auto resize(std::size_t threadCount) -> void;
+
+	[[nodiscard]] auto size() const noexcept -> std::size_t;
+
+	// Call job(i) for every i in [0, count) and wait for all of the calls to return.
+	// The first exception thrown by a job is rethrown on the calling thread once the batch is done.
+	auto parallelFor(std::size_t count, const std::function<void(std::size_t)>& job) -> void;
+
+private:
+	auto stop() -> void;
+	auto workerMain(std::size_t batch) -> void;
+	auto runJobs() -> void;
+
+	std::vector<std::thread> m_threads{};
+	std::mutex m_mutex{};
+	std::condition_variable m_batchStarted{};
+	std::condition_variable m_batchFinished{};
+	const std::function<void(std::size_t)>* m_job = nullptr;
+	std::size_t m_count = 0;
+	std::atomic<std::size_t> m_next = 0;
+	std::size_t m_finishedWorkers = 0;
+	std::size_t m_batch = 0;
+	std::exception_ptr m_exception{};
+	bool m_stopping = false;
+};
+
+} // namespace util
+
+#endif